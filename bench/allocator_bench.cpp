@@ -0,0 +1,127 @@
+// Host benchmark comparing the arena and pool allocators against malloc.
+//   g++ -std=c++20 -O2 -Isrc bench/allocator_bench.cpp -o allocator_bench
+#include "std/allocator.hpp"
+#include <chrono>
+#include <stdio.h>
+#include <stdint.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+constexpr size_t LIVE_OBJECTS = 64;
+constexpr size_t ITERATIONS = 1'000'000;
+constexpr size_t MIN_SIZE = 8;
+constexpr size_t MAX_SIZE = 32;
+
+pool<MAX_SIZE, LIVE_OBJECTS> g_pool;
+arena<LIVE_OBJECTS * MAX_SIZE * 2> g_arena;
+
+// xorshift so the host's rand() does not show up in the numbers
+struct Random {
+    uint32_t state{2463534242u};
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    size_t size() { return MIN_SIZE + next() % (MAX_SIZE - MIN_SIZE + 1); }
+};
+
+template <typename Fn>
+double ns_per_op(Fn&& fn, size_t ops) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+// Random replacement of live objects, the pattern a set of Strings being
+// rebuilt in loop() produces.
+template <typename Alloc, typename Free>
+void churn(Alloc&& alloc, Free&& release) {
+    void* live[LIVE_OBJECTS]{};
+    Random random;
+
+    for (auto& ptr : live) ptr = alloc(random.size());
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        auto& victim = live[random.next() % LIVE_OBJECTS];
+        release(victim);
+        victim = alloc(random.size());
+        static_cast<volatile unsigned char*>(victim)[0] = 1;
+    }
+
+    for (auto* ptr : live) release(ptr);
+}
+
+void bench_malloc() {
+    const auto ns = ns_per_op([] {
+        churn([](size_t n) { return malloc(n); }, [](void* p) { free(p); });
+    }, ITERATIONS);
+    printf("throughput malloc      %8.2f ns/op\n", ns);
+}
+
+void bench_pool() {
+    const auto ns = ns_per_op([] {
+        churn([](size_t n) { return g_pool.allocate(n); }, [](void* p) { g_pool.deallocate(p); });
+    }, ITERATIONS);
+    printf("throughput pool        %8.2f ns/op\n", ns);
+}
+
+void bench_arena() {
+    // An arena cannot free individual objects, so measure the scoped pattern
+    // it is meant for: build up a batch, then drop it with one reset.
+    const auto ns = ns_per_op([] {
+        Random random;
+        for (size_t i = 0; i < ITERATIONS / LIVE_OBJECTS; i++) {
+            decltype(g_arena)::scope scope(g_arena);
+            for (size_t j = 0; j < LIVE_OBJECTS; j++) {
+                static_cast<volatile unsigned char*>(g_arena.allocate(random.size()))[0] = 1;
+            }
+        }
+    }, ITERATIONS);
+    printf("throughput arena       %8.2f ns/op\n", ns);
+}
+
+void fragmentation_malloc() {
+#if defined(__GLIBC__)
+    void* live[LIVE_OBJECTS * 4]{};
+    Random random;
+    for (auto& ptr : live) ptr = malloc(random.size());
+    // free every other object and try to place larger ones in the holes
+    for (size_t i = 0; i < LIVE_OBJECTS * 4; i += 2) {
+        free(live[i]);
+        live[i] = malloc(MAX_SIZE + random.size());
+    }
+    const auto info = mallinfo2();
+    const auto free_bytes = static_cast<double>(info.fordblks);
+    const auto total = static_cast<double>(info.uordblks + info.fordblks);
+    printf("fragmentation malloc   %8.2f %% of heap free but scattered\n", 100.0 * free_bytes / total);
+    for (auto* ptr : live) free(ptr);
+#else
+    printf("fragmentation malloc   n/a (needs glibc mallinfo2)\n");
+#endif
+}
+
+void fragmentation_pool() {
+    // External fragmentation is impossible in a pool; what is lost is the
+    // unused tail of each block.
+    Random random;
+    size_t requested = 0;
+    for (size_t i = 0; i < LIVE_OBJECTS; i++) requested += random.size();
+    const auto reserved = static_cast<double>(LIVE_OBJECTS * MAX_SIZE);
+    printf("fragmentation pool     %8.2f %% internal waste, 0 %% external\n", 100.0 * (reserved - static_cast<double>(requested)) / reserved);
+}
+
+} // namespace
+
+int main() {
+    bench_malloc();
+    bench_pool();
+    bench_arena();
+    fragmentation_malloc();
+    fragmentation_pool();
+}
@@ -0,0 +1,73 @@
+// Host benchmark for array's bulk operations against the equivalent
+// standard algorithms.
+//   g++ -std=c++20 -O3 -march=native -Isrc bench/array_bench.cpp -o array_bench
+#include "std/array.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace {
+
+constexpr size_t ELEMENTS = 256;
+constexpr size_t REPEATS = 200'000;
+
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename Fn>
+void run(const char* name, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < REPEATS; i++) {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("%-28s %8.3f ns/element\n", name, ns / static_cast<double>(REPEATS * ELEMENTS));
+}
+
+template <typename T>
+void bench(const char* type) {
+    array<T, ELEMENTS> values{};
+    array<T, ELEMENTS> target{};
+    for (size_t i = 0; i < ELEMENTS; i++) {
+        values[i] = static_cast<T>((i * 7919) % 1000);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s sum", type);
+    run(name, [&] { do_not_optimize(values.sum()); do_not_optimize(values); });
+    snprintf(name, sizeof(name), "%s std::accumulate", type);
+    run(name, [&] { do_not_optimize(std::accumulate(values.begin(), values.end(), T{})); do_not_optimize(values); });
+
+    snprintf(name, sizeof(name), "%s min", type);
+    run(name, [&] { do_not_optimize(values.min()); do_not_optimize(values); });
+    snprintf(name, sizeof(name), "%s std::min_element", type);
+    run(name, [&] { do_not_optimize(*std::min_element(values.begin(), values.end())); do_not_optimize(values); });
+
+    snprintf(name, sizeof(name), "%s max", type);
+    run(name, [&] { do_not_optimize(values.max()); do_not_optimize(values); });
+    snprintf(name, sizeof(name), "%s std::max_element", type);
+    run(name, [&] { do_not_optimize(*std::max_element(values.begin(), values.end())); do_not_optimize(values); });
+
+    snprintf(name, sizeof(name), "%s fill", type);
+    run(name, [&] { target.fill(T{1}); do_not_optimize(target); });
+    snprintf(name, sizeof(name), "%s std::fill", type);
+    run(name, [&] { std::fill(target.begin(), target.end(), T{1}); do_not_optimize(target); });
+
+    snprintf(name, sizeof(name), "%s copy_from", type);
+    run(name, [&] { target.copy_from(values.data()); do_not_optimize(target); });
+    snprintf(name, sizeof(name), "%s std::copy", type);
+    run(name, [&] { std::copy(values.begin(), values.end(), target.begin()); do_not_optimize(target); });
+}
+
+} // namespace
+
+int main() {
+    bench<int16_t>("int16");
+    bench<int32_t>("int32");
+    bench<float>("float");
+}
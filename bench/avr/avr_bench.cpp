@@ -0,0 +1,235 @@
+// ATmega328P firmware that measures the cycle cost of the number formatting
+// routines in std/stdlib.cpp with Timer1 and prints one CSV line per case
+// over UART0. Build and run it under simavr with the Makefile next to it.
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "std/stdlib.hpp"
+
+#if __has_include(<simavr/avr/avr_mcu_section.h>)
+#include <simavr/avr/avr_mcu_section.h>
+AVR_MCU(F_CPU, "atmega328p");
+#endif
+
+#ifndef BAUD
+#define BAUD 115200
+#endif
+
+namespace {
+
+constexpr uint8_t SAMPLES = 16;
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r"(value) : "memory");
+}
+
+/*********************************************/
+/*  Cases                                    */
+/*********************************************/
+
+// Every case is a separate non-inlined function so that avr-nm reports its
+// footprint and the call overhead is the same for all of them.
+using Case = void (*)(uint32_t value, char* buffer);
+
+#define BENCH_CASE(name, type, ...)                                                \
+    __attribute__((noinline)) void bench_##name##_##type(uint32_t v, char* buffer) { \
+        [[maybe_unused]] const auto value = static_cast<type>(v);                  \
+        do_not_optimize(__VA_ARGS__);                                              \
+    }
+
+BENCH_CASE(baseline, uint16_t, buffer)
+BENCH_CASE(format_decimal, uint16_t, format_decimal(value, buffer, 5))
+BENCH_CASE(format_decimal, uint32_t, format_decimal(value, buffer, 10))
+BENCH_CASE(format_hex, uint16_t, format_hex(value, buffer, 4))
+BENCH_CASE(format_hex, uint32_t, format_hex(value, buffer, 8))
+BENCH_CASE(format_octal, uint16_t, format_octal(value, buffer, 6))
+BENCH_CASE(format_octal, uint32_t, format_octal(value, buffer, 11))
+BENCH_CASE(format_binary, uint16_t, format_binary(value, buffer, 16))
+BENCH_CASE(format_binary, uint32_t, format_binary(value, buffer, 32))
+BENCH_CASE(format_base36, uint16_t, format(value, buffer, 36, 4))
+BENCH_CASE(format_base36, uint32_t, format(value, buffer, 36, 7))
+BENCH_CASE(utoa, uint16_t, utoa<uint16_t>(value, buffer, 10))
+BENCH_CASE(utoa, uint32_t, utoa<uint32_t>(value, buffer, 10))
+BENCH_CASE(itoa, int16_t, itoa<int16_t>(value, buffer, 10))
+BENCH_CASE(itoa, int32_t, itoa<int32_t>(value, buffer, 10))
+// avr-libc's hand-written assembly and printf as reference points
+BENCH_CASE(libc_utoa, uint16_t, ::utoa(value, buffer, 10))
+BENCH_CASE(libc_ultoa, uint32_t, ::ultoa(value, buffer, 10))
+BENCH_CASE(snprintf, uint16_t, snprintf(buffer, 12, "%u", value))
+BENCH_CASE(snprintf, uint32_t, snprintf(buffer, 12, "%lu", value))
+
+#undef BENCH_CASE
+
+struct Benchmark {
+    const char* name;
+    const char* type;
+    Case fn;
+    bool wide;
+};
+
+#define BENCH_ENTRY(name, type, wide) {#name, #type, bench_##name##_##type, wide}
+
+const Benchmark g_benchmarks[] = {
+    BENCH_ENTRY(format_decimal, uint16_t, false),
+    BENCH_ENTRY(format_decimal, uint32_t, true),
+    BENCH_ENTRY(format_hex, uint16_t, false),
+    BENCH_ENTRY(format_hex, uint32_t, true),
+    BENCH_ENTRY(format_octal, uint16_t, false),
+    BENCH_ENTRY(format_octal, uint32_t, true),
+    BENCH_ENTRY(format_binary, uint16_t, false),
+    BENCH_ENTRY(format_binary, uint32_t, true),
+    BENCH_ENTRY(format_base36, uint16_t, false),
+    BENCH_ENTRY(format_base36, uint32_t, true),
+    BENCH_ENTRY(utoa, uint16_t, false),
+    BENCH_ENTRY(utoa, uint32_t, true),
+    BENCH_ENTRY(itoa, int16_t, false),
+    BENCH_ENTRY(itoa, int32_t, true),
+    BENCH_ENTRY(libc_utoa, uint16_t, false),
+    BENCH_ENTRY(libc_ultoa, uint32_t, true),
+    BENCH_ENTRY(snprintf, uint16_t, false),
+    BENCH_ENTRY(snprintf, uint32_t, true),
+};
+
+#undef BENCH_ENTRY
+
+/*********************************************/
+/*  Inputs                                   */
+/*********************************************/
+
+enum class Distribution : uint8_t { Small, Medium, Large, Mixed, Count };
+
+const char* name(Distribution distribution) {
+    constexpr const char* names[] = {"small", "medium", "large", "mixed"};
+    return names[static_cast<uint8_t>(distribution)];
+}
+
+// xorshift32 with a fixed seed, so that every run sees the same inputs
+uint32_t g_state;
+
+uint32_t next() {
+    g_state ^= g_state << 13;
+    g_state ^= g_state >> 17;
+    g_state ^= g_state << 5;
+    return g_state;
+}
+
+uint32_t sample(Distribution distribution, bool wide) {
+    const uint32_t random = next();
+    switch (distribution) {
+    case Distribution::Small:
+        return random % 100;
+    case Distribution::Medium:
+        return wide ? random % 100'000 : random % 1'000;
+    case Distribution::Large:
+        return wide ? random | 0x80000000ul : (random & 0xFFFF) | 0x8000;
+    default:
+        // every digit count equally likely
+        return (wide ? random : random & 0xFFFF) >> (next() % (wide ? 32 : 16));
+    }
+}
+
+/*********************************************/
+/*  Timing                                   */
+/*********************************************/
+
+// Timer1 runs at F_CPU and counts the overflows, so cases longer than
+// 65535 cycles are still measured correctly.
+volatile uint16_t g_overflows;
+
+void start_timer() {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TIMSK1 = _BV(TOIE1);
+}
+
+uint32_t measure(Case fn, uint32_t value, char* buffer) {
+    cli();
+    g_overflows = 0;
+    TIFR1 = _BV(TOV1);
+    TCNT1 = 0;
+    sei();
+    fn(value, buffer);
+    cli();
+    const uint16_t low = TCNT1;
+    uint16_t high = g_overflows;
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++; // overflowed after cli()
+    sei();
+    return (static_cast<uint32_t>(high) << 16) | low;
+}
+
+/*********************************************/
+/*  Output                                   */
+/*********************************************/
+
+void start_uart() {
+    UCSR0A = _BV(U2X0);
+    UBRR0 = F_CPU / 8 / BAUD - 1;
+    UCSR0B = _BV(TXEN0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+}
+
+void put(char c) {
+    loop_until_bit_is_set(UCSR0A, UDRE0);
+    UCSR0A |= _BV(TXC0); // cleared by writing a one, see the final flush
+    UDR0 = c;
+}
+
+void put(const char* str) {
+    while (*str) put(*str++);
+}
+
+void put(uint32_t value) {
+    char buffer[11];
+    put(utoa<uint32_t>(value, buffer));
+}
+
+} // namespace
+
+ISR(TIMER1_OVF_vect) {
+    g_overflows = g_overflows + 1;
+}
+
+int main() {
+    start_uart();
+    start_timer();
+    sei();
+
+    char buffer[40];
+
+    // the cost of the call itself is subtracted from every measurement
+    const uint32_t overhead = measure(bench_baseline_uint16_t, 0, buffer);
+
+    put("bench,function,type,distribution,min,avg,max\n");
+    for (const auto& benchmark : g_benchmarks) {
+        for (uint8_t d = 0; d < static_cast<uint8_t>(Distribution::Count); d++) {
+            const auto distribution = static_cast<Distribution>(d);
+            g_state = 2463534242ul;
+
+            uint32_t min = UINT32_MAX, max = 0, total = 0;
+            for (uint8_t i = 0; i < SAMPLES; i++) {
+                const uint32_t cycles = measure(benchmark.fn, sample(distribution, benchmark.wide), buffer) - overhead;
+                min = cycles < min ? cycles : min;
+                max = cycles > max ? cycles : max;
+                total += cycles;
+            }
+
+            put("bench,"); put(benchmark.name);
+            put(','); put(benchmark.type);
+            put(','); put(name(distribution));
+            put(','); put(min);
+            put(','); put(total / SAMPLES);
+            put(','); put(max);
+            put('\n');
+        }
+    }
+
+    // simavr exits when the core sleeps with interrupts disabled
+    loop_until_bit_is_set(UCSR0A, TXC0);
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+}
@@ -0,0 +1,77 @@
+#pragma once
+// Self-contained micro-benchmark harness. Each case is calibrated to run for
+// roughly MIN_TIME and reported in ns per operation; pass --json to get one
+// JSON object per line for regression tracking instead of the table.
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace bench {
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber() {
+    asm volatile("" : : : "memory");
+}
+
+struct Options {
+    bool json{false};
+    const char* filter{nullptr};
+};
+
+inline Options& options() {
+    static Options o;
+    return o;
+}
+
+inline void parse(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) options().json = true;
+        else options().filter = argv[i];
+    }
+}
+
+constexpr auto MIN_TIME = std::chrono::milliseconds(50);
+
+// 'fn' performs 'ops' operations per call
+template <typename Fn>
+void run(const char* group, const char* name, size_t ops, Fn&& fn) {
+    if (options().filter && !strstr(group, options().filter) && !strstr(name, options().filter)) return;
+
+    using clock = std::chrono::steady_clock;
+    size_t iterations = 1;
+    double elapsed_ns = 0;
+
+    while (true) {
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; i++) fn();
+        const auto end = clock::now();
+        elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (end - start >= MIN_TIME || iterations >= (size_t{1} << 30)) break;
+        iterations *= 2;
+    }
+
+    const double ns = elapsed_ns / static_cast<double>(iterations * ops);
+    if (options().json) {
+        printf("{\"group\": \"%s\", \"name\": \"%s\", \"ns_per_op\": %.4f, \"iterations\": %zu}\n", group, name, ns, iterations * ops);
+    } else {
+        printf("%-12s %-40s %10.3f ns/op\n", group, name, ns);
+    }
+}
+
+// xorshift32, so that inputs are identical on every run and platform
+struct Random {
+    uint32_t state{2463534242u};
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+} // namespace bench
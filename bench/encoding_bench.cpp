@@ -0,0 +1,52 @@
+// Bulk hex and Base64/Base32 encoding from std/encoding.hpp against the
+// per-byte utoa() loop they replace and a plain table lookup.
+#include "bench.hpp"
+#include "std/encoding.hpp"
+#include "std/stdlib.hpp"
+
+namespace {
+
+constexpr size_t SIZE = 1024;
+
+uint8_t g_data[SIZE];
+char g_text[SIZE * 3 + 4];
+
+template <typename Fn>
+void run(const char* name, Fn&& fn) {
+    bench::run("encoding", name, SIZE, [&] { fn(); bench::do_not_optimize(g_text); bench::clobber(); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+    bench::Random random;
+    for (auto& byte : g_data) byte = static_cast<uint8_t>(random.next());
+
+    run("hex utoa per byte", [] {
+        char* str = g_text;
+        for (auto byte : g_data) {
+            if (byte < 0x10) *str++ = '0';
+            utoa(byte, str, 16);
+            str += byte < 0x10 ? 1 : 2;
+        }
+    });
+    run("hex table lookup", [] {
+        for (size_t i = 0; i < SIZE; i++) {
+            g_text[2 * i] = "0123456789abcdef"[g_data[i] >> 4];
+            g_text[2 * i + 1] = "0123456789abcdef"[g_data[i] & 0xF];
+        }
+    });
+    run("hex_encode (SWAR)", [] { detail::hex_encode_swar(g_data, SIZE, g_text, false); });
+    run("hex_encode", [] { hex_encode(g_data, SIZE, g_text); });
+    run("hex_encode separator", [] { hex_encode(g_data, SIZE, g_text, ":"); });
+
+    run("base64_encode", [] { base64_encode(g_data, SIZE, g_text); });
+    const auto base64_length = base64_encode(g_data, SIZE, g_text);
+    uint8_t decoded[SIZE];
+    run("base64_decode", [&] { bench::do_not_optimize(base64_decode(g_text, base64_length, decoded)); });
+
+    run("base32_encode", [] { base32_encode(g_data, SIZE, g_text); });
+    const auto base32_length = base32_encode(g_data, SIZE, g_text);
+    run("base32_decode", [&] { bench::do_not_optimize(base32_decode(g_text, base32_length, decoded)); });
+}
@@ -0,0 +1,109 @@
+// Number formatting from std/stdlib.cpp and its users, compared as:
+//   - format_* and utoa/itoa, with their tables and as built for
+//     OptimizeFor::Size, against std::to_chars and snprintf over several
+//     input distributions
+//   - format_values() joining a sample buffer into a String against a
+//     concat(int) loop
+//   - fixtoa() on fixed_point readings against ftoa() on doubles
+#include "bench.hpp"
+#include "Arduino.h"
+#include "std/fixed_point.hpp"
+#include "std/format_values.hpp"
+#include "std/stdlib.hpp"
+#include <charconv>
+#include <stdio.h>
+
+namespace {
+
+constexpr size_t COUNT = 1024;
+
+struct Distribution {
+    const char* name;
+    uint32_t values[COUNT];
+};
+
+Distribution g_distributions[4] = {{"small"}, {"medium"}, {"large"}, {"mixed"}};
+
+void fill_distributions() {
+    bench::Random random;
+    for (size_t i = 0; i < COUNT; i++) {
+        g_distributions[0].values[i] = random.next() % 100;
+        g_distributions[1].values[i] = random.next() % 100'000;
+        g_distributions[2].values[i] = random.next() | 0x80000000u;
+        // every digit count equally likely
+        g_distributions[3].values[i] = random.next() >> (random.next() % 32);
+    }
+}
+
+template <typename Fn>
+void run_all(const char* name, Fn&& fn) {
+    for (const auto& distribution : g_distributions) {
+        char label[64];
+        snprintf(label, sizeof(label), "%s/%s", name, distribution.name);
+        bench::run("format", label, COUNT, [&] {
+            for (auto value : distribution.values) fn(value);
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+    fill_distributions();
+
+    char buffer[40];
+
+    run_all("format_decimal", [&](uint32_t v) { bench::do_not_optimize(format_decimal(v, buffer, 10)); bench::clobber(); });
+    run_all("format_hex", [&](uint32_t v) { bench::do_not_optimize(format_hex(v, buffer, 8)); bench::clobber(); });
+    run_all("format_octal", [&](uint32_t v) { bench::do_not_optimize(format_octal(v, buffer, 11)); bench::clobber(); });
+    run_all("format_binary", [&](uint32_t v) { bench::do_not_optimize(format_binary(v, buffer, 32)); bench::clobber(); });
+    run_all("format(base 36)", [&](uint32_t v) { bench::do_not_optimize(format(v, buffer, 36, 7)); bench::clobber(); });
+
+    run_all("utoa(10)", [&](uint32_t v) { bench::do_not_optimize(utoa(v, buffer, 10)); bench::clobber(); });
+    run_all("utoa(16)", [&](uint32_t v) { bench::do_not_optimize(utoa(v, buffer, 16)); bench::clobber(); });
+    run_all("utoa(2)", [&](uint32_t v) { bench::do_not_optimize(utoa(v, buffer, 2)); bench::clobber(); });
+    run_all("itoa(10)", [&](uint32_t v) { bench::do_not_optimize(itoa(static_cast<int32_t>(v) - (1 << 20), buffer, 10)); bench::clobber(); });
+
+    // the table-free OptimizeFor::Size code against the tables above
+    run_all("format_decimal<Size>", [&](uint32_t v) { bench::do_not_optimize(format_decimal<uint32_t, OptimizeFor::Size>(v, buffer, 10)); bench::clobber(); });
+    run_all("format_hex<Size>", [&](uint32_t v) { bench::do_not_optimize(format_hex<uint32_t, OptimizeFor::Size>(v, buffer, 8)); bench::clobber(); });
+    run_all("utoa<Size>(10)", [&](uint32_t v) { bench::do_not_optimize(utoa<uint32_t, OptimizeFor::Size>(v, buffer, 10)); bench::clobber(); });
+
+    run_all("std::to_chars(10)", [&](uint32_t v) { bench::do_not_optimize(std::to_chars(buffer, buffer + sizeof(buffer), v).ptr); bench::clobber(); });
+    run_all("std::to_chars(16)", [&](uint32_t v) { bench::do_not_optimize(std::to_chars(buffer, buffer + sizeof(buffer), v, 16).ptr); bench::clobber(); });
+    run_all("snprintf(%u)", [&](uint32_t v) { bench::do_not_optimize(snprintf(buffer, sizeof(buffer), "%u", v)); bench::clobber(); });
+    run_all("snprintf(%x)", [&](uint32_t v) { bench::do_not_optimize(snprintf(buffer, sizeof(buffer), "%x", v)); bench::clobber(); });
+
+    // the same readings with two decimals, as fixed_point and as double
+    run_all("fixtoa(fixed_point<2>)", [&](uint32_t v) {
+        bench::do_not_optimize(fixtoa(fixed_point<2>::from_raw(static_cast<int32_t>(v >> 1)), buffer));
+        bench::clobber();
+    });
+    run_all("ftoa(double, 2)", [&](uint32_t v) {
+        bench::do_not_optimize(ftoa(static_cast<int32_t>(v >> 1) / 100.0, buffer, 2));
+        bench::clobber();
+    });
+
+    // 64 ADC readings into one CSV line, per value
+    uint16_t samples[64];
+    for (size_t i = 0; i < 64; i++) samples[i] = static_cast<uint16_t>(g_distributions[3].values[i] & 0x3FF);
+    bench::run("format", "64 samples concat(int)", 64, [&] {
+        String line;
+        for (size_t i = 0; i < 64; i++) {
+            if (i > 0) line += ',';
+            line.concat(static_cast<unsigned int>(samples[i]));
+        }
+        bench::do_not_optimize(line.c_str());
+    });
+    bench::run("format", "64 samples format_values(String)", 64, [&] {
+        String line;
+        format_values(samples, 64, line);
+        bench::do_not_optimize(line.c_str());
+    });
+    char csv[64 * 6];
+    bench::run("format", "64 samples format_values(buffer)", 64, [&] {
+        bench::do_not_optimize(format_values(samples, 64, csv));
+        bench::clobber();
+    });
+}
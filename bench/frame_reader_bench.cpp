@@ -0,0 +1,66 @@
+// Splitting serial input into lines: the String::concat(char) + indexOf()
+// loop FrameReader replaces, against FrameReader on the same bytes.
+#include "bench.hpp"
+#include "Arduino.h"
+#include "FrameReader.hpp"
+
+namespace {
+
+// replays a fixed buffer like a serial port that always has data waiting
+struct ReplayStream {
+    const char* data;
+    size_t size;
+    size_t position{0};
+
+    int available() { return static_cast<int>(size - position); }
+    int read() { return position < size ? static_cast<uint8_t>(data[position++]) : -1; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+
+    char input[4096];
+    size_t size = 0;
+    bench::Random random;
+    size_t lines = 0;
+    while (size + 48 < sizeof(input)) {
+        size += static_cast<size_t>(snprintf(input + size, sizeof(input) - size, "set sensor/%u/threshold %u\r\n", random.next() % 100, random.next() % 10000));
+        lines++;
+    }
+
+    bench::run("lines", "String concat+indexOf", lines, [&] {
+        ReplayStream stream{input, size};
+        String pending;
+        size_t total = 0;
+        while (stream.available() > 0) {
+            pending.concat(static_cast<char>(stream.read()));
+            const auto newline = pending.indexOf('\n');
+            if (newline >= 0) {
+                String line = pending.subString(0, newline);
+                total += line.length();
+                pending.remove(0, newline + 1);
+            }
+        }
+        bench::do_not_optimize(total);
+    });
+    bench::run("lines", "FrameReader<64>", lines, [&] {
+        ReplayStream stream{input, size};
+        FrameReader<64> reader;
+        StringView line;
+        size_t total = 0;
+        while (reader.next(stream, line)) total += line.length();
+        bench::do_not_optimize(total);
+    });
+    bench::run("lines", "FrameReader<64>::feed", lines, [&] {
+        FrameReader<64> reader;
+        StringView line;
+        size_t total = 0;
+        for (size_t sent = 0; sent < size;) {
+            sent += reader.feed(input + sent, size - sent);
+            while (reader.next(line)) total += line.length();
+        }
+        bench::do_not_optimize(total);
+    });
+}
@@ -0,0 +1,52 @@
+// Command dispatch through a compile-time perfect hash against the chain of
+// equals() it replaces, and the raw speed of the hash functions.
+#include "bench.hpp"
+#include "Arduino.h"
+#include "std/hash.hpp"
+
+namespace {
+
+constexpr auto g_commands = make_command_table(
+    "help", "status", "reset", "reboot", "version", "uptime", "led on", "led off",
+    "log level", "log dump", "config get", "config set", "config save", "wifi scan",
+    "wifi join", "wifi leave", "mqtt connect", "mqtt publish", "sensor read", "sensor list");
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+
+    String inputs[g_commands.size() + 4];
+    for (size_t i = 0; i < g_commands.size(); i++) inputs[i] = String(g_commands[i].data());
+    inputs[g_commands.size()] = String("unknown");
+    inputs[g_commands.size() + 1] = String("sensor");
+    inputs[g_commands.size() + 2] = String("wifi join now");
+    inputs[g_commands.size() + 3] = String("x");
+    constexpr size_t COUNT = sizeof(inputs) / sizeof(inputs[0]);
+
+    bench::run("dispatch", "equals chain", COUNT, [&] {
+        for (const auto& input : inputs) {
+            int found = -1;
+            for (size_t i = 0; i < g_commands.size(); i++) {
+                if (input.equals(g_commands[i].data())) {
+                    found = static_cast<int>(i);
+                    break;
+                }
+            }
+            bench::do_not_optimize(found);
+        }
+    });
+    bench::run("dispatch", "CommandTable::find", COUNT, [&] {
+        for (const auto& input : inputs) bench::do_not_optimize(g_commands.find(input));
+    });
+
+    char data[256];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = static_cast<char>(i * 7);
+    for (size_t length : {8u, 32u, 256u}) {
+        char name[32];
+        snprintf(name, sizeof(name), "fnv1a/%zu", length);
+        bench::run("hash", name, 1, [&] { bench::do_not_optimize(fnv1a(data, length)); bench::clobber(); });
+        snprintf(name, sizeof(name), "wyhash/%zu", length);
+        bench::run("hash", name, 1, [&] { bench::do_not_optimize(wyhash(data, length)); bench::clobber(); });
+    }
+}
@@ -0,0 +1,66 @@
+// Capturing device log lines on the host: appending them to a RecordLog
+// segment against fwrite() into a file, flushed after every line as a
+// capture that others tail has to, and left to stdio's buffering.
+#include "bench.hpp"
+#include "Arduino.h"
+#include "RecordLog.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+constexpr size_t LINES = 1024;
+// rotated (or rewound) at this size, like a capture would
+constexpr size_t SEGMENT = 32 << 20;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+
+    char text[LINES * 48];
+    StringView lines[LINES];
+    bench::Random random;
+    size_t used = 0;
+    for (auto& line : lines) {
+        const int length = snprintf(text + used, sizeof(text) - used, "t=%u.%02u rssi=-%u adc=%u", random.next() % 40, random.next() % 100,
+                                    random.next() % 100, random.next() % 1024);
+        line = StringView(text + used, static_cast<size_t>(length));
+        used += static_cast<size_t>(length) + 1;
+    }
+
+    char path[] = "/tmp/record_log_benchXXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+
+    {
+        auto log = RecordLog::create(path, SEGMENT, SEGMENT / 32);
+        uint64_t time = 0;
+        bench::run("capture", "RecordLog::append", LINES, [&] {
+            for (const auto& line : lines) {
+                if (!log.append(1, time++, line)) {
+                    log = RecordLog::create(path, SEGMENT, SEGMENT / 32);
+                    log.append(1, time, line);
+                }
+            }
+        });
+    }
+
+    const auto run_stdio = [&](const char* name, bool flush) {
+        FILE* file = fopen(path, "w");
+        bench::run("capture", name, LINES, [&] {
+            for (const auto& line : lines) {
+                fwrite(line.data(), 1, line.length(), file);
+                fputc('\n', file);
+                if (flush) fflush(file);
+            }
+            if (ftell(file) > static_cast<long>(SEGMENT)) rewind(file);
+        });
+        fclose(file);
+    };
+    run_stdio("fwrite+fflush per line", true);
+    run_stdio("fwrite (stdio buffer)", false);
+
+    unlink(path);
+}
@@ -0,0 +1,122 @@
+// StringBase public operations, each paired with its std::string analogue
+// where one exists.
+#include "bench.hpp"
+#include "Arduino.h"
+#include "std/StringView.hpp"
+#include <string>
+
+namespace {
+
+constexpr const char* SHORT = "temperature";
+constexpr const char* LONG = "  The quick brown fox jumps over the lazy dog, 0123456789 times.  ";
+constexpr const char16_t* LONG16 = u"  The quick brown fox jumps over the lazy dog, 0123456789 times.  ";
+constexpr const char32_t* LONG32 = U"  The quick brown fox jumps over the lazy dog, 0123456789 times.  ";
+
+template <typename Fn>
+void run(const char* name, Fn&& fn) {
+    bench::run("string", name, 1, fn);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+
+    const String s_short(SHORT);
+    const String s_long(LONG);
+    const std::string std_short(SHORT);
+    const std::string std_long(LONG);
+    const SharedString shared_long(LONG);
+
+    // construction
+    run("ctor(literal)", [&] { String s(SHORT); bench::do_not_optimize(s.c_str()); });
+    run("std::string(literal)", [&] { std::string s(SHORT); bench::do_not_optimize(s.data()); });
+    run("ctor(copy)", [&] { String s(s_long); bench::do_not_optimize(s.c_str()); });
+    run("SharedString(copy)", [&] { SharedString s(shared_long); bench::do_not_optimize(s.length()); });
+    run("std::string(copy)", [&] { std::string s(std_long); bench::do_not_optimize(s.data()); });
+    run("ctor(move)", [&] { String a(SHORT); String b(std::move(a)); bench::do_not_optimize(b.c_str()); });
+    run("std::string(move)", [&] { std::string a(SHORT); std::string b(std::move(a)); bench::do_not_optimize(b.data()); });
+    run("ctor(long)", [&] { String s(-1234567L); bench::do_not_optimize(s.c_str()); });
+    run("ctor(unsigned long, 16)", [&] { String s(0xDEADBEEFUL, 16); bench::do_not_optimize(s.c_str()); });
+    run("std::to_string(long)", [&] { auto s = std::to_string(-1234567L); bench::do_not_optimize(s.data()); });
+    run("ctor(float)", [&] { String s(3.14159f, 3); bench::do_not_optimize(s.c_str()); });
+
+    // concatenation
+    run("concat(String)", [&] { String s(SHORT); s.concat(s_long); bench::do_not_optimize(s.c_str()); });
+    run("std::string::append", [&] { std::string s(SHORT); s.append(std_long); bench::do_not_optimize(s.data()); });
+    run("concat(cstr)", [&] { String s(SHORT); s.concat(LONG); bench::do_not_optimize(s.c_str()); });
+    run("concat(char)x16", [&] { String s; for (char c = 'a'; c < 'a' + 16; c++) s.concat(c); bench::do_not_optimize(s.c_str()); });
+    run("std::string::push_back x16", [&] { std::string s; for (char c = 'a'; c < 'a' + 16; c++) s.push_back(c); bench::do_not_optimize(s.data()); });
+    run("concat(int)", [&] { String s(SHORT); s.concat(-4711); bench::do_not_optimize(s.c_str()); });
+    run("concat(double)", [&] { String s(SHORT); s.concat(2.71828); bench::do_not_optimize(s.c_str()); });
+    run("operator+", [&] { String s = s_short + s_long; bench::do_not_optimize(s.c_str()); });
+    run("std::string operator+", [&] { std::string s = std_short + std_long; bench::do_not_optimize(s.data()); });
+
+    // comparison
+    const String other(LONG);
+    const String upper("  THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, 0123456789 TIMES.  ");
+    const std::string std_other(LONG);
+    run("compareTo", [&] { bench::do_not_optimize(s_long.compareTo(other)); });
+    run("std::string::compare", [&] { bench::do_not_optimize(std_long.compare(std_other)); });
+    run("equals", [&] { bench::do_not_optimize(s_long.equals(other)); });
+    run("std::string operator==", [&] { bench::do_not_optimize(std_long == std_other); });
+    run("equalsIgnoreCase", [&] { bench::do_not_optimize(s_long.equalsIgnoreCase(upper)); });
+    run("startsWith", [&] { bench::do_not_optimize(s_long.startsWith(String("  The"))); });
+    run("std::string::starts_with", [&] { bench::do_not_optimize(std_long.starts_with("  The")); });
+    run("endsWith", [&] { bench::do_not_optimize(s_long.endsWith(String("times.  "))); });
+    run("std::string::ends_with", [&] { bench::do_not_optimize(std_long.ends_with("times.  ")); });
+
+    // search
+    const String needle("lazy");
+    run("indexOf(char)", [&] { bench::do_not_optimize(s_long.indexOf('9')); });
+    run("std::string::find(char)", [&] { bench::do_not_optimize(std_long.find('9')); });
+    run("indexOf(String)", [&] { bench::do_not_optimize(s_long.indexOf(needle)); });
+    run("std::string::find(string)", [&] { bench::do_not_optimize(std_long.find("lazy")); });
+    run("lastIndexOf(char)", [&] { bench::do_not_optimize(s_long.lastIndexOf('T')); });
+    run("std::string::rfind(char)", [&] { bench::do_not_optimize(std_long.rfind('T')); });
+    run("lastIndexOf(String)", [&] { bench::do_not_optimize(s_long.lastIndexOf(needle)); });
+    run("contains(cstr)", [&] { bench::do_not_optimize(s_long.contains("lazy")); });
+
+    // modification
+    run("subString", [&] { String s = s_long.subString(6, 25); bench::do_not_optimize(s.c_str()); });
+    run("SharedString::subString", [&] { SharedString s = shared_long.subString(6, 25); bench::do_not_optimize(StringView(s).data()); });
+    run("std::string::substr", [&] { std::string s = std_long.substr(6, 19); bench::do_not_optimize(s.data()); });
+    run("replace(char)", [&] { String s(s_long); s.replace('o', '0'); bench::do_not_optimize(s.c_str()); });
+    run("replace(String)", [&] { String s(s_long); s.replace(String("the"), String("a")); bench::do_not_optimize(s.c_str()); });
+    run("remove", [&] { String s(s_long); s.remove(4, 10); bench::do_not_optimize(s.c_str()); });
+    run("std::string::erase", [&] { std::string s(std_long); s.erase(4, 10); bench::do_not_optimize(s.data()); });
+    run("toLowerCase", [&] { String s(s_long); s.toLowerCase(); bench::do_not_optimize(s.c_str()); });
+    run("toUpperCase", [&] { String s(s_long); s.toUpperCase(); bench::do_not_optimize(s.c_str()); });
+    run("trim", [&] { String s(s_long); s.trim(); bench::do_not_optimize(s.c_str()); });
+    run("fill", [&] { String s; s.fill('x', 24); bench::do_not_optimize(s.c_str()); });
+    run("std::string::assign(n, c)", [&] { std::string s; s.assign(24, 'x'); bench::do_not_optimize(s.data()); });
+    run("erase", [&] { String s(s_long); s.erase(); bench::do_not_optimize(s.c_str()); });
+    run("reset", [&] { String s(s_long); s.reset(); bench::do_not_optimize(s.c_str()); });
+
+    // wide strings
+    const U16String u16_long(LONG16);
+    const U32String u32_long(LONG32);
+    const std::u16string std_u16_long(LONG16);
+    const std::u32string std_u32_long(LONG32);
+    run("U16String(literal)", [&] { U16String s(LONG16); bench::do_not_optimize(s.c_str()); });
+    run("std::u16string(literal)", [&] { std::u16string s(LONG16); bench::do_not_optimize(s.data()); });
+    run("U16String::indexOf(char)", [&] { bench::do_not_optimize(u16_long.indexOf(u'9')); });
+    run("std::u16string::find(char)", [&] { bench::do_not_optimize(std_u16_long.find(u'9')); });
+    run("U16String::indexOf(cstr)", [&] { bench::do_not_optimize(u16_long.indexOf(u"lazy")); });
+    run("std::u16string::find(cstr)", [&] { bench::do_not_optimize(std_u16_long.find(u"lazy")); });
+    run("U32String::indexOf(char)", [&] { bench::do_not_optimize(u32_long.indexOf(U'9')); });
+    run("std::u32string::find(char)", [&] { bench::do_not_optimize(std_u32_long.find(U'9')); });
+    run("U32String::compareTo", [&] { bench::do_not_optimize(u32_long.compareTo(u32_long)); });
+
+    // conversion
+    const String integer("-1234567");
+    const String decimal("3.14159");
+    const std::string std_integer("-1234567");
+    run("toInt", [&] { bench::do_not_optimize(integer.toInt()); });
+    run("std::stol", [&] { bench::do_not_optimize(std::stol(std_integer)); });
+    run("toFloat", [&] { bench::do_not_optimize(decimal.toFloat()); });
+    run("toDouble", [&] { bench::do_not_optimize(decimal.toDouble()); });
+    char buffer[80];
+    run("toCharArray", [&] { s_long.toCharArray(buffer, sizeof(buffer)); bench::do_not_optimize(buffer); bench::clobber(); });
+    run("std::string::copy", [&] { buffer[std_long.copy(buffer, sizeof(buffer) - 1)] = 0; bench::do_not_optimize(buffer); bench::clobber(); });
+}
@@ -0,0 +1,62 @@
+// string_map lookups against a linear search over an array of Strings, at
+// the 20-200 entry sizes that config keys and command names come in.
+#include "bench.hpp"
+#include "Arduino.h"
+#include "std/string_map.hpp"
+
+namespace {
+
+template <size_t SIZE>
+void compare() {
+    String keys[SIZE];
+    int values[SIZE];
+    string_map<int, SIZE, SIZE * 24> map;
+    char name[32];
+    for (size_t i = 0; i < SIZE; i++) {
+        snprintf(name, sizeof(name), "sensor/%zu/value", i * 7919 % 10007);
+        keys[i] = String(name);
+        values[i] = static_cast<int>(i);
+        map.insert(keys[i], values[i]);
+    }
+
+    // every key once plus as many misses, shuffled
+    constexpr size_t COUNT = SIZE * 2;
+    String inputs[COUNT];
+    bench::Random random;
+    for (size_t i = 0; i < COUNT; i++) {
+        if (i % 2 == 0) {
+            inputs[i] = keys[random.next() % SIZE];
+        } else {
+            snprintf(name, sizeof(name), "sensor/%u/valu", random.next() % 10007);
+            inputs[i] = String(name);
+        }
+    }
+
+    snprintf(name, sizeof(name), "linear/%zu", SIZE);
+    bench::run("lookup", name, COUNT, [&] {
+        for (const auto& input : inputs) {
+            const int* found = nullptr;
+            for (size_t i = 0; i < SIZE; i++) {
+                if (keys[i] == input) {
+                    found = &values[i];
+                    break;
+                }
+            }
+            bench::do_not_optimize(found);
+        }
+    });
+    snprintf(name, sizeof(name), "string_map/%zu", SIZE);
+    bench::run("lookup", name, COUNT, [&] {
+        for (const auto& input : inputs) bench::do_not_optimize(map.get(input));
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+    compare<20>();
+    compare<50>();
+    compare<100>();
+    compare<200>();
+}
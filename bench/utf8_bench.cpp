@@ -0,0 +1,57 @@
+// UTF-8 validation and code point counting from std/utf8.hpp against the
+// same checks done one byte at a time, on ASCII and on mixed payloads.
+#include "bench.hpp"
+#include "std/utf8.hpp"
+
+namespace {
+
+constexpr size_t SIZE = 1024;
+
+char g_ascii[SIZE];
+char g_mixed[SIZE];
+
+bool valid_bytewise(const char* data, size_t size) {
+    for (size_t i = 0; i < size;) {
+        const auto length = utf8::detail::sequence_length(data, size, i);
+        if (length == 0) return false;
+        i += length;
+    }
+    return true;
+}
+
+size_t length_bytewise(const char* data, size_t size) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) count += (static_cast<uint8_t>(data[i]) & 0xC0) != 0x80;
+    return count;
+}
+
+template <typename Fn>
+void run(const char* name, Fn&& fn) {
+    bench::run("utf8", name, SIZE, [&] { bench::do_not_optimize(fn()); bench::clobber(); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::parse(argc, argv);
+    bench::Random random;
+    // device names and JSON: mostly ASCII with the odd umlaut, dash or emoji
+    const char* pieces[] = {"\"name\":\"", "K\xC3\xBC" "che", " \xE2\x80\x94 ", "Licht", "\xF0\x9F\x92\xA1", "\",", "42"};
+    size_t used = 0;
+    while (used < SIZE) {
+        const char* piece = pieces[random.next() % 7];
+        const size_t length = strlen(piece);
+        if (used + length > SIZE) break;
+        memcpy(g_mixed + used, piece, length);
+        used += length;
+    }
+    for (; used < SIZE; used++) g_mixed[used] = ' ';
+    for (size_t i = 0; i < SIZE; i++) g_ascii[i] = static_cast<char>(' ' + random.next() % 95);
+
+    run("valid bytewise ascii", [] { return valid_bytewise(g_ascii, SIZE); });
+    run("valid ascii", [] { return utf8::valid(g_ascii, SIZE); });
+    run("valid bytewise mixed", [] { return valid_bytewise(g_mixed, SIZE); });
+    run("valid mixed", [] { return utf8::valid(g_mixed, SIZE); });
+    run("length bytewise", [] { return length_bytewise(g_mixed, SIZE); });
+    run("length", [] { return utf8::length(g_mixed, SIZE); });
+}
@@ -0,0 +1,117 @@
+#pragma once
+// Host stand-in for the Arduino core, with just enough of the API for the
+// library to compile and run on a workstation. Time is a fake clock that
+// only moves through delay() or host::advance_millis(), and Serial records
+// everything printed to it and replays input given to host::Serial.feed().
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include "pgmspace.h"
+#include "stdlib_noniso.h"
+#include "std/String.hpp" // WString.h on the device
+
+#define LOW 0
+#define HIGH 1
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// <avr/io.h> and <avr/interrupt.h>: registers are plain variables and an
+// ISR is an ordinary function that a test can call to "fire" it.
+inline volatile uint8_t EICRA = 0;
+inline volatile uint8_t EIMSK = 0;
+#define ISR(vector) inline void vector()
+inline void sei() {}
+inline void cli() {}
+
+namespace host {
+    inline uint32_t& clock() {
+        static uint32_t ms{0};
+        return ms;
+    }
+
+    inline void set_millis(uint32_t ms) { clock() = ms; }
+    inline void advance_millis(uint32_t ms) { clock() += ms; }
+}
+
+inline unsigned long millis() { return host::clock(); }
+inline unsigned long micros() { return host::clock() * 1000UL; }
+inline void delay(unsigned long ms) { host::advance_millis(static_cast<uint32_t>(ms)); }
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    void end() {}
+
+    int available() { return static_cast<int>(m_input.size() - m_read); }
+    int peek() { return available() ? static_cast<unsigned char>(m_input[m_read]) : -1; }
+    int read() { return available() ? static_cast<unsigned char>(m_input[m_read++]) : -1; }
+    void flush() {}
+
+    size_t write(uint8_t c) {
+        m_output.push_back(static_cast<char>(c));
+        m_writes++;
+        return 1;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) {
+        m_output.append(reinterpret_cast<const char *>(buffer), size);
+        m_writes++;
+        return size;
+    }
+
+    size_t write(const char *buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+
+    size_t print(const char *str) { return write(str, strlen(str)); }
+    size_t print(const __FlashStringHelper *str) { return print(reinterpret_cast<const char *>(str)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    template <typename Allocator>
+    size_t print(const StringBase<char, Allocator> &str) { return write(str.begin(), str.length()); }
+
+    template <typename T> requires (std::is_integral_v<T> && !std::is_same_v<T, char>)
+    size_t print(T value, int base = DEC) {
+        char buffer[8 * sizeof(T) + 2];
+        if constexpr (std::is_signed_v<T>) ltoa(static_cast<long>(value), buffer, base);
+        else ultoa(static_cast<unsigned long>(value), buffer, base);
+        return print(buffer);
+    }
+
+    size_t print(double value, int digits = 2) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+        return print(buffer);
+    }
+
+    template <typename T>
+    size_t println(const T &value) { return print(value) + println(); }
+    size_t println() { return print("\r\n"); }
+
+    // host only
+    void feed(const char *input) { m_input += input; }
+    void feed(const char *input, size_t size) { m_input.append(input, size); }
+    const std::string &output() const { return m_output; }
+    size_t writes() const { return m_writes; }
+    void clear() {
+        m_input.clear();
+        m_output.clear();
+        m_read = 0;
+        m_writes = 0;
+    }
+
+private:
+    std::string m_input;
+    std::string m_output;
+    size_t m_read{0};
+    size_t m_writes{0};
+};
+
+inline HardwareSerial Serial;
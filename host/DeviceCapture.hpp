@@ -0,0 +1,154 @@
+#pragma once
+// Host-side (POSIX) capture of device output into a RecordLog: every port
+// is a serial device, or the slave side of a pseudo-terminal standing in
+// for one, read through FrameReader with the framing the devices send
+// (Logger lines by default). One poll() waits on all ports, and everything
+// that has arrived is framed in place and appended to the memory-mapped
+// log; the only system calls per batch are poll() and a read() per port.
+//
+//   auto log = RecordLog::create("capture.seg", 256 << 20, 4 << 20);
+//   DeviceCapture<> capture(log);
+//   capture.add(open_device("/dev/ttyUSB0", B1000000), 0);
+//   capture.add(open_device("/dev/ttyUSB1", B1000000), 1);
+//   while (capture.active()) capture.poll(100);
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "FrameReader.hpp"
+#include "RecordLog.hpp"
+
+// A file descriptor as a stream for FrameReader
+class FdStream {
+public:
+    explicit FdStream(int fd) : m_fd(fd) {}
+
+    int available() {
+        int count = 0;
+        return ioctl(m_fd, FIONREAD, &count) == 0 ? count : 0;
+    }
+    int read() {
+        uint8_t c;
+        return ::read(m_fd, &c, 1) == 1 ? c : -1;
+    }
+    size_t read(uint8_t* buffer, size_t size) {
+        const auto count = ::read(m_fd, buffer, size);
+        return count > 0 ? static_cast<size_t>(count) : 0;
+    }
+
+    int fd() const { return m_fd; }
+
+private:
+    int m_fd;
+};
+
+// Opens a serial port, or a pseudo-terminal's slave side, for capture: raw
+// (no echo, no line editing or CR/LF translation) and non-blocking.
+// Returns the descriptor, or -1 with errno set, also when the port
+// refuses the baud rate or raw mode.
+inline int open_device(const char* path, speed_t baud = B115200) {
+    const int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    termios settings;
+    bool configured = tcgetattr(fd, &settings) == 0;
+    if (configured) {
+        cfmakeraw(&settings);
+        settings.c_cflag |= CLOCAL | CREAD;
+        configured = cfsetispeed(&settings, baud) == 0 && cfsetospeed(&settings, baud) == 0 &&
+            tcsetattr(fd, TCSANOW, &settings) == 0;
+    }
+    if (!configured) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+// Microseconds since the epoch, the default record timestamp
+inline uint64_t capture_time_us() {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1'000'000u + static_cast<uint64_t>(now.tv_nsec) / 1000u;
+}
+
+// Frames the input of many ports into one RecordLog; a record's source is
+// the number its port was added with. A frame longer than SIZE is dropped
+// by its FrameReader, as on the device.
+template <size_t SIZE = 512, Framing FRAMING = Framing::Line>
+class DeviceCapture {
+public:
+    explicit DeviceCapture(RecordLog& log) : m_log(log) {}
+
+    // Watches 'fd' (which stays the caller's to close) for records of 'source'
+    void add(int fd, uint16_t source) {
+        m_ports.push_back(Port{FdStream(fd), source, {}});
+        m_fds.push_back(pollfd{fd, POLLIN, 0});
+    }
+
+    // Waits up to 'timeout_ms' (-1: forever) for input on any port, then
+    // appends every complete frame that has arrived, all stamped with the
+    // time poll() returned. Returns the number of records appended.
+    size_t poll(int timeout_ms) {
+        if (::poll(m_fds.data(), m_fds.size(), timeout_ms) <= 0) return 0;
+        // the index is searched by time, so stamps must never go backwards
+        const uint64_t now = capture_time_us();
+        if (now > m_time) m_time = now;
+
+        size_t appended = 0;
+        for (size_t i = 0; i < m_ports.size(); i++) {
+            auto& fd = m_fds[i];
+            if (fd.revents == 0) continue;
+            Port& port = m_ports[i];
+            StringView frame;
+            while (port.reader.next(port.stream, frame)) {
+                if (m_log.append(port.source, m_time, frame)) appended++;
+                else m_lost++;
+            }
+            // the device went away (a closed pseudo-terminal, an unplugged
+            // adapter) and everything it sent has been read: stop watching
+            if ((fd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0 && port.stream.available() == 0) fd.fd = -1;
+        }
+        m_records += appended;
+        return appended;
+    }
+
+    // true while any port is still open
+    bool active() const {
+        for (const auto& fd : m_fds) {
+            if (fd.fd >= 0) return true;
+        }
+        return false;
+    }
+
+    size_t records() const { return m_records; }
+    // frames that didn't fit the log
+    size_t lost() const { return m_lost; }
+    // frames the readers dropped for being too long or malformed
+    size_t dropped() const {
+        size_t dropped = 0;
+        for (const auto& port : m_ports) dropped += port.reader.dropped();
+        return dropped;
+    }
+
+private:
+    struct Port {
+        FdStream stream;
+        uint16_t source;
+        FrameReader<SIZE, FRAMING> reader;
+    };
+
+    RecordLog& m_log;
+    std::vector<Port> m_ports;
+    std::vector<pollfd> m_fds;
+    uint64_t m_time{0};
+    size_t m_records{0};
+    size_t m_lost{0};
+};
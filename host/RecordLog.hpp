@@ -0,0 +1,276 @@
+#pragma once
+// Host-side (POSIX) capture of what devices print: RecordLog is a segment
+// file of framed records, sized up front and memory-mapped, so appending a
+// record is two memcpy()s into the page cache instead of an fwrite() and a
+// system call per line. An index of record offsets and timestamps at the
+// front of the file lets a reader jump to record N, or to the first record
+// at or after a time, without scanning.
+//
+//   auto log = RecordLog::create("ttyUSB0.seg", 64 << 20, 1 << 20);
+//   log.append(source, timestamp_us, line.data(), line.length());
+//   for (auto record : RecordLog::open("ttyUSB0.seg", false)) replay(record);
+//
+// File layout, in host byte order:
+//   Header        64 bytes
+//   IndexEntry    index_capacity x 16 bytes, one per record
+//   data          data_capacity bytes of RecordHeader + payload, each
+//                 record padded to 8 bytes
+// A record's data and index entry are written before the header's counts,
+// which are stored with release ordering: another process mapping the file
+// read-only sees whole records only. A full segment refuses further
+// records; rotate to a new file then.
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iterator>
+#include <utility>
+#include "std/StringView.hpp"
+
+class RecordLog {
+public:
+    static constexpr char MAGIC[8] = {'M', 'U', 'R', 'E', 'C', 'L', 'O', 'G'};
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t index_capacity; // records
+        uint64_t data_capacity;  // bytes
+        uint64_t count;          // records committed
+        uint64_t data_used;      // bytes of the data region committed
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(Header) == 64);
+
+    struct IndexEntry {
+        uint64_t offset; // of the RecordHeader, from the start of the data region
+        uint64_t timestamp;
+    };
+
+    struct RecordHeader {
+        uint32_t length;
+        uint16_t source;
+        uint16_t flags;
+    };
+
+    struct Record {
+        uint16_t source;
+        uint64_t timestamp;
+        StringView payload; // points into the mapping
+    };
+
+    class iterator {
+        const RecordLog* m_log{nullptr};
+        size_t m_index{0};
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Record;
+        using difference_type = std::ptrdiff_t;
+        using reference = Record;
+
+        constexpr iterator() = default;
+        constexpr iterator(const RecordLog* log, size_t index) : m_log(log), m_index(index) {}
+        Record operator*() const { return (*m_log)[m_index]; }
+        iterator& operator++() { m_index++; return *this; }
+        iterator operator++(int) { iterator retval = *this; ++(*this); return retval; }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_index == b.m_index; }
+    };
+
+    RecordLog() = default;
+    RecordLog(const RecordLog&) = delete;
+    RecordLog& operator=(const RecordLog&) = delete;
+    RecordLog(RecordLog&& other) noexcept { *this = std::move(other); }
+    RecordLog& operator=(RecordLog&& other) noexcept {
+        if (this != &other) {
+            close();
+            m_map = std::exchange(other.m_map, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_fd = std::exchange(other.m_fd, -1);
+            m_writable = std::exchange(other.m_writable, false);
+        }
+        return *this;
+    }
+    ~RecordLog() { close(); }
+
+    // Creates (or truncates) 'path' with room for 'data_capacity' bytes of
+    // records and at most 'index_capacity' of them, with the blocks
+    // allocated up front. The log is invalid, with errno set, on failure,
+    // which includes ENOSPC when the disk can't hold the whole segment.
+    static RecordLog create(const char* path, size_t data_capacity, size_t index_capacity) {
+        RecordLog log;
+        data_capacity = padded(data_capacity);
+        const size_t size = sizeof(Header) + index_capacity * sizeof(IndexEntry) + data_capacity;
+        log.m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (log.m_fd < 0 || ftruncate(log.m_fd, static_cast<off_t>(size)) != 0) return failed(log);
+        // ftruncate() alone leaves a sparse file, and an append into a hole
+        // the disk has no room for is a SIGBUS; so the blocks are reserved
+        // now, and only a file system that can't reserve them stays sparse
+        const int error = posix_fallocate(log.m_fd, 0, static_cast<off_t>(size));
+        if (error != 0 && error != EOPNOTSUPP && error != EINVAL) {
+            errno = error;
+            return failed(log);
+        }
+        if (!log.map(size, true)) return failed(log);
+
+        Header& header = log.header();
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.header_size = sizeof(Header);
+        header.index_capacity = index_capacity;
+        header.data_capacity = data_capacity;
+        return log;
+    }
+
+    // Maps an existing segment, to append to it or, with 'writable' false,
+    // to read it (also while another process is still writing). Invalid
+    // if the file isn't a segment, is shorter than its header says, or has
+    // a record outside the data committed; every record is checked once
+    // here so that reading them back never leaves the mapping.
+    static RecordLog open(const char* path, bool writable = true) {
+        RecordLog log;
+        log.m_fd = ::open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+        struct stat info;
+        if (log.m_fd < 0 || fstat(log.m_fd, &info) != 0) return failed(log);
+        const auto size = static_cast<size_t>(info.st_size);
+        if (size < sizeof(Header) || !log.map(size, writable)) return failed(log);
+
+        const Header& header = log.header();
+        const bool consistent = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+            header.header_size == sizeof(Header) &&
+            header.index_capacity <= (size - sizeof(Header)) / sizeof(IndexEntry) &&
+            header.data_capacity <= size - sizeof(Header) - header.index_capacity * sizeof(IndexEntry) &&
+            header.count <= header.index_capacity && header.data_used <= header.data_capacity;
+        if (!consistent || !log.records_fit()) {
+            log.close();
+            errno = EINVAL;
+        }
+        return log;
+    }
+
+    explicit operator bool() const { return m_map != nullptr; }
+
+    // Copies one record into the segment; false if the log is read-only,
+    // the payload is longer than 4 GiB, or the segment is full.
+    bool append(uint16_t source, uint64_t timestamp, const char* data, size_t size) {
+        if (!m_writable || size > UINT32_MAX) return false;
+        Header& header = this->header();
+        const uint64_t count = header.count;
+        const uint64_t offset = header.data_used;
+        const size_t needed = padded(sizeof(RecordHeader) + size);
+        if (count == header.index_capacity || header.data_capacity - offset < needed) return false;
+
+        char* record = this->data() + offset;
+        const RecordHeader record_header{static_cast<uint32_t>(size), source, 0};
+        memcpy(record, &record_header, sizeof(record_header));
+        memcpy(record + sizeof(RecordHeader), data, size);
+        index()[count] = IndexEntry{offset, timestamp};
+
+        __atomic_store_n(&header.data_used, offset + needed, __ATOMIC_RELEASE);
+        __atomic_store_n(&header.count, count + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    bool append(uint16_t source, uint64_t timestamp, StringView payload) {
+        return append(source, timestamp, payload.data(), payload.length());
+    }
+
+    // Records committed so far
+    size_t size() const { return m_map ? static_cast<size_t>(__atomic_load_n(&header().count, __ATOMIC_ACQUIRE)) : 0; }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return m_map ? static_cast<size_t>(header().index_capacity) : 0; }
+    size_t data_used() const { return m_map ? static_cast<size_t>(__atomic_load_n(&header().data_used, __ATOMIC_ACQUIRE)) : 0; }
+    size_t data_capacity() const { return m_map ? static_cast<size_t>(header().data_capacity) : 0; }
+
+    // Record 'n' < size()
+    Record operator[](size_t n) const {
+        const IndexEntry entry = index()[n];
+        RecordHeader record_header;
+        const char* record = data() + entry.offset;
+        memcpy(&record_header, record, sizeof(record_header));
+        return {record_header.source, entry.timestamp, StringView(record + sizeof(RecordHeader), record_header.length)};
+    }
+
+    // The first record stamped at or after 'timestamp', or size(); a binary
+    // search of the index, so the timestamps have to be appended in order
+    size_t seek(uint64_t timestamp) const {
+        size_t low = 0, high = size();
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            if (index()[middle].timestamp < timestamp) low = middle + 1;
+            else high = middle;
+        }
+        return low;
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const { return iterator{this, size()}; }
+
+    // Starts writing the dirty pages back, or waits for it with 'wait'. The
+    // kernel writes them back eventually anyway, also if the process dies.
+    bool flush(bool wait = false) {
+        return m_map && msync(m_map, m_size, wait ? MS_SYNC : MS_ASYNC) == 0;
+    }
+
+    void close() {
+        if (m_map) munmap(m_map, m_size);
+        if (m_fd >= 0) ::close(m_fd);
+        m_map = nullptr;
+        m_size = 0;
+        m_fd = -1;
+        m_writable = false;
+    }
+
+private:
+    static constexpr size_t padded(size_t size) { return (size + 7) & ~size_t{7}; }
+
+    // closes 'log' but keeps the errno of what failed
+    static RecordLog failed(RecordLog& log) {
+        const int error = errno;
+        log.close();
+        errno = error;
+        return std::move(log);
+    }
+
+    // true if every committed record's header and payload lie within the
+    // committed data, in the order they were appended
+    bool records_fit() const {
+        const uint64_t used = header().data_used;
+        uint64_t end = 0;
+        for (size_t n = 0; n < static_cast<size_t>(header().count); n++) {
+            const uint64_t offset = index()[n].offset;
+            if (offset < end || offset > used || used - offset < sizeof(RecordHeader)) return false;
+            RecordHeader record_header;
+            memcpy(&record_header, data() + offset, sizeof(record_header));
+            if (used - offset - sizeof(RecordHeader) < record_header.length) return false;
+            end = offset + sizeof(RecordHeader) + record_header.length;
+        }
+        return true;
+    }
+
+    bool map(size_t size, bool writable) {
+        void* map = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+        if (map == MAP_FAILED) return false;
+        m_map = static_cast<char*>(map);
+        m_size = size;
+        m_writable = writable;
+        return true;
+    }
+
+    Header& header() { return *reinterpret_cast<Header*>(m_map); }
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_map); }
+    IndexEntry* index() { return reinterpret_cast<IndexEntry*>(m_map + sizeof(Header)); }
+    const IndexEntry* index() const { return reinterpret_cast<const IndexEntry*>(m_map + sizeof(Header)); }
+    char* data() { return m_map + sizeof(Header) + header().index_capacity * sizeof(IndexEntry); }
+    const char* data() const { return m_map + sizeof(Header) + header().index_capacity * sizeof(IndexEntry); }
+
+    char* m_map{nullptr};
+    size_t m_size{0};
+    int m_fd{-1};
+    bool m_writable{false};
+};
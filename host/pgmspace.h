@@ -0,0 +1,21 @@
+#pragma once
+// Host stand-in for <avr/pgmspace.h>: flash and RAM share one address space
+// on the host, so the _P functions are the plain libc ones.
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(string_literal) (string_literal)
+
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t *>(address))
+#define pgm_read_dword(address) (*reinterpret_cast<const uint32_t *>(address))
+#define pgm_read_float(address) (*reinterpret_cast<const float *>(address))
+#define pgm_read_ptr(address) (*reinterpret_cast<const void * const *>(address))
+
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define memcpy_P memcpy
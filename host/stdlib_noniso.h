@@ -0,0 +1,35 @@
+#pragma once
+// Host stand-in for the non-ISO conversions avr-libc and the ESP cores
+// provide. itoa/utoa are left out on purpose: the library's own templates
+// from std/stdlib.hpp are the ones under test.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+inline char *dtostrf(double value, signed char width, unsigned char precision, char *str) {
+    sprintf(str, "%*.*f", width, precision, value);
+    return str;
+}
+
+inline char *ultoa(unsigned long value, char *str, int base) {
+    const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    char buffer[8 * sizeof(unsigned long) + 1];
+    char *end = buffer + sizeof(buffer);
+    char *p = end;
+    do {
+        *--p = digits[value % base];
+        value /= base;
+    } while (value);
+    memcpy(str, p, end - p);
+    str[end - p] = '\0';
+    return str;
+}
+
+inline char *ltoa(long value, char *str, int base) {
+    if (value < 0 && base == 10) {
+        str[0] = '-';
+        ultoa(0 - static_cast<unsigned long>(value), str + 1, base);
+        return str;
+    }
+    return ultoa(static_cast<unsigned long>(value), str, base);
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include "Arduino.h"
+
+// ATmega328P
+#define EXTERNAL_NUM_INTERRUPTS 2
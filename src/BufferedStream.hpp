@@ -0,0 +1,147 @@
+#pragma once
+#include "Arduino.h"
+#include "std/stdlib.hpp"
+#include "std/StringView.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Anything that takes a block of bytes in one call: HardwareSerial, Print
+template <typename T> concept WritableStreamType = requires(T m, const uint8_t* data, size_t size) { m.write(data, size); };
+
+enum class FlushOn : uint8_t {
+    Full,    // only when the buffer is full or on flush()
+    Newline, // also at the end of every print that contains a '\n'
+};
+
+// Collects printed output in a SIZE byte buffer and hands it to the wrapped
+// stream with one write(buffer, length) per flush. Every print() on a
+// HardwareSerial pays for a call, a lock on some cores and a TX buffer
+// check; batching a log line pays that once. Numbers are formatted straight
+// into the buffer with utoa()/itoa()/ftoa().
+//
+//   BufferedStream<HardwareSerial> out(Serial, FlushOn::Newline);
+//   Logger::print(out, "adc=", value, '\n');
+//
+// Whatever is still buffered is written when the object is destroyed.
+template <WritableStreamType Stream, size_t SIZE = 64>
+class BufferedStream {
+    static_assert(SIZE >= 8, "BufferedStream: buffer too small");
+
+public:
+    explicit BufferedStream(Stream& stream, FlushOn policy = FlushOn::Full)
+    : m_stream(stream),
+      m_policy(policy) {}
+
+    BufferedStream(const BufferedStream&) = delete;
+    BufferedStream& operator=(const BufferedStream&) = delete;
+
+    ~BufferedStream() { flush(); }
+
+    size_t write(uint8_t c) {
+        if (m_used == SIZE) flush();
+        m_buffer[m_used++] = static_cast<char>(c);
+        if (c == '\n' && m_policy == FlushOn::Newline) flush();
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t size) {
+        append(reinterpret_cast<const char*>(data), size);
+        if (m_policy == FlushOn::Newline && memchr(data, '\n', size) != nullptr) flush();
+        return size;
+    }
+
+    size_t write(const char* data, size_t size) { return write(reinterpret_cast<const uint8_t*>(data), size); }
+
+    size_t print(const char* str) { return write(str, strlen(str)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(StringView str) { return write(str.data(), str.length()); }
+    template <typename Allocator>
+    size_t print(const StringBase<char, Allocator>& str) { return write(str.begin(), str.length()); }
+
+    size_t print(const __FlashStringHelper* str) {
+        auto p = reinterpret_cast<PGM_P>(str);
+        size_t length = strlen_P(p);
+        const size_t total = length;
+        while (length > 0) {
+            if (m_used == SIZE) flush();
+            const size_t chunk = length < SIZE - m_used ? length : SIZE - m_used;
+            memcpy_P(m_buffer + m_used, p, chunk);
+            m_used += chunk;
+            p += chunk;
+            length -= chunk;
+        }
+        if (m_policy == FlushOn::Newline && memchr(m_buffer, '\n', m_used) != nullptr) flush();
+        return total;
+    }
+
+    template <typename T> requires (std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+    size_t print(T value, int base = DEC) {
+        // the most digits in the base, a sign and utoa's terminator
+        const size_t room = (base >= 10 ? 3 * sizeof(T) : 8 * sizeof(T)) + 2;
+        if (SIZE - m_used < room) flush();
+        if (SIZE < room) {
+            char digits[8 * sizeof(T) + 2];
+            return print(format(value, digits, base));
+        }
+        const auto length = strlen(format(value, m_buffer + m_used, base));
+        m_used += length;
+        return length;
+    }
+
+    // same output as Arduino's Print::print(double, digits), see ftoa()
+    size_t print(double value, int digits = 2) {
+        const auto places = static_cast<uint8_t>(digits < 0 ? 0 : digits > FTOA_MAX_DIGITS ? FTOA_MAX_DIGITS : digits);
+        if (SIZE - m_used < ftoa_size(places)) flush();
+        if (SIZE < ftoa_size(places)) {
+            char text[ftoa_size(FTOA_MAX_DIGITS)];
+            return print(ftoa(value, text, places));
+        }
+        const auto length = strlen(ftoa(value, m_buffer + m_used, places));
+        m_used += length;
+        return length;
+    }
+
+    size_t print(bool value) { return print(static_cast<unsigned>(value)); }
+
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    size_t println() { return print("\r\n"); }
+
+    // hands everything buffered to the stream
+    void flush() {
+        if (m_used == 0) return;
+        m_stream.write(reinterpret_cast<const uint8_t*>(m_buffer), m_used);
+        m_used = 0;
+    }
+
+    // bytes waiting for the next flush
+    size_t pending() const { return m_used; }
+    static constexpr size_t capacity() { return SIZE; }
+
+private:
+    template <typename T>
+    static char* format(T value, char* out, int base) {
+        if constexpr (std::is_signed_v<T>) return itoa(value, out, static_cast<uint8_t>(base));
+        else return utoa(value, out, static_cast<uint8_t>(base));
+    }
+
+    void append(const char* data, size_t size) {
+        if (size > SIZE - m_used) {
+            flush();
+            // too big to be worth copying: pass it straight through
+            if (size >= SIZE) {
+                m_stream.write(reinterpret_cast<const uint8_t*>(data), size);
+                return;
+            }
+        }
+        memcpy(m_buffer + m_used, data, size);
+        m_used += size;
+    }
+
+    Stream& m_stream;
+    FlushOn m_policy;
+    size_t m_used{0};
+    char m_buffer[SIZE];
+};
@@ -0,0 +1,301 @@
+#pragma once
+#include "Arduino.h"
+#include "Interrupt.hpp"
+#include "std/allocator.hpp"
+#include <coroutine>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+// Coroutine frames are carved out of a static arena, so these have to be
+// large enough for the biggest coroutine in the program. The frame size of
+// a coroutine depends on the locals that live across suspension points.
+#ifndef COROUTINE_FRAME_SIZE
+#define COROUTINE_FRAME_SIZE 64
+#endif
+
+#ifndef COROUTINE_FRAME_COUNT
+#define COROUTINE_FRAME_COUNT 8
+#endif
+
+#ifndef COROUTINE_MAX_TASKS
+#define COROUTINE_MAX_TASKS 4
+#endif
+
+namespace async {
+
+class FrameArena {
+    using storage_type = pool<COROUTINE_FRAME_SIZE, COROUTINE_FRAME_COUNT>;
+public:
+    static void* allocate(size_t size) noexcept { return frames().allocate(size); }
+    static void deallocate(void* ptr) noexcept { frames().deallocate(ptr); }
+    static size_t available() noexcept { return frames().available(); }
+
+private:
+    static storage_type& frames() {
+        static storage_type storage;
+        return storage;
+    }
+};
+
+// What a suspended task is waiting for. The scheduler polls 'ready' and
+// resumes 'resume_point' once it returns true.
+struct Wait {
+    bool (*ready)(void* context, uint32_t now){nullptr};
+    void* context{nullptr};
+    std::coroutine_handle<> resume_point{};
+};
+
+class Scheduler;
+
+class task {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation{};
+        // the wait of the scheduler slot running this task, where park()
+        // records what it waits for; null until spawned or awaited
+        Wait* wait{nullptr};
+
+        static void* operator new(size_t size) noexcept { return FrameArena::allocate(size); }
+        static void operator delete(void* ptr) noexcept { FrameArena::deallocate(ptr); }
+        static task get_return_object_on_allocation_failure() noexcept { return task{nullptr}; }
+
+        task get_return_object() noexcept {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    // Resume whoever co_awaited us, or fall back to the scheduler
+                    if (auto next = h.promise().continuation) {
+                        return next;
+                    }
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    constexpr task(task&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    task& operator=(task&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        if (m_handle) m_handle.destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+        return *this;
+    }
+
+    ~task() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    // false when the frame arena was exhausted while creating the coroutine
+    constexpr explicit operator bool() const { return static_cast<bool>(m_handle); }
+    bool done() const { return !m_handle || m_handle.done(); }
+
+    // Awaiting a task runs it to completion before resuming the caller
+    bool await_ready() const noexcept { return done(); }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> caller) noexcept {
+        m_handle.promise().continuation = caller;
+        if constexpr (std::is_same_v<Promise, promise_type>) m_handle.promise().wait = caller.promise().wait;
+        return m_handle;
+    }
+    void await_resume() noexcept {}
+
+private:
+    friend class Scheduler;
+
+    constexpr explicit task(handle_type handle)
+    : m_handle(handle) {}
+
+    handle_type release() { return std::exchange(m_handle, nullptr); }
+
+    handle_type m_handle{nullptr};
+};
+
+class Scheduler {
+    struct Slot {
+        task::handle_type root{nullptr};
+        Wait wait{};
+    };
+
+public:
+    Scheduler() = delete;
+
+    // Takes ownership of the task. Returns false if the task could not be
+    // allocated or there are no free task slots.
+    static bool spawn(task&& t) {
+        if (!t) return false;
+
+        for (auto& slot : slots()) {
+            if (!slot.root) {
+                slot.root = t.release();
+                slot.root.promise().wait = &slot.wait;
+                slot.wait = Wait{};
+                slot.wait.resume_point = slot.root;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Resumes every task whose wait condition is satisfied. Meant to be
+    // called from loop().
+    static void poll() {
+        const auto now = static_cast<uint32_t>(millis());
+
+        for (auto& slot : slots()) {
+            if (!slot.root) continue;
+
+            // Suspended on an awaiter that didn't park it (one from outside
+            // this library): whatever it awaits resumes it, and it parks here
+            // again at its next awaitable from this library. The slot is
+            // freed if it ran to the end instead.
+            if (!slot.wait.resume_point) {
+                if (slot.root.done()) release(slot);
+                continue;
+            }
+
+            if (slot.wait.ready && !slot.wait.ready(slot.wait.context, now)) {
+                continue;
+            }
+
+            auto resume_point = slot.wait.resume_point;
+            slot.wait = Wait{};
+            resume_point.resume();
+
+            if (slot.root.done()) release(slot);
+        }
+    }
+
+    [[noreturn]] static void run() {
+        while (true) {
+            poll();
+        }
+    }
+
+    static bool idle() {
+        for (const auto& slot : slots()) {
+            if (slot.root) return false;
+        }
+        return true;
+    }
+
+    // Called by awaiters from await_suspend to park the task 'h' in its
+    // slot, also when 'h' was resumed by something other than poll()
+    static void park(task::handle_type h, bool (*ready)(void*, uint32_t), void* context) {
+        if (auto* wait = h.promise().wait) {
+            *wait = Wait{ready, context, h};
+        }
+    }
+
+private:
+    static void release(Slot& slot) {
+        slot.root.destroy();
+        slot.root = nullptr;
+    }
+
+    static Slot (&slots())[COROUTINE_MAX_TASKS] {
+        static Slot storage[COROUTINE_MAX_TASKS];
+        return storage;
+    }
+};
+
+/*********************************************/
+/*  Awaitables                               */
+/*********************************************/
+
+// co_await async::delay(ms);
+class delay {
+public:
+    constexpr explicit delay(uint32_t ms)
+    : m_ms(ms) {}
+
+    bool await_ready() const noexcept { return m_ms == 0; }
+    void await_suspend(task::handle_type h) noexcept {
+        m_deadline = static_cast<uint32_t>(millis()) + m_ms;
+        Scheduler::park(h, &expired, this);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    static bool expired(void* context, uint32_t now) {
+        // the subtraction keeps this correct when millis() wraps around
+        return static_cast<int32_t>(now - static_cast<delay*>(context)->m_deadline) >= 0;
+    }
+
+    uint32_t m_ms;
+    uint32_t m_deadline{0};
+};
+
+// co_await async::interrupt<0>{FALLING};
+template <size_t InterruptNum>
+class interrupt {
+public:
+    constexpr explicit interrupt(uint8_t mode)
+    : m_mode(mode) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(task::handle_type h) noexcept {
+        fired() = false;
+        Interrupt::add<InterruptNum>(m_mode, [] { fired() = true; });
+        Scheduler::park(h, &triggered, nullptr);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    static volatile bool& fired() {
+        static volatile bool flag{false};
+        return flag;
+    }
+
+    static bool triggered(void*, uint32_t) { return fired(); }
+
+    uint8_t m_mode;
+};
+
+template <typename T> concept ReadableStreamType = requires(T m) { m.available(); };
+
+// co_await async::readable(Serial);
+template <ReadableStreamType stream>
+class readable {
+public:
+    constexpr explicit readable(stream& str)
+    : m_stream(str) {}
+
+    bool await_ready() const noexcept { return m_stream.available() > 0; }
+    void await_suspend(task::handle_type h) noexcept {
+        Scheduler::park(h, &has_data, &m_stream);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    static bool has_data(void* context, uint32_t) {
+        return static_cast<stream*>(context)->available() > 0;
+    }
+
+    stream& m_stream;
+};
+
+} // namespace async
@@ -0,0 +1,216 @@
+#pragma once
+#include "Arduino.h"
+#include "std/StringView.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Anything bytes can be pulled from: HardwareSerial, SoftwareSerial, Stream
+template <typename T> concept ReadableStreamType = requires(T m) { m.available(); m.read(); };
+
+// Cores where a stream can hand over many bytes in one call (ESP32's
+// HardwareSerial, for one)
+template <typename T> concept BulkReadableStreamType = ReadableStreamType<T> && requires(T m, uint8_t* buffer, size_t size) { m.read(buffer, size); };
+
+enum class Framing : uint8_t {
+    Line,           // ends at '\n'; a '\r' before it is dropped
+    Cobs,           // consistent overhead byte stuffing, ends at 0x00
+    Slip,           // RFC 1055, ends at 0xC0
+    LengthPrefixed, // a 16-bit big-endian payload length, then the payload
+};
+
+// Cuts a byte stream into frames without copying them out. Input is read
+// into a SIZE byte buffer, delimiters are searched with memchr over what has
+// arrived since the last call, and frames come back as StringViews into the
+// buffer; COBS and SLIP frames are decoded in place. A frame stays valid
+// until the next call to next().
+//
+//   FrameReader<64> commands;
+//   StringView line;
+//   while (commands.next(Serial, line)) handle(line);
+//
+// Frames that don't fit in the buffer, and COBS frames that don't decode,
+// are dropped and counted; reading resumes after the next delimiter.
+template <size_t SIZE, Framing FRAMING = Framing::Line>
+class FrameReader {
+    static_assert(SIZE > 2, "FrameReader: buffer too small");
+    static_assert(FRAMING != Framing::LengthPrefixed || SIZE <= 65537, "FrameReader: lengths are 16-bit");
+
+public:
+    // the next complete frame from what's buffered plus whatever 'stream'
+    // has available; false once the stream runs dry without completing one
+    template <ReadableStreamType Stream>
+    bool next(Stream& stream, StringView& frame) {
+        while (true) {
+            if (next(frame)) return true;
+            if (fill(stream) == 0) return false;
+        }
+    }
+
+    // the next complete frame among the bytes already buffered
+    bool next(StringView& frame) {
+        if constexpr (FRAMING == Framing::LengthPrefixed) {
+            return next_prefixed(frame);
+        } else {
+            while (m_scanned < m_end) {
+                const auto found = static_cast<const char*>(memchr(m_buffer + m_scanned, DELIMITER, m_end - m_scanned));
+                if (found == nullptr) {
+                    m_scanned = m_end;
+                    break;
+                }
+
+                const auto end = static_cast<size_t>(found - m_buffer);
+                const auto start = m_start;
+                m_start = m_scanned = end + 1;
+                if (m_discarding) {
+                    m_discarding = false;
+                    continue;
+                }
+                if (decode(start, end, frame)) return true;
+            }
+            if (m_end - m_start == SIZE) overflow();
+            return false;
+        }
+    }
+
+    // Appends raw bytes, for input that arrives some other way (a DMA
+    // buffer, an ISR); returns how many fit.
+    size_t feed(const char* data, size_t size) {
+        compact();
+        if (size > SIZE - m_end) size = SIZE - m_end;
+        memcpy(m_buffer + m_end, data, size);
+        m_end += size;
+        return size;
+    }
+
+    // Reads what 'stream' has available into the free part of the buffer
+    // and returns the number of bytes read.
+    template <ReadableStreamType Stream>
+    size_t fill(Stream& stream) {
+        compact();
+        size_t space = SIZE - m_end;
+        const auto available = stream.available();
+        if (available <= 0 || space == 0) return 0;
+        if (static_cast<size_t>(available) < space) space = static_cast<size_t>(available);
+
+        if constexpr (BulkReadableStreamType<Stream>) {
+            const auto count = stream.read(reinterpret_cast<uint8_t*>(m_buffer + m_end), space);
+            m_end += count;
+            return count;
+        } else {
+            size_t count = 0;
+            for (; count < space; count++) {
+                const auto c = stream.read();
+                if (c < 0) break;
+                m_buffer[m_end + count] = static_cast<char>(c);
+            }
+            m_end += count;
+            return count;
+        }
+    }
+
+    // frames thrown away for being too long or malformed
+    size_t dropped() const { return m_dropped; }
+    // bytes waiting for the rest of their frame
+    size_t buffered() const { return m_end - m_start; }
+    static constexpr size_t capacity() { return SIZE; }
+
+    void reset() {
+        m_start = m_scanned = m_end = 0;
+        m_remaining_skip = 0;
+        m_discarding = false;
+    }
+
+private:
+    static constexpr char DELIMITER = FRAMING == Framing::Line ? '\n' : FRAMING == Framing::Cobs ? '\0' : static_cast<char>(0xC0);
+    static constexpr char SLIP_ESC = static_cast<char>(0xDB);
+    static constexpr char SLIP_ESC_END = static_cast<char>(0xDC);
+    static constexpr char SLIP_ESC_ESC = static_cast<char>(0xDD);
+
+    // moves the unread bytes to the front to make room at the back
+    void compact() {
+        if (m_start == 0) return;
+        memmove(m_buffer, m_buffer + m_start, m_end - m_start);
+        m_end -= m_start;
+        m_scanned = m_scanned > m_start ? m_scanned - m_start : 0;
+        m_start = 0;
+    }
+
+    // the buffer is full of one unfinished frame: drop it and skip ahead
+    // to the next delimiter
+    void overflow() {
+        if (!m_discarding) m_dropped++;
+        m_discarding = true;
+        m_start = m_scanned = m_end = 0;
+    }
+
+    bool decode(size_t start, size_t end, StringView& frame) {
+        char* data = m_buffer + start;
+        size_t length = end - start;
+
+        if constexpr (FRAMING == Framing::Line) {
+            if (length > 0 && data[length - 1] == '\r') length--;
+        } else if constexpr (FRAMING == Framing::Cobs) {
+            // a lone delimiter separates frames without being one
+            if (length == 0) return false;
+            size_t read = 0, written = 0;
+            while (read < length) {
+                const auto code = static_cast<uint8_t>(data[read++]);
+                if (code == 0 || read + code - 1 > length) {
+                    m_dropped++;
+                    return false;
+                }
+                for (uint8_t i = 1; i < code; i++) data[written++] = data[read++];
+                if (code != 0xFF && read < length) data[written++] = '\0';
+            }
+            length = written;
+        } else {
+            if (length == 0) return false;
+            size_t written = 0;
+            for (size_t read = 0; read < length; read++) {
+                char c = data[read];
+                if (c == SLIP_ESC && read + 1 < length) {
+                    c = data[++read];
+                    if (c == SLIP_ESC_END) c = DELIMITER;
+                    else if (c == SLIP_ESC_ESC) c = SLIP_ESC;
+                }
+                data[written++] = c;
+            }
+            length = written;
+        }
+
+        frame = StringView(data, length);
+        return true;
+    }
+
+    bool next_prefixed(StringView& frame) {
+        if (m_remaining_skip > 0) {
+            const auto skipped = m_end - m_start < m_remaining_skip ? m_end - m_start : m_remaining_skip;
+            m_remaining_skip -= skipped;
+            m_start += skipped;
+            if (m_remaining_skip > 0) return false;
+        }
+        if (m_end - m_start < 2) return false;
+
+        const size_t length = static_cast<size_t>(static_cast<uint8_t>(m_buffer[m_start])) << 8 | static_cast<uint8_t>(m_buffer[m_start + 1]);
+        if (length > SIZE - 2) {
+            m_dropped++;
+            m_start += 2;
+            m_remaining_skip = length;
+            return next_prefixed(frame);
+        }
+        if (m_end - m_start < 2 + length) return false;
+
+        frame = StringView(m_buffer + m_start + 2, length);
+        m_start += 2 + length;
+        return true;
+    }
+
+    char m_buffer[SIZE]{};
+    size_t m_start{0};   // first byte of the frame being assembled
+    size_t m_scanned{0}; // searched for delimiters up to here
+    size_t m_end{0};     // end of the buffered bytes
+    size_t m_dropped{0};
+    size_t m_remaining_skip{0};
+    bool m_discarding{false};
+};
@@ -1,11 +1,21 @@
 #pragma once
 #include "Arduino.h"
 #include "wiring_private.h"
+#include "Register.hpp"
 #include <array>
 #include <functional>
 
+REGISTER_TYPE(EICRA);
+REGISTER_TYPE(EIMSK);
+
 class Interrupt {
 public:
+    // ISCn1:ISCn0, two bits per interrupt, take the Arduino modes as they are
+    // (LOW, CHANGE, FALLING, RISING)
+    template <size_t InterruptNum>
+    using sense_control = register_field<EICRA_register, 2 * InterruptNum, 2>;
+    template <size_t InterruptNum>
+    using enable = register_field<EIMSK_register, InterruptNum>;
     
     static auto &ISRS() {
         // todo: is there a way that does not use type reflection that would
@@ -22,9 +32,8 @@ public:
 
         ISRS()[InterruptNum] = std::move(function);
 
-        const auto isc = uint8_t{1} << InterruptNum;
-        EICRA = static_cast<uint8_t>(EICRA & ~((1 << isc) | (1 << (isc + 1)))) | static_cast<uint8_t>(mode << (1 << isc));
-        EIMSK = EIMSK | static_cast<uint8_t>(1 << InterruptNum);
+        sense_control<InterruptNum>::write(mode);
+        enable<InterruptNum>::set();
     }
 
     template <size_t Index>
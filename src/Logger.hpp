@@ -2,22 +2,102 @@
 #define LOGGER_HPP
 
 #include <Arduino.h>
+#include <type_traits>
 #include <utility>
+#include "std/allocation_trace.hpp"
+#include "std/array.hpp"
+#include "std/stdlib.hpp"
+#include "std/StringView.hpp"
 
 #ifndef DEBUG
 constexpr bool DEBUG = false;
 #endif
 
 template <typename T> concept BasicStreamType = requires(T m) { m.print(""); }; // First parameter must be a type that can be printed to
-template <typename K> concept BasicPrintableType = requires(K m) { String(m); };
+
+namespace logging {
+
+template <typename T> struct is_array : std::false_type {};
+template <typename T, size_t SIZE> struct is_array<array<T, SIZE>> : std::true_type {};
+
+// Customization point: a print_to(stream, value) found by argument-dependent
+// lookup is how Logger prints a type, ahead of every built-in rule.
+//
+//   template <BasicStreamType S> void print_to(S& str, const Reading& r) {
+//       Logger::print(str, r.channel, '=', r.millivolts, "mV");
+//   }
+template <typename K, typename S> concept CustomPrintable = requires(S& str, const K& m) { print_to(str, m); };
+
+template <typename K, typename S> concept PrintableTo =
+    CustomPrintable<std::remove_cvref_t<K>, S> ||
+    std::is_arithmetic_v<std::remove_cvref_t<K>> ||
+    std::is_enum_v<std::remove_cvref_t<K>> ||
+    is_fixed_point<std::remove_cvref_t<K>>::value ||
+    std::is_same_v<std::remove_cvref_t<K>, StringView> ||
+    is_array<std::remove_cvref_t<K>>::value ||
+    requires(S& str, K m) { str.print(m); } ||
+    requires(K m) { String(m); };
+
+template <BasicStreamType S>
+void write(S& str, const char* data, size_t length) {
+    if constexpr (requires { str.write(reinterpret_cast<const uint8_t*>(data), length); }) {
+        str.write(reinterpret_cast<const uint8_t*>(data), length);
+    } else {
+        for (size_t i = 0; i < length; i++) str.print(data[i]);
+    }
+}
+
+// Numbers are formatted on the stack and written in one call; nothing here
+// builds a String.
+template <BasicStreamType S, typename K>
+void print_one(S& str, const K& value) {
+    if constexpr (CustomPrintable<K, S>) {
+        print_to(str, value);
+    } else if constexpr (std::is_same_v<K, char>) {
+        str.print(value);
+    } else if constexpr (std::is_same_v<K, bool>) {
+        str.print(value ? '1' : '0');
+    } else if constexpr (std::is_integral_v<K>) {
+        char digits[3 * sizeof(K) + 2];
+        if constexpr (std::is_signed_v<K>) itoa(value, digits);
+        else utoa(value, digits);
+        write(str, digits, strlen(digits));
+    } else if constexpr (std::is_enum_v<K>) {
+        print_one(str, static_cast<std::underlying_type_t<K>>(value));
+    } else if constexpr (std::is_floating_point_v<K>) {
+        char digits[ftoa_size(2)];
+        write(str, digits, strlen(ftoa(value, digits)));
+    } else if constexpr (is_fixed_point<K>::value) {
+        char digits[K::STRING_SIZE];
+        write(str, digits, strlen(fixtoa(value, digits)));
+    } else if constexpr (std::is_same_v<K, StringView>) {
+        write(str, value.data(), value.length());
+    } else if constexpr (is_array<K>::value) {
+        str.print('[');
+        for (size_t i = 0; i < value.size(); i++) {
+            if (i > 0) str.print(", ");
+            print_one(str, value[i]);
+        }
+        str.print(']');
+    } else if constexpr (requires { str.print(value); }) {
+        str.print(value);
+    } else {
+        str.print(String(value));
+    }
+}
+
+} // namespace logging
+
+template <typename K> concept BasicPrintableType = logging::PrintableTo<K, decltype(Serial)>;
 
 class Logger {
 public:
   Logger() = delete;
-  template <BasicStreamType stream, BasicPrintableType... Args>
+  template <BasicStreamType stream, typename... Args>
+    requires (logging::PrintableTo<Args, stream> && ...)
   static constexpr inline void print(stream &str, Args &&... args) {
     if constexpr (DEBUG) {
-      (str.print(std::forward<Args>(args)), ...);
+      (logging::print_one(str, args), ...);
     }
   }
 
@@ -25,6 +105,31 @@ public:
   static inline void log(Args &&... args) {
     print(Serial, args...);
   }
+
+  // Dumps the StringBase allocation counters (see std/allocation_trace.hpp).
+  // Tracing is opted into on its own, so this prints without DEBUG too.
+  template <BasicStreamType stream>
+  static inline void allocations(stream &str) {
+    if constexpr (TRACE_ALLOCATIONS) {
+      for (uint8_t i = 0; i < static_cast<uint8_t>(AllocationSite::Count); i++) {
+        const auto site = static_cast<AllocationSite>(i);
+        const auto &stats = AllocationTracer::site(site);
+        dump(str, AllocationTracer::name(site), ": ", stats.calls, " calls, ", stats.bytes, " bytes\n");
+      }
+      dump(str, "allocations: ", AllocationTracer::allocations(), ", frees: ", AllocationTracer::frees(),
+           ", current: ", AllocationTracer::current(), " bytes, peak: ", AllocationTracer::peak(), " bytes\n");
+    }
+  }
+
+  static inline void allocations() {
+    allocations(Serial);
+  }
+
+private:
+  template <BasicStreamType stream, typename... Args>
+  static inline void dump(stream &str, const Args &... args) {
+    (logging::print_one(str, args), ...);
+  }
 };
 
 #endif
@@ -0,0 +1,97 @@
+#pragma once
+// Named fields of memory-mapped registers. A field knows its register, its
+// offset and width, and the type of its values, so masks and shifts are
+// worked out at compile time and a value can't end up in the wrong register
+// or spill into the neighbouring bits:
+//
+//   REGISTER_TYPE(EICRA);
+//   using int0_sense = register_field<EICRA_register, 0, 2>;   // ISC01:ISC00
+//   using int1_sense = register_field<EICRA_register, 2, 2>;   // ISC11:ISC10
+//   int0_sense::write(FALLING);
+//   modify(int0_sense(FALLING) | int1_sense(RISING));          // both at once
+//
+// Every write is one read-modify-write of the register. With constant
+// values the masks fold away, and avr-gcc turns single-bit writes to the
+// low I/O space into sbi/cbi.
+#include <stdint.h>
+#include <concepts>
+#include <type_traits>
+
+// A register is a type with a value_type and a static get() returning a
+// reference to the volatile register, since the AVR register names are
+// macros for dereferenced addresses and can't be template arguments.
+template <typename R> concept RegisterType = requires {
+    typename R::value_type;
+    { R::get() } -> std::same_as<volatile typename R::value_type&>;
+};
+
+// Declares name##_register for a register of the Arduino core, e.g. EICRA_register
+#define REGISTER_TYPE(name)                                                              \
+    struct name##_register {                                                             \
+        using value_type = std::remove_cvref_t<decltype(name)>;                         \
+        static volatile value_type& get() { return name; }                             \
+    }
+
+// Bits to set within a mask of one register, from one or more fields
+template <RegisterType Register>
+struct register_value {
+    using value_type = typename Register::value_type;
+
+    value_type mask;
+    value_type bits;
+
+    // Fields of the same register combine into one write
+    friend constexpr register_value operator|(register_value a, register_value b) {
+        return {static_cast<value_type>(a.mask | b.mask), static_cast<value_type>((a.bits & ~b.mask) | b.bits)};
+    }
+};
+
+// Replaces the masked bits and leaves the rest of the register alone
+template <RegisterType Register>
+inline void modify(register_value<Register> value) {
+    auto& reg = Register::get();
+    reg = static_cast<typename Register::value_type>((reg & ~value.mask) | value.bits);
+}
+
+// Writes the whole register: the fields given, and zeros everywhere else
+template <RegisterType Register>
+inline void assign(register_value<Register> value) {
+    Register::get() = value.bits;
+}
+
+// WIDTH bits at bit OFFSET of Register holding a Value, which may be an enum
+template <RegisterType Register, uint8_t OFFSET, uint8_t WIDTH = 1, typename Value = typename Register::value_type>
+class register_field {
+    using word = typename Register::value_type;
+    static_assert(WIDTH > 0 && OFFSET + WIDTH <= 8 * sizeof(word), "register_field: the field doesn't fit the register");
+    static_assert(std::is_integral_v<Value> || std::is_enum_v<Value>, "register_field: values have to be integers or enums");
+
+public:
+    static constexpr word MASK = static_cast<word>((~uint64_t{0} >> (64 - WIDTH)) << OFFSET);
+
+    // The field's bits for 'value'; bits of 'value' above WIDTH are dropped
+    static constexpr word encode(Value value) {
+        return static_cast<word>((static_cast<uint64_t>(value) << OFFSET) & MASK);
+    }
+    static constexpr Value decode(word reg) {
+        return static_cast<Value>((reg & MASK) >> OFFSET);
+    }
+
+    // register_field(value) is the value to modify() or assign() with
+    constexpr explicit register_field(Value value) : m_bits(encode(value)) {}
+    constexpr operator register_value<Register>() const { return {MASK, m_bits}; }
+    template <std::convertible_to<register_value<Register>> Other>
+    friend constexpr register_value<Register> operator|(register_field field, Other other) {
+        return register_value<Register>(field) | register_value<Register>(other);
+    }
+
+    static Value read() { return decode(Register::get()); }
+    static void write(Value value) { modify<Register>(register_field(value)); }
+
+    static bool test() requires (WIDTH == 1) { return (Register::get() & MASK) != 0; }
+    static void set() requires (WIDTH == 1) { Register::get() = static_cast<word>(Register::get() | MASK); }
+    static void clear() requires (WIDTH == 1) { Register::get() = static_cast<word>(Register::get() & ~MASK); }
+
+private:
+    word m_bits;
+};
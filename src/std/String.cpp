@@ -1,5 +1,5 @@
 /*
-  WString.cpp - StringBase<CharType> library for Wiring & Arduino
+  WString.cpp - StringBase<CharType, Allocator> library for Wiring & Arduino
   ...mostly rewritten by Paul Stoffregen...
   Copyright (c) 2009-10 Hernando Barragan.  All rights reserved.
   Copyright 2011, Paul Stoffregen, paul@pjrc.com
@@ -15,58 +15,78 @@
   License along with this library; if not, write to the Free Software
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
+#ifndef String_implementation
+#define String_implementation
 #include "String.hpp"
+#include "allocation_trace.hpp"
+#include <new>
 #include <utility>
 
 #ifdef __AVR__
 #include <avr/pgmspace.h>
 #else
 #include <pgmspace.h>
+#include <stdlib_noniso.h> // dtostrf
 #endif
 
 /*********************************************/
 /*  Constructors                             */
 /*********************************************/
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(const CharType *cstr)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(const CharType *cstr)
 {
 	if (!cstr) {
         return;
     }
 
-    copy(cstr, strlen(cstr));
+    copy(cstr, traits::length(cstr));
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(const StringBase<CharType> &value)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(const StringBase<CharType, Allocator> &value)
+: m_buffer(SHARED ? nullptr : allocate(30)),
+  m_capacity(SHARED ? 0 : 30)
 {
 	*this = value;
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(const __FlashStringHelper *pstr)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(const __FlashStringHelper *pstr)
 {
 	*this = pstr;
 }
 
 #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-template<typename CharType> constexpr StringBase<CharType>::StringBase(StringBase<CharType> &&rval)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(StringBase<CharType, Allocator> &&rval)
+: m_buffer(SHARED ? nullptr : allocate(30)),
+  m_capacity(SHARED ? 0 : 30)
 {
-    // fixme: moving should avoid calloc-ing the m_buffer member
+    // fixme: moving should avoid allocating the m_buffer member
 	move(std::move(rval));
 }
 
 #endif
 
-template<typename CharType> constexpr void StringBase<CharType>::fill(CharType c, unsigned count)
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::fill(CharType c, unsigned count)
 {
-	if (reserve(count)) {
-        len = c;
-        memset(m_buffer, c, count);
+	if (reserveFor(count, AllocationSite::Copy)) {
+        len = count;
+        traits::assign(m_buffer, count, c);
+        m_buffer[len] = 0;
         return;
     }
     invalidate();
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(CharType c)
+template<typename CharType, AllocatorType Allocator> constexpr CharType* StringBase<CharType, Allocator>::extend(unsigned int count)
+{
+	if ((len + count > m_capacity || !owns()) && !reserveFor(len + count, AllocationSite::Concat)) return nullptr;
+	if (!makeUnique()) return nullptr;
+	CharType *start = m_buffer + len;
+	len += count;
+	m_buffer[len] = 0;
+	return start;
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(CharType c)
 {
 	CharType buf[2];
 	buf[0] = c;
@@ -74,82 +94,187 @@ template<typename CharType> constexpr StringBase<CharType>::StringBase(CharType
 	*this = buf;
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(unsigned char value, unsigned char base)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(unsigned char value, unsigned char base)
 {
-	CharType buf[1 + 8 * sizeof(unsigned char)];
+	char buf[1 + 8 * sizeof(unsigned char)];
 	utoa(value, buf, base);
-	*this = buf;
+	copyAscii(buf);
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(int value, unsigned char base)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(int value, unsigned char base)
 {
-	CharType buf[2 + 8 * sizeof(int)];
+	char buf[2 + 8 * sizeof(int)];
 	itoa(value, buf, base);
-	*this = buf;
+	copyAscii(buf);
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(unsigned int value, unsigned char base)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(unsigned int value, unsigned char base)
 {
-	CharType buf[1 + 8 * sizeof(unsigned int)];
+	char buf[1 + 8 * sizeof(unsigned int)];
 	utoa(value, buf, base);
-	*this = buf;
+	copyAscii(buf);
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(long value, unsigned char base)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(long value, unsigned char base)
 {
-	CharType buf[2 + 8 * sizeof(long)];
-	ltoa(value, buf, base);
-	*this = buf;
+	char buf[2 + 8 * sizeof(long)];
+	itoa(value, buf, base);
+	copyAscii(buf);
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(unsigned long value, unsigned char base)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(unsigned long value, unsigned char base)
 {
-	CharType buf[1 + 8 * sizeof(unsigned long)];
-	ultoa(value, buf, base);
-	*this = buf;
+	char buf[1 + 8 * sizeof(unsigned long)];
+	utoa(value, buf, base);
+	copyAscii(buf);
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(float value, unsigned char decimalPlaces)
+{
+	char buf[33];
+	copyAscii(dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf));
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(float value, unsigned char decimalPlaces)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator>::StringBase(double value, unsigned char decimalPlaces)
 {
-	CharType buf[33];
-	*this = dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf);
+	char buf[33];
+	copyAscii(dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf));
 }
 
-template<typename CharType> constexpr StringBase<CharType>::StringBase(double value, unsigned char decimalPlaces)
+template<typename CharType, AllocatorType Allocator>
+template<uint8_t DECIMALS, Int Rep> constexpr StringBase<CharType, Allocator>::StringBase(fixed_point<DECIMALS, Rep> value)
 {
-	CharType buf[33];
-	*this = dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf);
+	char buf[fixed_point<DECIMALS, Rep>::STRING_SIZE];
+	copyAscii(fixtoa(value, buf));
 }
 
-template<typename CharType> inline constexpr StringBase<CharType>::~StringBase()
+template<typename CharType, AllocatorType Allocator> inline constexpr StringBase<CharType, Allocator>::~StringBase()
 {
-	if (m_buffer) free(m_buffer);
+	if (m_buffer) release(AllocationSite::Destruct);
 }
 
 /*********************************************/
 /*  Memory Management                        */
 /*********************************************/
 
-template<typename CharType> constexpr void StringBase<CharType>::invalidate()
+template<typename CharType, AllocatorType Allocator> constexpr size_t StringBase<CharType, Allocator>::bytesFor(unsigned int capacity)
+{
+	if constexpr (SHARED) return sizeof(detail::SharedBuffer) + (capacity + 1) * sizeof(CharType);
+	return (capacity + 1) * sizeof(CharType);
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr CharType* StringBase<CharType, Allocator>::allocate(unsigned int capacity, AllocationSite site)
+{
+	void *memory = Allocator::allocate(bytesFor(capacity));
+	if (!memory) return nullptr;
+	if constexpr (TRACE_ALLOCATIONS) AllocationTracer::allocated(site, bytesFor(capacity));
+
+	CharType *buffer = static_cast<CharType *>(memory);
+	if constexpr (SHARED) {
+		auto *shared = new (memory) detail::SharedBuffer{1, capacity};
+		buffer = reinterpret_cast<CharType *>(shared + 1);
+	}
+	buffer[0] = 0;
+	return buffer;
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr auto StringBase<CharType, Allocator>::sharedBuffer(CharType *buffer) -> shared_type
+{
+	if constexpr (SHARED) return buffer ? reinterpret_cast<detail::SharedBuffer *>(buffer) - 1 : nullptr;
+	else return {};
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr bool StringBase<CharType, Allocator>::owns() const
+{
+	if constexpr (SHARED) return !m_buffer || (m_shared->refs == 1 && m_buffer == reinterpret_cast<CharType *>(m_shared + 1));
+	return true;
+}
+
+// Called before every write to the characters: a shared buffer is copied
+// first, and a slice that now owns its buffer is terminated.
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::makeUnique()
+{
+	if constexpr (SHARED) {
+		if (!m_buffer) return 1;
+		if (!owns()) return changeBuffer(len, AllocationSite::Unshare);
+		m_buffer[len] = 0;
+	}
+	return 1;
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::release(AllocationSite site)
 {
-	if (m_buffer) free(m_buffer);
+	if constexpr (SHARED) {
+		if (--m_shared->refs != 0) return;
+		if constexpr (TRACE_ALLOCATIONS) AllocationTracer::released(site, bytesFor(m_shared->capacity));
+		m_shared->~SharedBuffer();
+		Allocator::deallocate(m_shared);
+	} else {
+		if constexpr (TRACE_ALLOCATIONS) AllocationTracer::released(site, bytesFor(m_capacity));
+		Allocator::deallocate(m_buffer);
+	}
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::invalidate()
+{
+	if (m_buffer) release(AllocationSite::Invalidate);
 	m_buffer = nullptr;
+	m_shared = sharedBuffer(nullptr);
 	m_capacity = len = 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::reserve(unsigned int size)
+template<typename CharType, AllocatorType Allocator> inline constexpr unsigned char StringBase<CharType, Allocator>::reserve(unsigned int size)
+{
+	return reserveFor(size, AllocationSite::Reserve);
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::reserveFor(unsigned int size, AllocationSite site)
 {
-	if (m_buffer && m_capacity >= size) return 1;
-	if (changeBuffer(size)) {
+	if (m_buffer && m_capacity >= size && owns()) return 1;
+	if (changeBuffer(size, site)) {
 		if (len == 0) m_buffer[0] = 0;
 		return 1;
 	}
 	return 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::changeBuffer(unsigned int maxStrLen)
-{
-	if (auto *newbuffer = static_cast<CharType *>(realloc(m_buffer, maxStrLen + 1))) {
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::changeBuffer(unsigned int maxStrLen, AllocationSite site)
+{
+	if constexpr (SHARED) {
+		if (!owns()) {
+			// leave the shared buffer to the other strings
+			auto *fresh = allocate(maxStrLen, site);
+			if (!fresh) return 0;
+			if (len > maxStrLen) len = maxStrLen;
+			memcpy(fresh, m_buffer, len * sizeof(CharType));
+			fresh[len] = 0;
+			release(site);
+			m_buffer = fresh;
+			m_shared = sharedBuffer(fresh);
+			m_capacity = maxStrLen;
+			return 1;
+		}
+		void *block = m_buffer ? m_shared : nullptr;
+		const size_t old_size = m_buffer ? bytesFor(m_shared->capacity) : 0;
+		auto *resized = static_cast<detail::SharedBuffer *>(Allocator::reallocate(block, old_size, bytesFor(maxStrLen)));
+		if (!resized) return 0;
+		if constexpr (TRACE_ALLOCATIONS) {
+			if (block) AllocationTracer::resized(site, old_size, bytesFor(maxStrLen));
+			else AllocationTracer::allocated(site, bytesFor(maxStrLen));
+		}
+		if (!block) new (resized) detail::SharedBuffer{1, 0};
+		resized->capacity = maxStrLen;
+		m_shared = resized;
+		m_buffer = reinterpret_cast<CharType *>(resized + 1);
+		m_capacity = maxStrLen;
+		return 1;
+	}
+
+	if (auto *newbuffer = static_cast<CharType *>(Allocator::reallocate(m_buffer, bytesFor(m_capacity), bytesFor(maxStrLen)))) {
+		if constexpr (TRACE_ALLOCATIONS) {
+			if (m_buffer) AllocationTracer::resized(site, bytesFor(m_capacity), bytesFor(maxStrLen));
+			else AllocationTracer::allocated(site, bytesFor(maxStrLen));
+		}
 		m_buffer = newbuffer;
 		m_capacity = maxStrLen;
 		return 1;
@@ -162,49 +287,83 @@ template<typename CharType> constexpr unsigned char StringBase<CharType>::change
 /*********************************************/
 
 
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::copy(const CharType *cstr, unsigned int length)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::copy(const CharType *cstr, unsigned int length)
 {
-    if (length > m_capacity && !reserve(length)) {
+	if constexpr (SHARED) {
+		// 'cstr' may point into the buffer being let go of
+		if (!owns()) {
+			auto *fresh = allocate(length, AllocationSite::Copy);
+			if (fresh) memcpy(fresh, cstr, length * sizeof(CharType));
+			invalidate();
+			if (!fresh) return *this;
+			m_buffer = fresh;
+			m_shared = sharedBuffer(fresh);
+			m_capacity = len = length;
+			m_buffer[len] = 0;
+			return *this;
+		}
+	}
+	// m_buffer is null when the constructor couldn't allocate its 30 elements
+	if ((length > m_capacity || !m_buffer) && !reserveFor(length, AllocationSite::Copy)) {
 		invalidate();
 		return *this;
 	}
 	len = length;
-	strncpy(m_buffer, cstr, length + 1);
+	memmove(m_buffer, cstr, length * sizeof(CharType));
+	m_buffer[len] = 0;
 	return *this;
 }
 
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::copy(const __FlashStringHelper *pstr, unsigned int length)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::copy(const __FlashStringHelper *pstr, unsigned int length)
 {
-	if (length > m_capacity && !reserve(length)) {
+	if ((length > m_capacity || !owns()) && !reserveFor(length, AllocationSite::Copy)) {
 		invalidate();
 		return *this;
 	}
 	len = length;
-	strcpy_P(m_buffer, pstr);
+	if constexpr (sizeof(CharType) == 1) {
+		strcpy_P(m_buffer, (PGM_P)pstr);
+	} else {
+		for (unsigned int i = 0; i < length; i++) m_buffer[i] = pgm_read_byte((PGM_P)pstr + i);
+		m_buffer[len] = 0;
+	}
 	return *this;
 }
 
 #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-template<typename CharType> constexpr void StringBase<CharType>::move(StringBase<CharType> &&rhs)
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::move(StringBase<CharType, Allocator> &&rhs)
 {
-    if (m_buffer) {
-        free(m_buffer);
-    }
+    if (m_buffer) release(AllocationSite::Move);
 
     m_buffer = rhs.m_buffer;
+    m_shared = rhs.m_shared;
     len = rhs.len;
     m_capacity = rhs.m_capacity;
 
 	rhs.m_buffer = nullptr;
+	rhs.m_shared = sharedBuffer(nullptr);
 	rhs.m_capacity = 0;
 	rhs.len = 0;
 }
 #endif
 
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::operator = (const StringBase<CharType> &rhs)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::operator = (const StringBase<CharType, Allocator> &rhs)
 {
 	if (this == &rhs) return *this;
 
+	if constexpr (SHARED) {
+		if (rhs.m_buffer) {
+			rhs.m_shared->refs++;
+			if constexpr (TRACE_ALLOCATIONS) AllocationTracer::shared(AllocationSite::Share);
+			if (m_buffer) release(AllocationSite::Move);
+			m_buffer = rhs.m_buffer;
+			m_shared = rhs.m_shared;
+			len = rhs.len;
+			m_capacity = rhs.m_capacity;
+			return *this;
+		}
+	}
+
 	if (rhs.m_buffer) copy(rhs.m_buffer, rhs.len);
 	else invalidate();
 
@@ -212,22 +371,22 @@ template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType
 }
 
 #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::operator = (StringBase<CharType> &&rval)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::operator = (StringBase<CharType, Allocator> &&rval)
 {
-	if (this != &rval) move(rval);
+	if (this != &rval) move(std::move(rval));
 	return *this;
 }
 #endif
 
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::operator = (const CharType *cstr)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::operator = (const CharType *cstr)
 {
-	if (cstr != nullptr) copy(cstr, strlen(cstr));
+	if (cstr != nullptr) copy(cstr, traits::length(cstr));
 	else invalidate();
 
 	return *this;
 }
 
-template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType>::operator = (const __FlashStringHelper *pstr)
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> & StringBase<CharType, Allocator>::operator = (const __FlashStringHelper *pstr)
 {
 	if (pstr) copy(pstr, strlen_P((PGM_P)pstr));
 	else invalidate();
@@ -239,28 +398,34 @@ template<typename CharType> constexpr StringBase<CharType> & StringBase<CharType
 /*  concat                                   */
 /*********************************************/
 
-template<typename CharType> inline constexpr unsigned char StringBase<CharType>::concat(const StringBase<CharType> &s)
+template<typename CharType, AllocatorType Allocator> inline constexpr unsigned char StringBase<CharType, Allocator>::concat(const StringBase<CharType, Allocator> &s)
 {
 	return concat(s.m_buffer, s.len);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(const CharType *cstr, unsigned int length)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(const CharType *cstr, unsigned int length)
 {
 	unsigned int newlen = len + length;
 	if (!cstr) return 0;
 	if (length == 0) return 1;
-	if (newlen > m_capacity && !reserve(newlen)) return 0;
-	strncpy(m_buffer + len, cstr, length + 1);
+	// 'cstr' may be this string's own characters, e.g. s.concat(s), which
+	// reserveFor() moves to a new buffer before freeing the old one
+	bool own = !std::is_constant_evaluated() && m_buffer && cstr >= m_buffer && cstr <= m_buffer + len;
+	const auto offset = own ? cstr - m_buffer : 0;
+	if ((newlen > m_capacity || !owns()) && !reserveFor(newlen, AllocationSite::Concat)) return 0;
+	if (own) cstr = m_buffer + offset;
+	memcpy(m_buffer + len, cstr, length * sizeof(CharType));
 	len = newlen;
+	m_buffer[len] = 0;
 	return 1;
 }
 
-template<typename CharType> inline constexpr unsigned char StringBase<CharType>::concat(const CharType *cstr)
+template<typename CharType, AllocatorType Allocator> inline constexpr unsigned char StringBase<CharType, Allocator>::concat(const CharType *cstr)
 {
-    return cstr ? concat(cstr, strlen(cstr)) : 0;
+    return cstr ? concat(cstr, traits::length(cstr)) : 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(CharType c)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(CharType c)
 {
 	CharType buf[2];
 	buf[0] = c;
@@ -268,172 +433,212 @@ template<typename CharType> constexpr unsigned char StringBase<CharType>::concat
 	return concat(buf, 1);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(unsigned char num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(unsigned char num)
 {
-	CharType buf[1 + 3 * sizeof(unsigned char)];
+	char buf[1 + 3 * sizeof(unsigned char)];
 	utoa(num, buf, 10);
-	return concat(buf, strlen(buf));
+	return concatAscii(buf);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(int num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(int num)
 {
-	CharType buf[2 + 3 * sizeof(int)];
+	char buf[2 + 3 * sizeof(int)];
 	itoa(num, buf, 10);
-	return concat(buf, strlen(buf));
+	return concatAscii(buf);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(unsigned int num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(unsigned int num)
 {
-	CharType buf[1 + 3 * sizeof(unsigned int)];
+	char buf[1 + 3 * sizeof(unsigned int)];
 	utoa(num, buf, 10);
-	return concat(buf, strlen(buf));
+	return concatAscii(buf);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(long num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(long num)
 {
-	CharType buf[2 + 3 * sizeof(long)];
-	ltoa(num, buf, 10);
-	return concat(buf, strlen(buf));
+	char buf[2 + 3 * sizeof(long)];
+	itoa(num, buf, 10);
+	return concatAscii(buf);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(unsigned long num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(unsigned long num)
 {
-	CharType buf[1 + 3 * sizeof(unsigned long)];
-	ultoa(num, buf, 10);
-	return concat(buf, strlen(buf));
+	char buf[1 + 3 * sizeof(unsigned long)];
+	utoa(num, buf, 10);
+	return concatAscii(buf);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(float num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(float num)
 {
-	CharType buf[20];
-	CharType* string = dtostrf(num, 4, 2, buf);
-	return concat(string, strlen(string));
+	char buf[20];
+	return concatAscii(dtostrf(num, 4, 2, buf));
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(double num)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(double num)
 {
-	CharType buf[20];
-	CharType* string = dtostrf(num, 4, 2, buf);
-	return concat(string, strlen(string));
+	char buf[20];
+	return concatAscii(dtostrf(num, 4, 2, buf));
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::concat(const __FlashStringHelper * str)
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concat(const __FlashStringHelper * str)
 {
 	if (!str) return 0;
-	int length = strlen_P((const CharType *) str);
+	unsigned int length = strlen_P((PGM_P) str);
 	if (length == 0) return 1;
 	unsigned int newlen = len + length;
-	if (newlen > len && !reserve(newlen)) return 0;
-	strcpy_P(m_buffer + len, (const CharType *) str);
+	if ((newlen > m_capacity || !owns()) && !reserveFor(newlen, AllocationSite::Concat)) return 0;
+	if constexpr (sizeof(CharType) == 1) {
+		strcpy_P(m_buffer + len, (PGM_P) str);
+	} else {
+		for (unsigned int i = 0; i < length; i++) m_buffer[len + i] = pgm_read_byte((PGM_P) str + i);
+		m_buffer[newlen] = 0;
+	}
 	len = newlen;
 	return 1;
 }
 
+template<typename CharType, AllocatorType Allocator>
+template<uint8_t DECIMALS, Int Rep> constexpr unsigned char StringBase<CharType, Allocator>::concat(fixed_point<DECIMALS, Rep> num)
+{
+	char buf[fixed_point<DECIMALS, Rep>::STRING_SIZE];
+	return concatAscii(fixtoa(num, buf));
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::copyAscii(const char *str)
+{
+	if constexpr (sizeof(CharType) == 1) {
+		copy(str, strlen(str));
+	} else {
+		erase();
+		if (!concatAscii(str)) invalidate();
+	}
+}
+
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::concatAscii(const char *str)
+{
+	if constexpr (sizeof(CharType) == 1) {
+		return concat(str, strlen(str));
+	} else {
+		const unsigned int length = strlen(str);
+		if (!reserveFor(len + length, AllocationSite::Concat)) return 0;
+		for (unsigned int i = 0; i < length; i++) m_buffer[len + i] = static_cast<unsigned char>(str[i]);
+		len += length;
+		m_buffer[len] = 0;
+		return 1;
+	}
+}
+
 /*********************************************/
 /*  Comparison                               */
 /*********************************************/
 
-template<typename CharType> constexpr int StringBase<CharType>::compareTo(const StringBase<CharType> &s) const
+template<typename CharType, AllocatorType Allocator> constexpr int StringBase<CharType, Allocator>::compareTo(const StringBase<CharType, Allocator> &s) const
 {
 	if (!m_buffer || !s.m_buffer) {
-		if (s.m_buffer && s.len > 0) return 0 - *(unsigned char *)s.m_buffer;
-		if (m_buffer && len > 0) return *(unsigned char *)m_buffer;
+		if (s.m_buffer && s.len > 0) return 0 - static_cast<int>(traits::to_int(s.m_buffer[0]));
+		if (m_buffer && len > 0) return static_cast<int>(traits::to_int(m_buffer[0]));
 		return 0;
 	}
-	return strcmp(m_buffer, s.m_buffer);
+	// bounded by the lengths, so copy_on_write slices compare in place
+	const unsigned int common = len < s.len ? len : s.len;
+	if (const int order = traits::compare(m_buffer, s.m_buffer, common)) return order;
+	if (len == s.len) return 0;
+	return len < s.len ? 0 - static_cast<int>(traits::to_int(s.m_buffer[common])) : static_cast<int>(traits::to_int(m_buffer[common]));
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::equals(const StringBase<CharType> &s2) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::equals(const StringBase<CharType, Allocator> &s2) const
 {
 	return (len == s2.len && compareTo(s2) == 0);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::equals(const CharType *cstr) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::equals(const CharType *cstr) const
 {
 	if (len == 0) return (cstr == nullptr || *cstr == 0);
 	if (cstr == nullptr) return m_buffer[0] == 0;
-	return strcmp(m_buffer, cstr) == 0;
+	// stops at the terminator of 'cstr', which may be shorter
+	for (unsigned int i = 0; i < len; i++) {
+		if (cstr[i] != m_buffer[i] || cstr[i] == 0) return 0;
+	}
+	return cstr[len] == 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::operator<(const StringBase<CharType> &rhs) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::operator<(const StringBase<CharType, Allocator> &rhs) const
 {
 	return compareTo(rhs) < 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::operator>(const StringBase<CharType> &rhs) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::operator>(const StringBase<CharType, Allocator> &rhs) const
 {
 	return compareTo(rhs) > 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::operator<=(const StringBase<CharType> &rhs) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::operator<=(const StringBase<CharType, Allocator> &rhs) const
 {
 	return compareTo(rhs) <= 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::operator>=(const StringBase<CharType> &rhs) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::operator>=(const StringBase<CharType, Allocator> &rhs) const
 {
 	return compareTo(rhs) >= 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::equalsIgnoreCase( const StringBase<CharType> &s2 ) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::equalsIgnoreCase( const StringBase<CharType, Allocator> &s2 ) const
 {
 	if (this == &s2) return 1;
 	if (len != s2.len) return 0;
 	if (len == 0) return 1;
-	const CharType *p1 = m_buffer;
-	const CharType *p2 = s2.m_buffer;
-	while (*p1) {
-		if (tolower(*p1++) != tolower(*p2++)) return 0;
+	for (unsigned int i = 0; i < len; i++) {
+		if (traits::to_lower(m_buffer[i]) != traits::to_lower(s2.m_buffer[i])) return 0;
 	}
 	return 1;
 }
 
-template<typename CharType> inline constexpr unsigned char StringBase<CharType>::startsWith( const StringBase<CharType> &s2 ) const
+template<typename CharType, AllocatorType Allocator> inline constexpr unsigned char StringBase<CharType, Allocator>::startsWith( const StringBase<CharType, Allocator> &s2 ) const
 {
 	return len < s2.len ? 0 : startsWith(s2, 0);
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::startsWith( const StringBase<CharType> &s2, unsigned int offset ) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::startsWith( const StringBase<CharType, Allocator> &s2, unsigned int offset ) const
 {
 	if (offset > len - s2.len || !m_buffer || !s2.m_buffer) return 0;
-	return strncmp( &m_buffer[offset], s2.m_buffer, s2.len ) == 0;
+	return traits::compare(&m_buffer[offset], s2.m_buffer, s2.len) == 0;
 }
 
-template<typename CharType> constexpr unsigned char StringBase<CharType>::endsWith( const StringBase<CharType> &s2 ) const
+template<typename CharType, AllocatorType Allocator> constexpr unsigned char StringBase<CharType, Allocator>::endsWith( const StringBase<CharType, Allocator> &s2 ) const
 {
 	if ( len < s2.len || !m_buffer || !s2.m_buffer) return 0;
-	return strcmp(&m_buffer[len - s2.len], s2.m_buffer) == 0;
+	return traits::compare(&m_buffer[len - s2.len], s2.m_buffer, s2.len) == 0;
 }
 
 /*********************************************/
 /*  Character Access                         */
 /*********************************************/
 
-template<typename CharType> inline constexpr CharType StringBase<CharType>::charAt(unsigned int loc) const
+template<typename CharType, AllocatorType Allocator> inline constexpr CharType StringBase<CharType, Allocator>::charAt(unsigned int loc) const
 {
 	return operator[](loc);
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::setCharAt(unsigned int loc, CharType c)
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::setCharAt(unsigned int loc, CharType c)
 {
-	if (loc < len) m_buffer[loc] = c;
+	if (loc < len && makeUnique()) m_buffer[loc] = c;
 }
 
-template<typename CharType> constexpr CharType & StringBase<CharType>::operator[](unsigned int index)
+template<typename CharType, AllocatorType Allocator> constexpr CharType & StringBase<CharType, Allocator>::operator[](unsigned int index)
 {
-	if (index >= len || !m_buffer) {
+	if (index >= len || !m_buffer || !makeUnique()) {
         dummy_char = 0;
 		return dummy_char;
 	}
 	return m_buffer[index];
 }
 
-template<typename CharType> constexpr CharType StringBase<CharType>::operator[]( unsigned int index ) const
+template<typename CharType, AllocatorType Allocator> constexpr CharType StringBase<CharType, Allocator>::operator[]( unsigned int index ) const
 {
 	return index >= len || !m_buffer ? 0 : m_buffer[index];
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::toCharArray(char *buf, unsigned int bufsize, unsigned int index) const {
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::toCharArray(CharType *buf, unsigned int bufsize, unsigned int index) const {
     if (!bufsize || !buf) return;
 	if (index >= len) {
 		buf[0] = 0;
@@ -441,102 +646,111 @@ template<typename CharType> constexpr void StringBase<CharType>::toCharArray(cha
 	}
 	unsigned int n = bufsize - 1;
 	if (n > len - index) n = len - index;
-	strncpy(buf, m_buffer + index, n);
+	memcpy(buf, m_buffer + index, n * sizeof(CharType));
 	buf[n] = 0;
 }
 
-template<typename CharType> inline constexpr void StringBase<CharType>::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+template<typename CharType, AllocatorType Allocator> inline constexpr void StringBase<CharType, Allocator>::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
 {
-	return toCharArray(static_cast<char*>(static_cast<void*>(buf)), bufsize, index);
+	// whole elements only, as many as fit in 'bufsize' bytes with the terminator
+	return toCharArray(static_cast<CharType*>(static_cast<void*>(buf)), bufsize / sizeof(CharType), index);
 }
 
 /*********************************************/
 /*  Search                                   */
 /*********************************************/
-template<typename CharType> inline constexpr bool StringBase<CharType>::contains(CharType c) const
+template<typename CharType, AllocatorType Allocator> inline constexpr bool StringBase<CharType, Allocator>::contains(CharType c) const
 {
 	return indexOf(c, 0) != -1;
 }
 
-template<typename CharType> inline constexpr bool StringBase<CharType>::contains(const CharType* c) const
+template<typename CharType, AllocatorType Allocator> inline constexpr bool StringBase<CharType, Allocator>::contains(const CharType* c) const
 {
 	return indexOf(c, 0) != -1;
 }
 
-template<typename CharType> inline constexpr bool StringBase<CharType>::contains(const StringBase<CharType> &str) const
+template<typename CharType, AllocatorType Allocator> inline constexpr bool StringBase<CharType, Allocator>::contains(const StringBase<CharType, Allocator> &str) const
 {
 	return indexOf(str, 0) != -1;
 }
 
-template<typename CharType> constexpr int StringBase<CharType>::indexOf(CharType ch, unsigned int fromIndex) const
+template<typename CharType, AllocatorType Allocator> constexpr int StringBase<CharType, Allocator>::indexOf(CharType ch, unsigned int fromIndex) const
 {
 	if (fromIndex >= len) return -1;
-	const CharType* temp = strchr(m_buffer + fromIndex, ch);
+	const CharType *temp = traits::find(m_buffer + fromIndex, len - fromIndex, ch);
 	if (temp == nullptr) return -1;
 	return temp - m_buffer;
 }
 
-template<typename CharType> constexpr int StringBase<CharType>::indexOf(const CharType* c, unsigned int fromIndex) const
+template<typename CharType, AllocatorType Allocator> constexpr int StringBase<CharType, Allocator>::indexOf(const CharType* c, unsigned int fromIndex) const
 {
 	if (fromIndex >= len) return -1;
-	const CharType *found = strstr(m_buffer + fromIndex, m_buffer);
+	if (!c) return -1;
+	const CharType *found = traits::search(m_buffer + fromIndex, len - fromIndex, c, traits::length(c));
 	if (found == nullptr) return -1;
 	return found - m_buffer;
 }
 
-template<typename CharType> inline constexpr int StringBase<CharType>::indexOf(const StringBase<CharType> &s2, unsigned int fromIndex) const
+template<typename CharType, AllocatorType Allocator> inline constexpr int StringBase<CharType, Allocator>::indexOf(const StringBase<CharType, Allocator> &s2, unsigned int fromIndex) const
 {
-	return indexOf(s2.m_buffer, fromIndex);
+	if (fromIndex >= len || !s2.m_buffer) return -1;
+	const CharType *found = traits::search(m_buffer + fromIndex, len - fromIndex, s2.m_buffer, s2.len);
+	if (found == nullptr) return -1;
+	return found - m_buffer;
 }
 
-template<typename CharType> inline constexpr int StringBase<CharType>::lastIndexOf( CharType theChar ) const
+template<typename CharType, AllocatorType Allocator> inline constexpr int StringBase<CharType, Allocator>::lastIndexOf( CharType theChar ) const
 {
 	return lastIndexOf(theChar, len - 1);
 }
 
-template<typename CharType> constexpr int StringBase<CharType>::lastIndexOf(CharType ch, unsigned int fromIndex) const
+template<typename CharType, AllocatorType Allocator> constexpr int StringBase<CharType, Allocator>::lastIndexOf(CharType ch, unsigned int fromIndex) const
 {
 	if (fromIndex >= len) return -1;
-	CharType tempchar = m_buffer[fromIndex + 1];
-	m_buffer[fromIndex + 1] = '\0';
-	CharType* temp = strrchr( m_buffer, ch );
-	m_buffer[fromIndex + 1] = tempchar;
-	if (temp == nullptr) return -1;
-	return temp - m_buffer;
+	for (int i = fromIndex; i >= 0; i--) {
+		if (m_buffer[i] == ch) return i;
+	}
+	return -1;
 }
 
-template<typename CharType> inline constexpr int StringBase<CharType>::lastIndexOf(const StringBase<CharType> &s2) const
+template<typename CharType, AllocatorType Allocator> inline constexpr int StringBase<CharType, Allocator>::lastIndexOf(const StringBase<CharType, Allocator> &s2) const
 {
 	return lastIndexOf(s2, len - s2.len);
 }
 
-template<typename CharType> constexpr int StringBase<CharType>::lastIndexOf(const StringBase<CharType> &s2, unsigned int fromIndex) const
+template<typename CharType, AllocatorType Allocator> constexpr int StringBase<CharType, Allocator>::lastIndexOf(const StringBase<CharType, Allocator> &s2, unsigned int fromIndex) const
 {
   	if (s2.len == 0 || len == 0 || s2.len > len) return -1;
 	if (fromIndex >= len) fromIndex = len - 1;
 	int found = -1;
-	for (CharType *p = m_buffer; p <= m_buffer + fromIndex; p++) {
-		p = strstr(p, s2.m_buffer);
+	for (const CharType *p = m_buffer; p <= m_buffer + fromIndex; p++) {
+		p = traits::search(p, m_buffer + len - p, s2.m_buffer, s2.len);
 		if (!p) break;
 		if ((unsigned int)(p - m_buffer) <= fromIndex) found = p - m_buffer;
 	}
 	return found;
 }
 
-template<typename CharType> constexpr StringBase<CharType> StringBase<CharType>::subString(unsigned int left, unsigned int right) const
+template<typename CharType, AllocatorType Allocator> constexpr StringBase<CharType, Allocator> StringBase<CharType, Allocator>::subString(unsigned int left, unsigned int right) const
 {
 	if (left > right) {
 		unsigned int temp = right;
 		right = left;
 		left = temp;
 	}
-	StringBase<CharType> out;
-	if (left >= len) return out;
 	if (right > len) right = len;
-	CharType temp = m_buffer[right];  // save the replaced character
-	m_buffer[right] = '\0';
-	out = m_buffer + left;  // pointer arithmetic
-	m_buffer[right] = temp;  //restore character
+	if constexpr (SHARED) {
+		// a slice of the same buffer
+		if (left < len) {
+			StringBase<CharType, Allocator> out(*this);
+			out.m_buffer += left;
+			out.len = out.m_capacity = right - left;
+			return out;
+		}
+	}
+	StringBase<CharType, Allocator> out;
+	if (left >= len) return out;
+	out.copy(m_buffer + left, right - left);
 	return out;
 }
 
@@ -544,131 +758,176 @@ template<typename CharType> constexpr StringBase<CharType> StringBase<CharType>:
 /*  Modification                             */
 /*********************************************/
 
-template<typename CharType> constexpr void StringBase<CharType>::replace(CharType find, CharType replace)
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::replace(CharType find, CharType replace)
 {
-	if (!m_buffer) return;
+	if (!m_buffer || !makeUnique()) return;
 
     for (auto& p : *this) {
         if (p == find) p = replace;
     }
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::replace(const StringBase<CharType>& find, const StringBase<CharType>& replace)
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::replace(const StringBase<CharType, Allocator>& find, const StringBase<CharType, Allocator>& replace)
 {
-	if (len == 0 || find.len == 0) return;
+	if (len == 0 || find.len == 0 || !makeUnique()) return;
 	int diff = replace.len - find.len;
 	CharType *readFrom = m_buffer;
 	CharType *foundAt;
+	// bounded by the length, as 'find' may be an unterminated slice
+	CharType *const end = m_buffer + len;
+	auto next = [&] { return const_cast<CharType *>(traits::search(readFrom, end - readFrom, find.m_buffer, find.len)); };
 	if (diff == 0) {
-		while ((foundAt = strstr(readFrom, find.m_buffer)) != nullptr) {
-			memcpy(foundAt, replace.m_buffer, replace.len);
+		while ((foundAt = next()) != nullptr) {
+			memcpy(foundAt, replace.m_buffer, replace.len * sizeof(CharType));
 			readFrom = foundAt + replace.len;
 		}
 	} else if (diff < 0) {
 		CharType *writeTo = m_buffer;
-		while ((foundAt = strstr(readFrom, find.m_buffer)) != nullptr) {
+		while ((foundAt = next()) != nullptr) {
 			unsigned int n = foundAt - readFrom;
-			memcpy(writeTo, readFrom, n);
+			memmove(writeTo, readFrom, n * sizeof(CharType));
 			writeTo += n;
-			memcpy(writeTo, replace.m_buffer, replace.len);
+			memcpy(writeTo, replace.m_buffer, replace.len * sizeof(CharType));
 			writeTo += replace.len;
 			readFrom = foundAt + find.len;
 			len += diff;
 		}
-		strcpy(writeTo, readFrom);
+		memmove(writeTo, readFrom, (end - readFrom) * sizeof(CharType));
+		m_buffer[len] = 0;
 	} else {
 		unsigned int size = len; // compute size needed for result
-		while ((foundAt = strstr(readFrom, find.m_buffer)) != nullptr) {
+		while ((foundAt = next()) != nullptr) {
 			readFrom = foundAt + find.len;
 			size += diff;
 		}
 		if (size == len) return;
-		if (size > m_capacity && !changeBuffer(size)) return; // XXX: tell user!
+		if (size > m_capacity && !changeBuffer(size, AllocationSite::Replace)) return; // XXX: tell user!
 		int index = len - 1;
 		while (index >= 0 && (index = lastIndexOf(find, index)) >= 0) {
 			readFrom = m_buffer + index + find.len;
-			memmove(readFrom + diff, readFrom, len - (readFrom - m_buffer));
+			memmove(readFrom + diff, readFrom, (len - (readFrom - m_buffer)) * sizeof(CharType));
 			len += diff;
 			m_buffer[len] = 0;
-			memcpy(m_buffer + index, replace.m_buffer, replace.len);
+			memcpy(m_buffer + index, replace.m_buffer, replace.len * sizeof(CharType));
 			index--;
 		}
 	}
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::remove(unsigned int index){
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::remove(unsigned int index){
 	// Pass the biggest integer as the count. The remove method
 	// below will take care of truncating it at the end of the
 	// string.
 	remove(index, (unsigned int)-1);
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::remove(unsigned int index, unsigned int count){
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::remove(unsigned int index, unsigned int count){
 	if (index >= len) { return; }
 	if (count <= 0) { return; }
 	if (count > len - index) { count = len - index; }
+	if (!makeUnique()) { return; }
 	CharType *writeTo = m_buffer + index;
 	len = len - count;
-	strncpy(writeTo, m_buffer + index + count,len - index);
+	memmove(writeTo, m_buffer + index + count, (len - index) * sizeof(CharType));
 	m_buffer[len] = 0;
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::toLowerCase()
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::toLowerCase()
 {
 	if (!m_buffer) return;
 	for (auto& p : *this) {
-        p = tolower(p);
+        p = traits::to_lower(p);
     }
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::toUpperCase()
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::toUpperCase()
 {
 	if (!m_buffer) return;
     for (auto& p : *this) {
-        p = toupper(p);
+        p = traits::to_upper(p);
     }
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::trim()
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::trim()
 {
-	if (!m_buffer || len == 0) return;
+	if (!m_buffer || len == 0 || !makeUnique()) return;
 	CharType *begin = m_buffer;
-	while (isspace(*begin)) begin++;
+	// ASCII white space only, so the bytes of a UTF-8 sequence are never
+	// taken for it (see utf8::trim() for the rest of Unicode)
+	auto space = [](CharType c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+	while (begin < m_buffer + len && space(*begin)) begin++;
 	CharType *end = m_buffer + len - 1;
-	while (isspace(*end) && end >= begin) end--;
+	while (end >= begin && space(*end)) end--;
 	len = end + 1 - begin;
-	if (begin > m_buffer) memcpy(m_buffer, begin, len);
+	if (begin > m_buffer) memmove(m_buffer, begin, len * sizeof(CharType));
 	m_buffer[len] = 0;
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::erase() {
-    if (!m_buffer || len == 0) return;
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::erase() {
+    if (!m_buffer || len == 0 || !makeUnique()) return;
     m_buffer[0] = '\0';
     len = 0;
 }
 
-template<typename CharType> constexpr void StringBase<CharType>::reset() {
+template<typename CharType, AllocatorType Allocator> constexpr void StringBase<CharType, Allocator>::reset() {
     erase();
-    changeBuffer(30); // 30 since it will add 1 for the terminator
+    changeBuffer(30, AllocationSite::Reserve); // 30 since it will add 1 for the terminator
 }
 
 /*********************************************/
 /*  Parsing / Conversion                     */
 /*********************************************/
 
-template<typename CharType> inline constexpr long StringBase<CharType>::toInt() const
+// The ASCII prefix of the string, for atol()/atof() on wide strings
+template<typename CharType, AllocatorType Allocator> constexpr const char* StringBase<CharType, Allocator>::narrowed(char *out, unsigned int size) const
 {
-	if (m_buffer) return atol(m_buffer);
-	return 0;
+	unsigned int n = 0;
+	for (; n + 1 < size && n < len && traits::to_int(m_buffer[n]) < 0x80; n++) out[n] = static_cast<char>(m_buffer[n]);
+	out[n] = 0;
+	return out;
 }
 
-template<typename CharType> inline constexpr float StringBase<CharType>::toFloat() const
+template<typename CharType, AllocatorType Allocator> inline constexpr long StringBase<CharType, Allocator>::toInt() const
+{
+	if (!m_buffer) return 0;
+	if constexpr (sizeof(CharType) == 1) {
+		if (const char *str = c_str()) return atol(str);
+	}
+	// wide strings, and slices without a terminator
+	char digits[24];
+	return atol(narrowed(digits, sizeof(digits)));
+}
+
+template<typename CharType, AllocatorType Allocator> inline constexpr float StringBase<CharType, Allocator>::toFloat() const
 {
 	return float(toDouble());
 }
 
-template<typename CharType> inline constexpr double StringBase<CharType>::toDouble() const
+template<typename CharType, AllocatorType Allocator> inline constexpr double StringBase<CharType, Allocator>::toDouble() const
 {
-	if (m_buffer) return atof(m_buffer);
-	return 0;
+	if (!m_buffer) return 0;
+	if constexpr (sizeof(CharType) == 1) {
+		if (const char *str = c_str()) return atof(str);
+	}
+	char digits[48];
+	return atof(narrowed(digits, sizeof(digits)));
 }
+
+template<typename CharType, AllocatorType Allocator>
+template<uint8_t DECIMALS, Int Rep> constexpr fixed_point<DECIMALS, Rep> StringBase<CharType, Allocator>::toFixed() const
+{
+	fixed_point<DECIMALS, Rep> value;
+	if (!m_buffer) return value;
+	if constexpr (sizeof(CharType) == 1) {
+		fixed_point<DECIMALS, Rep>::parse(m_buffer, len, value);
+	} else {
+		char digits[fixed_point<DECIMALS, Rep>::STRING_SIZE + 8];
+		if (len < sizeof(digits)) {
+			narrowed(digits, sizeof(digits));
+			fixed_point<DECIMALS, Rep>::parse(digits, value);
+		}
+	}
+	return value;
+}
+
+#endif // String_implementation
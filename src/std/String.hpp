@@ -23,6 +23,27 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <type_traits>
+#include "allocation_trace.hpp"
+#include "allocator.hpp"
+#include "char_traits.hpp"
+#include "fixed_point.hpp"
+#include "stdlib.hpp"
+
+// Reference counts of copy_on_write strings are atomic where strings can be
+// shared between cores or threads; on single-core parts a plain counter is
+// enough as long as strings aren't shared with interrupt handlers.
+#ifndef STRING_ATOMIC_REFCOUNT
+#if defined(__AVR__) || defined(ESP8266)
+#define STRING_ATOMIC_REFCOUNT 0
+#else
+#define STRING_ATOMIC_REFCOUNT 1
+#endif
+#endif
+
+#if STRING_ATOMIC_REFCOUNT
+#include <atomic>
+#endif
 //#include <avr/pgmspace.h>
 
 // When compiling programs with this class, the following gcc parameters
@@ -31,13 +52,33 @@
 //     -felide-constructors
 //     -std=c++0x
 
+namespace detail {
+
+// Sits in front of the characters of a copy_on_write string's buffer
+struct SharedBuffer {
+#if STRING_ATOMIC_REFCOUNT
+	std::atomic<unsigned int> refs;
+#else
+	unsigned int refs;
+#endif
+	unsigned int capacity; // not counting the terminator
+};
+
+} // namespace detail
+
 class __FlashStringHelper;
 #define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
 
 // An inherited class for holding the result of a concatenation.  These
 // result objects are assumed to be writable by subsequent concatenations.
 // The String class
-template<typename CharType>
+// CharType is char, char16_t or char32_t (see char_traits.hpp); lengths and
+// indexes count elements, not bytes.
+// All of the string's memory goes through 'Allocator' (see allocator.hpp), so
+// strings can be backed by an arena or a fixed-block pool instead of the heap.
+// With copy_on_write<Allocator>, copies and subString() are O(1): they share
+// the buffer until one of them is modified.
+template<typename CharType, AllocatorType Allocator = malloc_allocator>
 class StringBase
 {
 public:
@@ -47,13 +88,12 @@ public:
 	// fails, the String will be marked as invalid (i.e. "if (s)" will
 	// be false).
 
-	 constexpr explicit StringBase(const CharType *cstr = "");
-	 constexpr explicit StringBase(const StringBase<CharType> &str);
+	 constexpr explicit StringBase(const CharType *cstr = nullptr);
+	 constexpr StringBase(const StringBase<CharType, Allocator> &str);
 	 constexpr explicit StringBase(const __FlashStringHelper *str);
        #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-	 constexpr StringBase(StringBase<CharType> &&rval);
+	 constexpr StringBase(StringBase<CharType, Allocator> &&rval);
 	#endif
-    constexpr explicit StringBase(unsigned count, CharType c);
 	constexpr explicit StringBase(CharType c);
 	constexpr explicit StringBase(unsigned char, unsigned char base=10);
 	constexpr explicit StringBase(int, unsigned char base=10);
@@ -62,6 +102,7 @@ public:
 	constexpr explicit StringBase(unsigned long, unsigned char base=10);
 	constexpr StringBase(float, unsigned char decimalPlaces=2);
 	constexpr StringBase(double, unsigned char decimalPlaces=2);
+	template <uint8_t DECIMALS, Int Rep> constexpr explicit StringBase(fixed_point<DECIMALS, Rep> value);
 	constexpr ~StringBase();
 
 	// memory management
@@ -74,11 +115,11 @@ public:
 	// creates a copy of the assigned value.  if the value is null or
 	// invalid, or if the memory allocation fails, the String will be
 	// marked as invalid ("if (s)" will be false).
-	 constexpr StringBase<CharType> & operator = (const StringBase<CharType> &rhs);
-	 constexpr StringBase<CharType> & operator = (const CharType *cstr);
-	 constexpr StringBase<CharType> & operator = (const __FlashStringHelper *str);
+	 constexpr StringBase<CharType, Allocator> & operator = (const StringBase<CharType, Allocator> &rhs);
+	 constexpr StringBase<CharType, Allocator> & operator = (const CharType *cstr);
+	 constexpr StringBase<CharType, Allocator> & operator = (const __FlashStringHelper *str);
        #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-	 constexpr StringBase<CharType> & operator = (StringBase<CharType> &&rval);
+	 constexpr StringBase<CharType, Allocator> & operator = (StringBase<CharType, Allocator> &&rval);
 	#endif
 
 	// concatenate (works w/ built-in types)
@@ -86,7 +127,7 @@ public:
 	// returns true on success, false on failure (in which case, the string
 	// is left unchanged).  if the argument is null or invalid, the
 	// concatenation is considered unsuccessful.
-	constexpr unsigned char concat(const StringBase<CharType> &str);
+	constexpr unsigned char concat(const StringBase<CharType, Allocator> &str);
 	constexpr unsigned char concat(const CharType *cstr);
 	constexpr unsigned char concat(CharType c);
 	constexpr unsigned char concat(unsigned char c);
@@ -97,108 +138,63 @@ public:
 	constexpr unsigned char concat(float num);
 	constexpr unsigned char concat(double num);
 	constexpr unsigned char concat(const __FlashStringHelper * str);
+	template <uint8_t DECIMALS, Int Rep> constexpr unsigned char concat(fixed_point<DECIMALS, Rep> num);
 
 	// if there's not enough memory for the concatenated value, the string
 	// will be left unchanged (but this isn't signalled in any way)
-	 constexpr StringBase<CharType> & operator += (const StringBase<CharType> &rhs)	{concat(rhs); return (*this);}
-	 constexpr StringBase<CharType> & operator += (const CharType *cstr)		{concat(cstr); return (*this);}
-	 constexpr StringBase<CharType> & operator += (char c)			{concat(c); return (*this);}
-	 constexpr StringBase<CharType> & operator += (unsigned char num)		{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (int num)			{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (unsigned int num)		{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (long num)			{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (unsigned long num)	{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (float num)		{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (double num)		{concat(num); return (*this);}
-	 constexpr StringBase<CharType> & operator += (const __FlashStringHelper *str){concat(str); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (const StringBase<CharType, Allocator> &rhs)	{concat(rhs); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (const CharType *cstr)		{concat(cstr); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (CharType c)			{concat(c); return (*this);}
+	 // an ASCII char on a wide string, rather than its number
+	 template <typename C> requires (std::is_same_v<C, char> && !std::is_same_v<CharType, char>)
+	 constexpr StringBase<CharType, Allocator> & operator += (C c)			{concat(static_cast<CharType>(c)); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (unsigned char num)		{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (int num)			{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (unsigned int num)		{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (long num)			{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (unsigned long num)	{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (float num)		{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (double num)		{concat(num); return (*this);}
+	 constexpr StringBase<CharType, Allocator> & operator += (const __FlashStringHelper *str){concat(str); return (*this);}
+	 template <uint8_t DECIMALS, Int Rep>
+	 constexpr StringBase<CharType, Allocator> & operator += (fixed_point<DECIMALS, Rep> num)	{concat(num); return (*this);}
 
     /*********************************************/
     /*  Concatenate                              */
     /*********************************************/
 
-    constexpr StringBase<CharType> & operator + (const StringBase<CharType> &rhs) const
-    {
-        if (!concat(rhs.m_buffer, rhs.len)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (const CharType *cstr) const
-    {
-        if (!cstr || !concat(cstr, strlen(cstr))) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (CharType c) const
-    {
-        if (!concat(c)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (unsigned char num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (int num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (unsigned int num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (long num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (unsigned long num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (float num) const 
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (double num) const
-    {
-        if (!concat(num)) invalidate();
-        return this;
-    }
-
-    constexpr StringBase<CharType> & operator + (const __FlashStringHelper *rhs) const
-    {
-        if (!concat(rhs))	invalidate();
-        return this;
-    }
+    // these return a new string; it is invalid if memory allocation failed
+    constexpr StringBase<CharType, Allocator> operator + (const StringBase<CharType, Allocator> &rhs) const { return concatenated(rhs); }
+    constexpr StringBase<CharType, Allocator> operator + (const CharType *cstr) const { return concatenated(cstr); }
+    constexpr StringBase<CharType, Allocator> operator + (CharType c) const { return concatenated(c); }
+    constexpr StringBase<CharType, Allocator> operator + (unsigned char num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (int num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (unsigned int num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (long num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (unsigned long num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (float num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (double num) const { return concatenated(num); }
+    constexpr StringBase<CharType, Allocator> operator + (const __FlashStringHelper *rhs) const { return concatenated(rhs); }
+    template <uint8_t DECIMALS, Int Rep>
+    constexpr StringBase<CharType, Allocator> operator + (fixed_point<DECIMALS, Rep> num) const { return concatenated(num); }
 
 	// comparison (only works w/ Strings and "strings")
 	constexpr operator bool() const { return len > 0; }
-	constexpr int compareTo(const StringBase<CharType> &s) const;
-	constexpr unsigned char equals(const StringBase<CharType> &s) const;
+	constexpr int compareTo(const StringBase<CharType, Allocator> &s) const;
+	constexpr unsigned char equals(const StringBase<CharType, Allocator> &s) const;
 	constexpr unsigned char equals(const CharType *cstr) const;
-	constexpr unsigned char operator == (const StringBase<CharType> &rhs) const {return equals(rhs);}
+	constexpr unsigned char operator == (const StringBase<CharType, Allocator> &rhs) const {return equals(rhs);}
 	constexpr unsigned char operator == (const CharType *cstr) const {return equals(cstr);}
-	constexpr unsigned char operator != (const StringBase<CharType> &rhs) const {return !equals(rhs);}
+	constexpr unsigned char operator != (const StringBase<CharType, Allocator> &rhs) const {return !equals(rhs);}
 	constexpr unsigned char operator != (const CharType *cstr) const {return !equals(cstr);}
-	constexpr unsigned char operator <  (const StringBase<CharType> &rhs) const;
-	constexpr unsigned char operator >  (const StringBase<CharType> &rhs) const;
-	constexpr unsigned char operator <= (const StringBase<CharType> &rhs) const;
-	constexpr unsigned char operator >= (const StringBase<CharType> &rhs) const;
-	constexpr unsigned char equalsIgnoreCase(const StringBase<CharType> &s) const;
-	constexpr unsigned char startsWith( const StringBase<CharType> &prefix) const;
-	constexpr unsigned char startsWith(const StringBase<CharType> &prefix, unsigned int offset) const;
-	constexpr unsigned char endsWith(const StringBase<CharType> &suffix) const;
+	constexpr unsigned char operator <  (const StringBase<CharType, Allocator> &rhs) const;
+	constexpr unsigned char operator >  (const StringBase<CharType, Allocator> &rhs) const;
+	constexpr unsigned char operator <= (const StringBase<CharType, Allocator> &rhs) const;
+	constexpr unsigned char operator >= (const StringBase<CharType, Allocator> &rhs) const;
+	constexpr unsigned char equalsIgnoreCase(const StringBase<CharType, Allocator> &s) const;
+	constexpr unsigned char startsWith( const StringBase<CharType, Allocator> &prefix) const;
+	constexpr unsigned char startsWith(const StringBase<CharType, Allocator> &prefix, unsigned int offset) const;
+	constexpr unsigned char endsWith(const StringBase<CharType, Allocator> &suffix) const;
 
 	// character access
 	constexpr CharType charAt(unsigned int index) const;
@@ -206,36 +202,56 @@ public:
 	constexpr CharType operator [] (unsigned int index) const;
 	constexpr CharType& operator [] (unsigned int index);
 	constexpr void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index=0) const;
-	constexpr void toCharArray(char *buf, unsigned int bufsize, unsigned int index=0) const;
-	constexpr const CharType* c_str() const { return m_buffer; }
-	constexpr CharType* begin() { return m_buffer; }
-    constexpr const CharType* begin() const { return c_str(); }
-	constexpr CharType* end() { return m_buffer + len; }
-	constexpr const CharType* end() const { return c_str() + length(); }
+	constexpr void toCharArray(CharType *buf, unsigned int bufsize, unsigned int index=0) const;
+	// A copy_on_write slice that ends before its buffer does has no
+	// terminator: it gets a buffer of its own here, and c_str() is nullptr
+	// if that can't be allocated. On a const string such a slice's c_str()
+	// is always nullptr; begin() and length() work on every string.
+	constexpr const CharType* c_str() {
+		if constexpr (SHARED) {
+			if (m_buffer && m_buffer[len] != 0 && !makeUnique()) return nullptr;
+		}
+		return m_buffer;
+	}
+	constexpr const CharType* c_str() const {
+		if constexpr (SHARED) {
+			if (m_buffer && m_buffer[len] != 0) return nullptr;
+		}
+		return m_buffer;
+	}
+	// nullptr when a shared buffer can't be copied for writing
+	constexpr CharType* begin() { return makeUnique() ? m_buffer : nullptr; }
+    constexpr const CharType* begin() const { return m_buffer; }
+	constexpr CharType* end() { CharType* first = begin(); return first ? first + len : nullptr; }
+	constexpr const CharType* end() const { return m_buffer + len; }
 
 	// search
     constexpr bool contains(CharType) const;
     constexpr bool contains(const CharType*) const;
-    constexpr bool contains(const StringBase<CharType>&) const;
+    constexpr bool contains(const StringBase<CharType, Allocator>&) const;
 	constexpr int indexOf( CharType ch, unsigned int fromIndex = 0) const;
     constexpr int indexOf(const CharType* c, unsigned int fromIndex = 0) const;
-	constexpr int indexOf(const StringBase<CharType> &str, unsigned int fromIndex = 0) const;
+	constexpr int indexOf(const StringBase<CharType, Allocator> &str, unsigned int fromIndex = 0) const;
 	constexpr int lastIndexOf( CharType ch ) const;
 	constexpr int lastIndexOf( CharType ch, unsigned int fromIndex ) const;
-	constexpr int lastIndexOf( const StringBase<CharType> &str ) const;
-	constexpr int lastIndexOf( const StringBase<CharType> &str, unsigned int fromIndex ) const;
-	constexpr StringBase<CharType> subString( unsigned int beginIndex ) const { return subString(beginIndex, len); };
-	constexpr StringBase<CharType> subString( unsigned int beginIndex, unsigned int endIndex ) const;
+	constexpr int lastIndexOf( const StringBase<CharType, Allocator> &str ) const;
+	constexpr int lastIndexOf( const StringBase<CharType, Allocator> &str, unsigned int fromIndex ) const;
+	constexpr StringBase<CharType, Allocator> subString( unsigned int beginIndex ) const { return subString(beginIndex, len); };
+	constexpr StringBase<CharType, Allocator> subString( unsigned int beginIndex, unsigned int endIndex ) const;
 
 	// modification
 	constexpr void replace(CharType find, CharType replace);
-	constexpr void replace(const StringBase<CharType>& find, const StringBase<CharType>& replace);
+	constexpr void replace(const StringBase<CharType, Allocator>& find, const StringBase<CharType, Allocator>& replace);
 	constexpr void remove(unsigned int index);
 	constexpr void remove(unsigned int index, unsigned int count);
 	constexpr void toLowerCase();
 	constexpr void toUpperCase();
 	constexpr void trim();
     constexpr void fill(CharType c, unsigned count = 0);
+    // Grows the string by 'count' elements and returns where they start, for
+    // writing them in place; nullptr (and the string unchanged) if there's
+    // no memory for them.
+    constexpr CharType* extend(unsigned int count);
 
     // This method will only invalidate the contents of the string
     constexpr void erase();
@@ -246,28 +262,63 @@ public:
 	constexpr long toInt() const;
 	constexpr float toFloat() const;
 	constexpr double toDouble() const;
+	// 0 unless the whole string is a number fixed_point::parse() accepts
+	template <uint8_t DECIMALS, Int Rep = int32_t> constexpr fixed_point<DECIMALS, Rep> toFixed() const;
 
 protected:
-	CharType* m_buffer = static_cast<CharType*>(calloc(31, sizeof(CharType))); // the actual char array
-	unsigned int m_capacity{31};  // the array length
-	unsigned int len{0};       // the String length
-    char dummy_char{0};
+	using traits = char_traits<CharType>;
+	static constexpr bool SHARED = is_copy_on_write<Allocator>;
+	struct NotShared {};
+	using shared_type = std::conditional_t<SHARED, detail::SharedBuffer *, NotShared>;
 
+	CharType* m_buffer = allocate(30); // the actual char array
+	unsigned int m_capacity{30};  // the array length, not counting the terminator
+	unsigned int len{0};       // the String length
+    CharType dummy_char{0};
+	[[no_unique_address]] shared_type m_shared = sharedBuffer(m_buffer); // copy_on_write only
+
+	static constexpr size_t bytesFor(unsigned int capacity);
+	static constexpr CharType* allocate(unsigned int capacity, AllocationSite site = AllocationSite::Construct);
+	static constexpr shared_type sharedBuffer(CharType *buffer);
+	// false while another copy_on_write string points at the buffer
+	constexpr bool owns() const;
+	constexpr unsigned char makeUnique();
+	constexpr void release(AllocationSite site);
 	constexpr void invalidate();
-	constexpr unsigned char changeBuffer(unsigned int maxStrLen);
+	// reserve() and changeBuffer() on behalf of the operation 'site'
+	constexpr unsigned char reserveFor(unsigned int size, AllocationSite site);
+	constexpr unsigned char changeBuffer(unsigned int maxStrLen, AllocationSite site);
 	constexpr unsigned char concat(const CharType *cstr, unsigned int length);
+	// the number formatters write char; wider strings get their text widened
+	constexpr void copyAscii(const char *str);
+	constexpr unsigned char concatAscii(const char *str);
+	constexpr const char* narrowed(char *out, unsigned int size) const;
+
+	template <typename T>
+	constexpr StringBase<CharType, Allocator> concatenated(const T &value) const
+	{
+		StringBase<CharType, Allocator> result(*this);
+		if (!result.concat(value)) result.invalidate();
+		return result;
+	}
 
 	// copy and move
-	 constexpr StringBase<CharType> & copy(const CharType *, unsigned int length);
-	 constexpr StringBase<CharType> & copy(const __FlashStringHelper *pstr, unsigned int length);
+	 constexpr StringBase<CharType, Allocator> & copy(const CharType *, unsigned int length);
+	 constexpr StringBase<CharType, Allocator> & copy(const __FlashStringHelper *pstr, unsigned int length);
        #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-	constexpr void move(StringBase<CharType> &&rhs);
+	constexpr void move(StringBase<CharType, Allocator> &&rhs);
 	#endif
 };
 
-#endif  // __cplusplus
-
 using String = StringBase<char>;
+using SharedString = StringBase<char, copy_on_write<>>;
+using U16String = StringBase<char16_t>;
+using U32String = StringBase<char32_t>;
+
+// The member definitions are constexpr templates and have to be visible to callers
+#include "String.cpp"
+
+#endif  // __cplusplus
 
 #endif  // String_class_h
 
@@ -1,13 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include "String.hpp"
+
 template<typename CharType>
 class StringViewBase {
     public:
+    constexpr StringViewBase() = default;
+
+    constexpr StringViewBase(const CharType* str, size_t length)
+    : m_string(str),
+      m_length(length) {}
+
+    // 'str' is a string literal, so the terminator is not part of the view
     template<size_t LENGTH>
     constexpr StringViewBase(const CharType(&str)[LENGTH]) 
     : m_string(str),
-      m_length(LENGTH) {}
+      m_length(LENGTH - 1) {}
 
-    constexpr StringViewBase(const StringBase<CharType>& str)
-    : m_string(str.c_str()),
+    template<typename Allocator>
+    constexpr StringViewBase(const StringBase<CharType, Allocator>& str)
+    : m_string(str.begin()),
       m_length(str.length()) {}
 
     constexpr CharType operator[]( unsigned int index ) const
@@ -16,6 +28,17 @@ class StringViewBase {
         return m_string[index];
     }
 
+    constexpr size_t length() const { return m_length; }
+    constexpr const CharType* data() const { return m_string; }
+
+    constexpr bool operator==(const StringViewBase& other) const {
+        if (m_length != other.m_length) return false;
+        for (size_t i = 0; i < m_length; i++) {
+            if (m_string[i] != other.m_string[i]) return false;
+        }
+        return true;
+    }
+
     private:
     const CharType* m_string{nullptr};
     size_t m_length{0};
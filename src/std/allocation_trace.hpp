@@ -0,0 +1,108 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Opt-in allocation tracing for StringBase. Build with
+// -DTRACE_ALLOCATIONS=true and dump the numbers with Logger::allocations().
+#ifndef TRACE_ALLOCATIONS
+constexpr bool TRACE_ALLOCATIONS = false;
+#endif
+
+// Where in StringBase an allocation was made or given back
+enum class AllocationSite : uint8_t {
+    Construct,  // initial buffer of every string
+    Reserve,    // reserve() and reset()
+    Concat,     // growing concat(), +=, extend() and the number appends
+    Copy,       // assignments and fill() that need a larger buffer
+    Replace,    // replace() growing the string
+    Unshare,    // a copy_on_write string copying a shared buffer to write to it
+    Invalidate, // invalidate() after a failed operation or a null assignment
+    Destruct,   // ~StringBase()
+    Move,       // the target's buffer being dropped by a move or a shared copy
+    Share,      // copies and subString()s that shared a buffer (copy_on_write)
+    Count
+};
+
+class AllocationTracer {
+public:
+    struct SiteStats {
+        uint32_t calls{0};
+        uint32_t bytes{0};
+    };
+
+    AllocationTracer() = delete;
+
+    static void allocated(AllocationSite site, size_t bytes) {
+        record(site, bytes);
+        state().allocations++;
+        grow(bytes);
+    }
+
+    static void resized(AllocationSite site, size_t old_bytes, size_t new_bytes) {
+        record(site, new_bytes);
+        if (new_bytes >= old_bytes) {
+            grow(new_bytes - old_bytes);
+        } else {
+            state().current -= old_bytes - new_bytes;
+        }
+    }
+
+    // a copy that allocated nothing; only counted
+    static void shared(AllocationSite site) { record(site, 0); }
+
+    static void released(AllocationSite site, size_t bytes) {
+        record(site, bytes);
+        state().frees++;
+        state().current -= bytes;
+    }
+
+    static const SiteStats& site(AllocationSite site) { return state().sites[static_cast<uint8_t>(site)]; }
+    static uint32_t current() { return state().current; }
+    static uint32_t peak() { return state().peak; }
+    static uint32_t allocations() { return state().allocations; }
+    static uint32_t frees() { return state().frees; }
+
+    static void reset() { state() = State{}; }
+
+    static const char* name(AllocationSite site) {
+        switch (site) {
+            case AllocationSite::Construct: return "construct";
+            case AllocationSite::Reserve: return "reserve";
+            case AllocationSite::Concat: return "concat";
+            case AllocationSite::Copy: return "copy";
+            case AllocationSite::Replace: return "replace";
+            case AllocationSite::Unshare: return "unshare";
+            case AllocationSite::Invalidate: return "invalidate";
+            case AllocationSite::Destruct: return "destruct";
+            case AllocationSite::Move: return "move";
+            case AllocationSite::Share: return "share";
+            default: return "?";
+        }
+    }
+
+private:
+    struct State {
+        SiteStats sites[static_cast<uint8_t>(AllocationSite::Count)]{};
+        uint32_t current{0};
+        uint32_t peak{0};
+        uint32_t allocations{0};
+        uint32_t frees{0};
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static void record(AllocationSite site, size_t bytes) {
+        auto& stats = state().sites[static_cast<uint8_t>(site)];
+        stats.calls++;
+        stats.bytes += bytes;
+    }
+
+    static void grow(size_t bytes) {
+        auto& s = state();
+        s.current += bytes;
+        if (s.current > s.peak) s.peak = s.current;
+    }
+};
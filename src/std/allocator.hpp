@@ -0,0 +1,191 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <concepts>
+
+// Allocation policies are stateless types with static members, so that a
+// container only pays for them in its type and not in its size. Memory
+// resources (arena, pool) are objects with static storage duration that
+// can be turned into a policy with resource_allocator.
+template <typename A> concept AllocatorType = requires(void* ptr, size_t size) {
+    { A::allocate(size) } -> std::same_as<void*>;
+    { A::reallocate(ptr, size, size) } -> std::same_as<void*>;
+    A::deallocate(ptr);
+};
+
+struct malloc_allocator {
+    static void* allocate(size_t size) noexcept { return malloc(size); }
+    static void* reallocate(void* ptr, size_t /*old_size*/, size_t new_size) noexcept { return realloc(ptr, new_size); }
+    static void deallocate(void* ptr) noexcept { free(ptr); }
+};
+
+// Selects StringBase's shared mode: copies and subString() results point at
+// one reference-counted buffer, and a string copies it only when it is about
+// to modify it. Memory still comes from 'Allocator'.
+//   using SharedString = StringBase<char, copy_on_write<>>;
+template <AllocatorType Allocator = malloc_allocator>
+struct copy_on_write : Allocator {};
+
+template <typename A> constexpr bool is_copy_on_write = false;
+template <typename A> constexpr bool is_copy_on_write<copy_on_write<A>> = true;
+
+constexpr size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/*********************************************/
+/*  Arena                                    */
+/*********************************************/
+
+// Bump-pointer arena. Allocation is a pointer increment; memory is only
+// given back when the arena (or a scope on it) is reset. The most recent
+// allocation can be grown or released in place.
+template <size_t SIZE, size_t ALIGNMENT = alignof(max_align_t)>
+class arena {
+    static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "arena: alignment must be a power of two");
+public:
+    // Restores the arena to where it was when the scope was created
+    class scope {
+    public:
+        constexpr explicit scope(arena& a)
+        : m_arena(a),
+          m_top(a.m_top),
+          m_last(a.m_last) {}
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+        ~scope() {
+            m_arena.m_top = m_top;
+            m_arena.m_last = m_last;
+        }
+    private:
+        arena& m_arena;
+        size_t m_top;
+        size_t m_last;
+    };
+
+    void* allocate(size_t size) noexcept {
+        const auto start = align_up(m_top, ALIGNMENT);
+        if (start + size > SIZE || start + size < start) { [[unlikely]]
+            return nullptr;
+        }
+
+        m_last = start;
+        m_top = start + size;
+        return m_storage + start;
+    }
+
+    void* reallocate(void* ptr, size_t old_size, size_t new_size) noexcept {
+        if (!ptr) return allocate(new_size);
+
+        // The last allocation can grow or shrink without copying
+        if (static_cast<unsigned char*>(ptr) == m_storage + m_last) {
+            if (m_last + new_size > SIZE) return nullptr;
+            m_top = m_last + new_size;
+            return ptr;
+        }
+
+        auto* moved = allocate(new_size);
+        if (moved) memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+        return moved;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        if (ptr && static_cast<unsigned char*>(ptr) == m_storage + m_last) {
+            m_top = m_last;
+        }
+    }
+
+    void reset() noexcept { m_top = m_last = 0; }
+
+    constexpr size_t used() const noexcept { return m_top; }
+    constexpr size_t capacity() const noexcept { return SIZE; }
+
+private:
+    alignas(ALIGNMENT) unsigned char m_storage[SIZE];
+    size_t m_top{0};
+    size_t m_last{0};
+};
+
+/*********************************************/
+/*  Pool                                     */
+/*********************************************/
+
+// Fixed-block pool with an intrusive free list: allocation and release are
+// O(1) and the pool can never fragment. Requests larger than BLOCK_SIZE fail.
+template <size_t BLOCK_SIZE, size_t COUNT>
+class pool {
+    union Block {
+        Block* next;
+        alignas(max_align_t) unsigned char bytes[BLOCK_SIZE];
+    };
+public:
+    pool() noexcept { reset(); }
+
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    void* allocate(size_t size) noexcept {
+        if (size > BLOCK_SIZE || !m_free) { [[unlikely]]
+            return nullptr;
+        }
+
+        auto* block = m_free;
+        m_free = block->next;
+        m_used++;
+        return block->bytes;
+    }
+
+    void* reallocate(void* ptr, size_t /*old_size*/, size_t new_size) noexcept {
+        if (!ptr) return allocate(new_size);
+        return new_size <= BLOCK_SIZE ? ptr : nullptr;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        if (!ptr) return;
+
+        auto* block = static_cast<Block*>(ptr);
+        block->next = m_free;
+        m_free = block;
+        m_used--;
+    }
+
+    void reset() noexcept {
+        for (size_t i = 0; i < COUNT; i++) {
+            m_blocks[i].next = i + 1 < COUNT ? &m_blocks[i + 1] : nullptr;
+        }
+        m_free = COUNT ? &m_blocks[0] : nullptr;
+        m_used = 0;
+    }
+
+    constexpr size_t used() const noexcept { return m_used; }
+    constexpr size_t available() const noexcept { return COUNT - m_used; }
+    static constexpr size_t block_size() noexcept { return BLOCK_SIZE; }
+
+private:
+    Block m_blocks[COUNT];
+    Block* m_free{nullptr};
+    size_t m_used{0};
+};
+
+// Adapts an arena or pool with static storage duration to an allocation
+// policy, e.g. StringBase<char, resource_allocator<g_string_pool>>.
+template <auto& Resource>
+struct resource_allocator {
+    static void* allocate(size_t size) noexcept { return Resource.allocate(size); }
+    static void* reallocate(void* ptr, size_t old_size, size_t new_size) noexcept { return Resource.reallocate(ptr, old_size, new_size); }
+    static void deallocate(void* ptr) noexcept { Resource.deallocate(ptr); }
+};
+
+// unique_ptr deleter for objects placement-new'ed into an arena or pool
+template <auto& Resource>
+struct resource_delete {
+    template <typename T>
+    void operator()(T* ptr) const noexcept {
+        ptr->~T();
+        Resource.deallocate(ptr);
+    }
+};
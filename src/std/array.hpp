@@ -1,125 +1,84 @@
 #pragma once
-//#include <iterator> // For std::forward_iterator_tag
 #include <stddef.h>
-#include <numeric>
+#include <compare>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "iterator.hpp"
 
 template <typename T, size_t SIZE>
 class array {
-    using iterator_category = std::forward_iterator_tag;
+public:
     using pointer           = T*;
     using reference         = T&;
     using const_reference = const T&;
     using value_type = T;
     using difference_type = std::ptrdiff_t;
     using size_type = std::size_t;
-public:
-    class iterator: public std::iterator<
-                        iterator_category,   
-                        value_type,                      
-                        difference_type,                     
-                        pointer,               
-                        reference                       
-                                      >{
-        pointer m_ptr;
-    public:
-        constexpr explicit iterator(pointer ptr) : m_ptr(ptr) {}
-        constexpr iterator& operator++() { m_ptr++; return *this;}
-        constexpr iterator operator++(int) {iterator retval = *this; ++(*this); return retval;}
-        constexpr friend bool operator== (const iterator& a, const iterator& b) { return a.m_ptr == b.m_ptr; };
-        constexpr friend bool operator!= (const iterator& a, const iterator& b) { return a.m_ptr != b.m_ptr; }; 
-        constexpr reference operator*()  {return *m_ptr;}
-        constexpr pointer operator->()  { return m_ptr; }
-    };
-
-    class const_iterator: public std::iterator<
-                        iterator_category,   
-                        value_type,                      
-                        difference_type,                     
-                        const pointer,               
-                        reference                    
-                                      >{
-        T const* m_ptr;
-    public:
-        constexpr explicit const_iterator(T const* ptr) : m_ptr(ptr) {}
-        constexpr const_iterator& operator++() { m_ptr++; return *this;}
-        constexpr const_iterator operator++(int) {const_iterator retval = *this; ++(*this); return retval;}
-        constexpr friend bool operator== (const const_iterator& a, const const_iterator& b) { return a.m_ptr == b.m_ptr; };
-        constexpr friend bool operator!= (const const_iterator& a, const const_iterator& b) { return a.m_ptr != b.m_ptr; }; 
-        constexpr T const& operator*() const {return *m_ptr;}
-        constexpr T const* operator->() const { return m_ptr; }
-    };
-
-    template<typename Itr>
-class reverse_iterator {
-    Itr itr;
-public:
-    constexpr explicit reverse_iterator(Itr itr): itr(itr) {}
-    constexpr auto& operator*() {
-        return *std::prev(itr);
-    }
-    constexpr auto& operator++() {
-        --itr;
-        return *this;
-    }
-    constexpr friend bool operator!=(reverse_iterator<Itr> a, reverse_iterator<Itr> b) {
-        return a.itr != b.itr;
-    }
-};
+
+    using iterator = contiguous_iterator<T>;
+    using const_iterator = contiguous_iterator<const T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     constexpr iterator begin() noexcept {
-        return iterator{ &m_array[0] };
+        return iterator{ m_array };
     }
 
     constexpr iterator end() noexcept {
-        return iterator{ &m_array[SIZE] };
+        return iterator{ m_array + SIZE };
     }
 
     constexpr const_iterator begin() const noexcept {
-        return const_iterator{ &m_array[0] };
+        return const_iterator{ m_array };
     }
 
     constexpr const_iterator end() const noexcept {
-        return const_iterator{ &m_array[SIZE] };
+        return const_iterator{ m_array + SIZE };
     }
 
     constexpr const_iterator cbegin() const noexcept {
-        return const_iterator{ &m_array[0] };
+        return begin();
     }
 
     constexpr const_iterator cend() const noexcept {
-        return const_iterator{ &m_array[SIZE] };
+        return end();
+    }
+
+    constexpr reverse_iterator rbegin() noexcept {
+        return reverse_iterator{ end() };
+    }
+
+    constexpr reverse_iterator rend() noexcept {
+        return reverse_iterator{ begin() };
     }
 
-    constexpr auto rbegin() noexcept {
-        return reverse_iterator{ m_array + SIZE };
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator{ end() };
     }
 
-    constexpr auto rend() noexcept {
-        return reverse_iterator{ m_array };
+    constexpr const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator{ begin() };
     }
 
-    constexpr auto rbegin() const noexcept {
-        return reverse_iterator{ m_array + SIZE };
+    constexpr const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
     }
 
-    constexpr auto rend() const noexcept {
-        return reverse_iterator{ m_array };
+    constexpr const_reverse_iterator crend() const noexcept {
+        return rend();
     }
 
-    [[nodiscard]] constexpr bool empty() const noexcept;
+    [[nodiscard]] constexpr bool empty() const noexcept { return SIZE == 0; }
     constexpr size_type size() const noexcept { return SIZE; }
-    constexpr size_type max_size() const noexcept;
+    constexpr size_type max_size() const noexcept { return SIZE; }
 
     constexpr reference       operator[](size_type n) { return m_array[n]; }
     constexpr const_reference operator[](size_type n) const { return m_array[n]; }
 
     template <size_type n>
     constexpr reference at() {
-        if constexpr (n >= SIZE) {
-            char buffer[150]{"array::at: __n (which is %u) >= _Nm (which is %u)"};
-            snprintf(buffer, 149, buffer, n, SIZE); 
-            throw std::out_of_range(buffer);
-        }
+        static_assert (n < SIZE, "array: index out of bounds");
         return m_array[n];
     }
     template <size_type n>
@@ -131,12 +90,102 @@ public:
     constexpr const_reference front() const { return m_array[0]; }
     constexpr reference       back() { return m_array[SIZE - 1]; }
     constexpr const_reference back() const { return m_array[SIZE - 1]; }
- 
-    constexpr T *       data() noexcept;
-    constexpr const T * data() const noexcept;
 
-    T m_array[SIZE];    
+    constexpr T *       data() noexcept { return m_array; }
+    constexpr const T * data() const noexcept { return m_array; }
+
+    constexpr void swap(array& other) noexcept(std::is_nothrow_swappable_v<T>) {
+        for (size_type i = 0; i < SIZE; i++) {
+            std::swap(m_array[i], other.m_array[i]);
+        }
+    }
+
+    /*********************************************/
+    /*  Bulk operations                          */
+    /*********************************************/
+
+    // These are plain index loops over the whole array with a compile-time
+    // trip count, the shape compilers auto-vectorize. Floating point
+    // reductions are split over independent accumulators since the compiler
+    // may not reorder them itself (no -ffast-math).
+
+    constexpr void fill(const T& value) {
+        for (size_type i = 0; i < SIZE; i++) {
+            m_array[i] = value;
+        }
+    }
+
+    constexpr void copy_from(const T* source) {
+        for (size_type i = 0; i < SIZE; i++) {
+            m_array[i] = source[i];
+        }
+    }
+
+    template <typename Result = T>
+    constexpr Result sum() const {
+        if constexpr (std::is_floating_point_v<Result> && SIZE >= LANES) {
+            Result lanes[LANES]{};
+            size_type i = 0;
+            for (; i + LANES <= SIZE; i += LANES) {
+                for (size_type lane = 0; lane < LANES; lane++) {
+                    lanes[lane] += static_cast<Result>(m_array[i + lane]);
+                }
+            }
+            Result result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < SIZE; i++) {
+                result += static_cast<Result>(m_array[i]);
+            }
+            return result;
+        } else {
+            Result result{};
+            for (size_type i = 0; i < SIZE; i++) {
+                result += static_cast<Result>(m_array[i]);
+            }
+            return result;
+        }
+    }
+
+    constexpr T min() const {
+        static_assert(SIZE > 0, "array: min of an empty array");
+        T result = m_array[0];
+        for (size_type i = 1; i < SIZE; i++) {
+            result = m_array[i] < result ? m_array[i] : result;
+        }
+        return result;
+    }
+
+    constexpr T max() const {
+        static_assert(SIZE > 0, "array: max of an empty array");
+        T result = m_array[0];
+        for (size_type i = 1; i < SIZE; i++) {
+            result = result < m_array[i] ? m_array[i] : result;
+        }
+        return result;
+    }
+
+    constexpr friend bool operator==(const array& a, const array& b) {
+        for (size_type i = 0; i < SIZE; i++) {
+            if (!(a.m_array[i] == b.m_array[i])) return false;
+        }
+        return true;
+    }
+
+    constexpr friend auto operator<=>(const array& a, const array& b) requires std::three_way_comparable<T> {
+        for (size_type i = 0; i < SIZE; i++) {
+            if (auto cmp = a.m_array[i] <=> b.m_array[i]; cmp != 0) return cmp;
+        }
+        return std::compare_three_way_result_t<T>{std::strong_ordering::equal};
+    }
+
+    T m_array[SIZE];
+
+private:
+    static constexpr size_type LANES = 4;
 };
 template<class T, class... U>
     array(T, U...) -> array<T, 1 + sizeof...(U)>;
 
+template <typename T, size_t SIZE>
+constexpr void swap(array<T, SIZE>& a, array<T, SIZE>& b) noexcept(noexcept(a.swap(b))) {
+    a.swap(b);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <bit>
+#include <iterator>
+#include <type_traits>
+
+// Fixed-size set of N flags, usable in constant expressions. Up to 64 flags
+// fit a single integer of the smallest sufficient width, so a bitset<8> is
+// one byte that AVR updates with a single instruction; larger sets are an
+// array of native words. count() is a popcount per word, and iterating
+// visits only the set bits, one count-trailing-zeros per bit, which makes
+// scanning a sparse set of pending flags in an ISR cheap:
+//
+//   bitset<16> pending;
+//   for (size_t channel : pending) handle(channel);
+template <size_t N>
+class bitset {
+    static_assert(N > 0, "bitset: needs at least one bit");
+public:
+    using word_type = std::conditional_t<N <= 8, uint8_t,
+                      std::conditional_t<N <= 16, uint16_t,
+                      std::conditional_t<N <= 32, uint32_t,
+                      std::conditional_t<N <= 64 || sizeof(void*) >= 8, uint64_t,
+                      std::conditional_t<sizeof(void*) >= 4, uint32_t, uint8_t>>>>>;
+    using size_type = size_t;
+
+    static constexpr size_type WORD_BITS = 8 * sizeof(word_type);
+    static constexpr size_type WORDS = (N + WORD_BITS - 1) / WORD_BITS;
+
+private:
+    // the bits of the last word that belong to the set
+    static constexpr word_type LAST_MASK = N % WORD_BITS == 0 ? static_cast<word_type>(~word_type{0})
+                                                              : static_cast<word_type>((word_type{1} << N % WORD_BITS) - 1);
+
+    static constexpr word_type bit(size_type pos) { return static_cast<word_type>(word_type{1} << pos % WORD_BITS); }
+
+public:
+    // Visits the indexes of the set bits in increasing order
+    class iterator {
+        const bitset* m_set{nullptr};
+        size_type m_word{0};
+        word_type m_bits{0}; // the bits of m_word not visited yet
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = size_type;
+
+        constexpr iterator() = default;
+        constexpr iterator(const bitset* set, size_type word) : m_set(set), m_word(word) {
+            if (m_word < WORDS) {
+                m_bits = m_set->m_words[m_word];
+                skip_empty();
+            }
+        }
+
+        constexpr size_type operator*() const { return m_word * WORD_BITS + static_cast<size_type>(std::countr_zero(m_bits)); }
+        constexpr iterator& operator++() {
+            m_bits = static_cast<word_type>(m_bits & (m_bits - 1));
+            skip_empty();
+            return *this;
+        }
+        constexpr iterator operator++(int) { iterator retval = *this; ++(*this); return retval; }
+        constexpr friend bool operator==(const iterator& a, const iterator& b) { return a.m_word == b.m_word && a.m_bits == b.m_bits; }
+
+    private:
+        constexpr void skip_empty() {
+            while (m_bits == 0 && ++m_word < WORDS) m_bits = m_set->m_words[m_word];
+        }
+    };
+
+    constexpr bitset() = default;
+
+    // The lowest N bits of 'bits', e.g. bitset<8>(PINB)
+    constexpr explicit bitset(uint64_t bits) {
+        for (size_type i = 0; i < WORDS && i * WORD_BITS < 64; i++) {
+            m_words[i] = static_cast<word_type>(bits >> (i * WORD_BITS));
+        }
+        m_words[WORDS - 1] &= LAST_MASK;
+    }
+
+    static constexpr size_type size() noexcept { return N; }
+
+    constexpr bool test(size_type pos) const { return (m_words[pos / WORD_BITS] & bit(pos)) != 0; }
+    constexpr bool operator[](size_type pos) const { return test(pos); }
+
+    constexpr bitset& set(size_type pos, bool value = true) {
+        if (value) m_words[pos / WORD_BITS] |= bit(pos);
+        else m_words[pos / WORD_BITS] &= static_cast<word_type>(~bit(pos));
+        return *this;
+    }
+    constexpr bitset& reset(size_type pos) { return set(pos, false); }
+    constexpr bitset& flip(size_type pos) {
+        m_words[pos / WORD_BITS] ^= bit(pos);
+        return *this;
+    }
+
+    constexpr bitset& set() {
+        for (auto& word : m_words) word = static_cast<word_type>(~word_type{0});
+        m_words[WORDS - 1] &= LAST_MASK;
+        return *this;
+    }
+    constexpr bitset& reset() {
+        for (auto& word : m_words) word = 0;
+        return *this;
+    }
+    constexpr bitset& flip() {
+        for (auto& word : m_words) word = static_cast<word_type>(~word);
+        m_words[WORDS - 1] &= LAST_MASK;
+        return *this;
+    }
+
+    // Number of set bits
+    constexpr size_type count() const {
+        size_type count = 0;
+        for (auto word : m_words) count += static_cast<size_type>(std::popcount(word));
+        return count;
+    }
+    constexpr bool any() const {
+        for (auto word : m_words) {
+            if (word != 0) return true;
+        }
+        return false;
+    }
+    constexpr bool none() const { return !any(); }
+    constexpr bool all() const { return count() == N; }
+
+    // Index of the lowest set bit at 'pos' or above, or size() if there is none
+    constexpr size_type find_next(size_type pos) const {
+        if (pos >= N) return N;
+        size_type word = pos / WORD_BITS;
+        auto bits = static_cast<word_type>(m_words[word] & static_cast<word_type>(~word_type{0} << pos % WORD_BITS));
+        while (bits == 0) {
+            if (++word == WORDS) return N;
+            bits = m_words[word];
+        }
+        return word * WORD_BITS + static_cast<size_type>(std::countr_zero(bits));
+    }
+    constexpr size_type find_first() const { return find_next(0); }
+
+    constexpr iterator begin() const { return iterator{this, 0}; }
+    constexpr iterator end() const { return iterator{this, WORDS}; }
+
+    // The bits as an integer; only for sets that fit one
+    constexpr uint64_t to_ullong() const requires (N <= 64) {
+        uint64_t bits = 0;
+        for (size_type i = 0; i < WORDS; i++) bits |= static_cast<uint64_t>(m_words[i]) << (i * WORD_BITS);
+        return bits;
+    }
+
+    constexpr bitset& operator&=(const bitset& other) {
+        for (size_type i = 0; i < WORDS; i++) m_words[i] &= other.m_words[i];
+        return *this;
+    }
+    constexpr bitset& operator|=(const bitset& other) {
+        for (size_type i = 0; i < WORDS; i++) m_words[i] |= other.m_words[i];
+        return *this;
+    }
+    constexpr bitset& operator^=(const bitset& other) {
+        for (size_type i = 0; i < WORDS; i++) m_words[i] ^= other.m_words[i];
+        return *this;
+    }
+    constexpr bitset operator~() const { return bitset(*this).flip(); }
+
+    friend constexpr bitset operator&(bitset a, const bitset& b) { return a &= b; }
+    friend constexpr bitset operator|(bitset a, const bitset& b) { return a |= b; }
+    friend constexpr bitset operator^(bitset a, const bitset& b) { return a ^= b; }
+    friend constexpr bool operator==(const bitset&, const bitset&) = default;
+
+private:
+    word_type m_words[WORDS]{};
+};
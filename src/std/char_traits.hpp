@@ -0,0 +1,180 @@
+#pragma once
+// What StringBase needs to know about its character type: lengths,
+// searches, comparison and case mapping for char, char16_t and char32_t.
+//
+// char goes to the C library (strlen, memchr, memcmp), which every
+// toolchain already optimizes. The wider types compare every 16 or 32-bit
+// lane of a vector or word at once (see simd.hpp). Case mapping only
+// touches ASCII letters, so it never changes the units of a UTF-16 or
+// UTF-32 sequence.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <type_traits>
+#include "simd.hpp"
+
+template <typename CharType> concept CharacterType =
+    std::is_same_v<CharType, char> || std::is_same_v<CharType, char16_t> || std::is_same_v<CharType, char32_t>;
+
+namespace detail {
+
+// SWAR needs at least two lanes in a register
+template <typename CharType>
+inline constexpr bool USE_TRAITS_WORDS = USE_WORDS && sizeof(Word) >= 2 * sizeof(CharType);
+
+// 1 in the lowest bit and the highest bit of every lane
+template <typename CharType>
+inline constexpr Word LANE_ONES = static_cast<Word>(sizeof(CharType) == 2 ? 0x0001000100010001ull : 0x0000000100000001ull);
+template <typename CharType>
+inline constexpr Word LANE_HIGH = LANE_ONES<CharType> << (8 * sizeof(CharType) - 1);
+
+// non-zero if any lane of 'word' is zero
+template <typename CharType>
+constexpr Word zero_lanes(Word word) {
+    return (word - LANE_ONES<CharType>) & ~word & LANE_HIGH<CharType>;
+}
+
+#if STD_X86_SIMD
+template <typename CharType>
+inline int equal_lanes(__m128i a, __m128i b) {
+    if constexpr (sizeof(CharType) == 2) return _mm_movemask_epi8(_mm_cmpeq_epi16(a, b));
+    else return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b));
+}
+#endif
+
+// Reads whole aligned blocks, which may run past the terminator but never
+// into the next page; that is why the address sanitizer is off here.
+template <typename CharType>
+__attribute__((no_sanitize_address)) inline size_t wide_length(const CharType* str) {
+    const CharType* p = str;
+#if STD_X86_SIMD
+    for (; reinterpret_cast<uintptr_t>(p) % 16 != 0; p++) {
+        if (*p == 0) return static_cast<size_t>(p - str);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (;; p += 16 / sizeof(CharType)) {
+        const int mask = equal_lanes<CharType>(_mm_load_si128(reinterpret_cast<const __m128i*>(p)), zero);
+        if (mask != 0) return static_cast<size_t>(p - str) + __builtin_ctz(mask) / sizeof(CharType);
+    }
+#else
+    if constexpr (USE_TRAITS_WORDS<CharType>) {
+        for (; reinterpret_cast<uintptr_t>(p) % sizeof(Word) != 0; p++) {
+            if (*p == 0) return static_cast<size_t>(p - str);
+        }
+        while (zero_lanes<CharType>(*reinterpret_cast<const AliasedWord*>(p)) == 0) p += sizeof(Word) / sizeof(CharType);
+    }
+    while (*p != 0) p++;
+    return static_cast<size_t>(p - str);
+#endif
+}
+
+template <typename CharType>
+inline const CharType* wide_find(const CharType* str, size_t count, CharType c) {
+    size_t i = 0;
+#if STD_X86_SIMD
+    const __m128i wanted = sizeof(CharType) == 2 ? _mm_set1_epi16(static_cast<short>(c)) : _mm_set1_epi32(static_cast<int>(c));
+    for (constexpr size_t LANES = 16 / sizeof(CharType); i + LANES <= count; i += LANES) {
+        const int mask = equal_lanes<CharType>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)), wanted);
+        if (mask != 0) return str + i + __builtin_ctz(mask) / sizeof(CharType);
+    }
+#else
+    if constexpr (USE_TRAITS_WORDS<CharType>) {
+        constexpr size_t LANES = sizeof(Word) / sizeof(CharType);
+        const Word wanted = LANE_ONES<CharType> * static_cast<Word>(c);
+        for (; i + LANES <= count; i += LANES) {
+            Word word;
+            memcpy(&word, str + i, sizeof(word));
+            if (zero_lanes<CharType>(word ^ wanted) != 0) break;
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (str[i] == c) return str + i;
+    }
+    return nullptr;
+}
+
+} // namespace detail
+
+template <CharacterType CharType>
+struct char_traits {
+    using char_type = CharType;
+
+    // elements before the terminator
+    static constexpr size_t length(const CharType* str) {
+        if (!std::is_constant_evaluated()) {
+            if constexpr (sizeof(CharType) == 1) return strlen(str);
+            else return detail::wide_length(str);
+        }
+        size_t length = 0;
+        while (str[length] != 0) length++;
+        return length;
+    }
+
+    // the first 'c' among 'count' elements, or nullptr
+    static constexpr const CharType* find(const CharType* str, size_t count, CharType c) {
+        if (!std::is_constant_evaluated()) {
+            if constexpr (sizeof(CharType) == 1) return static_cast<const CharType*>(memchr(str, c, count));
+            else return detail::wide_find(str, count, c);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (str[i] == c) return str + i;
+        }
+        return nullptr;
+    }
+
+    // <0, 0 or >0 as for memcmp, comparing elements as unsigned values
+    static constexpr int compare(const CharType* a, const CharType* b, size_t count) {
+        if (!std::is_constant_evaluated()) {
+            if constexpr (sizeof(CharType) == 1) return memcmp(a, b, count);
+            // bytes don't order wide elements on little-endian CPUs, but
+            // memcmp still finds equal runs fastest
+            else if (memcmp(a, b, count * sizeof(CharType)) == 0) return 0;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (a[i] != b[i]) return to_int(a[i]) < to_int(b[i]) ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // the first occurrence of 'needle' in 'count' elements, or nullptr
+    static constexpr const CharType* search(const CharType* str, size_t count, const CharType* needle, size_t needle_length) {
+        if (needle_length == 0) return str;
+        for (size_t i = 0; i + needle_length <= count;) {
+            const CharType* first = find(str + i, count - needle_length + 1 - i, needle[0]);
+            if (!first) return nullptr;
+            if (compare(first + 1, needle + 1, needle_length - 1) == 0) return first;
+            i = static_cast<size_t>(first - str) + 1;
+        }
+        return nullptr;
+    }
+
+    static constexpr void assign(CharType* str, size_t count, CharType c) {
+        if constexpr (sizeof(CharType) == 1) {
+            if (!std::is_constant_evaluated()) {
+                memset(str, c, count);
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; i++) str[i] = c;
+    }
+
+    static constexpr unsigned long to_int(CharType c) {
+        return static_cast<std::make_unsigned_t<CharType>>(c);
+    }
+
+    static constexpr CharType to_lower(CharType c) {
+        if constexpr (sizeof(CharType) == 1) {
+            if (!std::is_constant_evaluated()) return static_cast<CharType>(tolower(static_cast<unsigned char>(c)));
+        }
+        return c >= 'A' && c <= 'Z' ? static_cast<CharType>(c + ('a' - 'A')) : c;
+    }
+
+    static constexpr CharType to_upper(CharType c) {
+        if constexpr (sizeof(CharType) == 1) {
+            if (!std::is_constant_evaluated()) return static_cast<CharType>(toupper(static_cast<unsigned char>(c)));
+        }
+        return c >= 'a' && c <= 'z' ? static_cast<CharType>(c - ('a' - 'A')) : c;
+    }
+};
@@ -0,0 +1,427 @@
+#pragma once
+// Bulk encoders and decoders for byte buffers: hex (with an optional
+// separator between bytes), Base64/Base64URL and Base32 (RFC 4648).
+//
+// The encoders write no terminator and return the number of characters
+// written, which *_encoded_size() gives up front. The overloads taking a
+// StringBase append to it after reserving the exact size. The decoders
+// return the number of bytes written or -1 for malformed input.
+//
+// 8-bit MCUs look every character up in a table, wider CPUs encode hex with
+// SWAR arithmetic, and x86-64 hosts use SSSE3/AVX2 when the CPU has them
+// (see simd.hpp).
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "String.hpp"
+#include "simd.hpp"
+
+enum class Base64 : uint8_t { Standard, Url };
+
+namespace detail {
+
+constexpr size_t length_of(const char* str) {
+    size_t length = 0;
+    if (str) {
+        while (str[length]) length++;
+    }
+    return length;
+}
+
+inline constexpr char hex_lower[] = "0123456789abcdef";
+inline constexpr char hex_upper[] = "0123456789ABCDEF";
+inline constexpr char base64_standard[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr char base64_url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+inline constexpr char base32_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+// -1 for anything that isn't a digit of the encoding
+constexpr int8_t hex_value(char c) {
+    if (c >= '0' && c <= '9') return static_cast<int8_t>(c - '0');
+    c = static_cast<char>(c | 0x20);
+    if (c >= 'a' && c <= 'f') return static_cast<int8_t>(c - 'a' + 10);
+    return -1;
+}
+
+constexpr int8_t base64_value(char c, Base64 alphabet) {
+    if (c >= 'A' && c <= 'Z') return static_cast<int8_t>(c - 'A');
+    if (c >= 'a' && c <= 'z') return static_cast<int8_t>(c - 'a' + 26);
+    if (c >= '0' && c <= '9') return static_cast<int8_t>(c - '0' + 52);
+    if (c == (alphabet == Base64::Url ? '-' : '+')) return 62;
+    if (c == (alphabet == Base64::Url ? '_' : '/')) return 63;
+    return -1;
+}
+
+// lower case is accepted as well
+constexpr int8_t base32_value(char c) {
+    if (c >= 'A' && c <= 'Z') return static_cast<int8_t>(c - 'A');
+    if (c >= 'a' && c <= 'z') return static_cast<int8_t>(c - 'a');
+    if (c >= '2' && c <= '7') return static_cast<int8_t>(c - '2' + 26);
+    return -1;
+}
+
+// On CPUs with 32-bit or wider registers the input bytes are spread out to
+// one nibble per byte and turned into ASCII at once: adding 6 carries into
+// bit 4 exactly for the nibbles above 9, which then get the gap between
+// '9' + 1 and 'a' added. 8-bit MCUs look the nibbles up instead.
+constexpr void hex_encode_swar(const uint8_t* data, size_t size, char* out, bool upper) {
+    size_t i = 0;
+    if constexpr (USE_WORDS && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) {
+        if (!std::is_constant_evaluated()) {
+            using Half = std::conditional_t<sizeof(void*) >= 8, uint32_t, uint16_t>;
+            constexpr Word ONES = static_cast<Word>(0x0101010101010101ull);
+            constexpr Word EVEN_BYTES = static_cast<Word>(0x00FF00FF00FF00FFull);
+            constexpr Word LOW_NIBBLES = ONES * 0x0F;
+            const Word letter_gap = static_cast<uint8_t>((upper ? 'A' : 'a') - '0' - 10);
+
+            for (; i + sizeof(Half) <= size; i += sizeof(Half)) {
+                Half half;
+                memcpy(&half, data + i, sizeof(half));
+                Word x = half;
+                if constexpr (sizeof(Word) == 8) x = (x | x << 16) & 0x0000FFFF0000FFFFull;
+                x = (x | x << 8) & EVEN_BYTES;
+                // the high nibble comes first in the text
+                const Word nibbles = ((x >> 4) & LOW_NIBBLES) | (x & LOW_NIBBLES) << 8;
+                const Word above_nine = ((nibbles + ONES * 6) >> 4) & ONES;
+                const Word ascii = nibbles + ONES * '0' + above_nine * letter_gap;
+                memcpy(out + 2 * i, &ascii, sizeof(ascii));
+            }
+        }
+    }
+
+    const char* digits = upper ? hex_upper : hex_lower;
+    char* str = out + 2 * i;
+    for (; i < size; i++) {
+        *str++ = digits[data[i] >> 4];
+        *str++ = digits[data[i] & 0xF];
+    }
+}
+
+#if STD_X86_SIMD
+
+// The SIMD kernels return how many input bytes they encoded; the scalar
+// code finishes the rest.
+
+__attribute__((target("ssse3"))) inline size_t hex_encode_ssse3(const uint8_t* data, size_t size, char* out, bool upper) {
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper ? hex_upper : hex_lower));
+    const __m128i low_nibbles = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibbles));
+        const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_nibbles));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline size_t hex_encode_avx2(const uint8_t* data, size_t size, char* out, bool upper) {
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper ? hex_upper : hex_lower)));
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibbles));
+        const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_nibbles));
+        // the unpacks work within 128-bit lanes, so put the lanes back in order
+        const __m256i first = _mm256_unpacklo_epi8(high, low);
+        const __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+inline size_t hex_encode_simd(const uint8_t* data, size_t size, char* out, bool upper) {
+    if (size >= 32 && __builtin_cpu_supports("avx2")) return hex_encode_avx2(data, size, out, upper);
+    if (size >= 16 && __builtin_cpu_supports("ssse3")) return hex_encode_ssse3(data, size, out, upper);
+    return 0;
+}
+
+// Mula and Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+// Instructions": 12 input bytes are shuffled so that every 32-bit lane
+// holds the 24 bits of one group, the four 6-bit indices are moved into
+// their own bytes with two multiplies and a shuffle maps each index range
+// to the offset of its ASCII range.
+__attribute__((target("ssse3"))) inline size_t base64_encode_ssse3(const uint8_t* data, size_t size, char* out, Base64 alphabet) {
+    const __m128i offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, static_cast<char>((alphabet == Base64::Url ? '-' : '+') - 62),
+        static_cast<char>((alphabet == Base64::Url ? '_' : '/') - 63), 'A', 0, 0);
+    size_t i = 0;
+    // each step reads 16 bytes and encodes 12 of them
+    for (; i + 16 <= size; i += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t0, t1);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        const __m128i ascii = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 3 * 4), ascii);
+    }
+    return i;
+}
+
+inline size_t base64_encode_simd(const uint8_t* data, size_t size, char* out, Base64 alphabet) {
+    if (size >= 16 && __builtin_cpu_supports("ssse3")) return base64_encode_ssse3(data, size, out, alphabet);
+    return 0;
+}
+
+#endif // STD_X86_SIMD
+
+} // namespace detail
+
+/*********************************************/
+/*  Hex                                      */
+/*********************************************/
+
+constexpr size_t hex_encoded_size(size_t size, size_t separator_length = 0) {
+    return size == 0 ? 0 : size * 2 + (size - 1) * separator_length;
+}
+
+// 'separator' goes between bytes, e.g. ":" for "de:ad:be:ef"
+constexpr size_t hex_encode(const uint8_t* data, size_t size, char* out, const char* separator = nullptr, bool upper = false) {
+    const size_t separator_length = detail::length_of(separator);
+    if (separator_length == 0) {
+        size_t done = 0;
+#if STD_X86_SIMD
+        if (!std::is_constant_evaluated()) done = detail::hex_encode_simd(data, size, out, upper);
+#endif
+        detail::hex_encode_swar(data + done, size - done, out + 2 * done, upper);
+        return size * 2;
+    }
+
+    const char* digits = upper ? detail::hex_upper : detail::hex_lower;
+    char* str = out;
+    for (size_t i = 0; i < size; i++) {
+        if (i != 0) {
+            for (size_t j = 0; j < separator_length; j++) *str++ = separator[j];
+        }
+        *str++ = digits[data[i] >> 4];
+        *str++ = digits[data[i] & 0xF];
+    }
+    return static_cast<size_t>(str - out);
+}
+
+template <AllocatorType Allocator>
+bool hex_encode(const uint8_t* data, size_t size, StringBase<char, Allocator>& out, const char* separator = nullptr, bool upper = false) {
+    const size_t separator_length = detail::length_of(separator);
+    if (!out.reserve(out.length() + hex_encoded_size(size, separator_length))) return false;
+
+    char chunk[65];
+    if (separator_length == 0) {
+        for (size_t i = 0; i < size; i += 32) {
+            const size_t bytes = size - i < 32 ? size - i : 32;
+            chunk[hex_encode(data + i, bytes, chunk, nullptr, upper)] = '\0';
+            out.concat(chunk);
+        }
+        return true;
+    }
+    for (size_t i = 0; i < size; i++) {
+        if (i != 0) out.concat(separator);
+        chunk[hex_encode(data + i, 1, chunk, nullptr, upper)] = '\0';
+        out.concat(chunk);
+    }
+    return true;
+}
+
+constexpr size_t hex_decoded_size(size_t length, size_t separator_length = 0) {
+    return (length + separator_length) / (2 + separator_length);
+}
+
+// Upper and lower case digits are accepted; a separator has to appear
+// between every pair of digits if one is given.
+constexpr ptrdiff_t hex_decode(const char* text, size_t length, uint8_t* out, const char* separator = nullptr) {
+    const size_t separator_length = detail::length_of(separator);
+    size_t count = 0;
+    for (size_t i = 0; i < length;) {
+        if (count != 0 && separator_length != 0) {
+            if (length - i < separator_length) return -1;
+            for (size_t j = 0; j < separator_length; j++) {
+                if (text[i + j] != separator[j]) return -1;
+            }
+            i += separator_length;
+        }
+        if (length - i < 2) return -1;
+        const auto high = detail::hex_value(text[i]);
+        const auto low = detail::hex_value(text[i + 1]);
+        if (high < 0 || low < 0) return -1;
+        out[count++] = static_cast<uint8_t>(high << 4 | low);
+        i += 2;
+    }
+    return static_cast<ptrdiff_t>(count);
+}
+
+/*********************************************/
+/*  Base64                                   */
+/*********************************************/
+
+constexpr size_t base64_encoded_size(size_t size, bool padding = true) {
+    if (padding) return (size + 2) / 3 * 4;
+    return size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+constexpr size_t base64_encode(const uint8_t* data, size_t size, char* out, Base64 alphabet = Base64::Standard, bool padding = true) {
+    const char* table = alphabet == Base64::Url ? detail::base64_url : detail::base64_standard;
+    size_t i = 0;
+#if STD_X86_SIMD
+    if (!std::is_constant_evaluated()) i = detail::base64_encode_simd(data, size, out, alphabet);
+#endif
+    char* str = out + i / 3 * 4;
+
+    for (; i + 3 <= size; i += 3) {
+        const uint32_t group = static_cast<uint32_t>(data[i]) << 16 | static_cast<uint32_t>(data[i + 1]) << 8 | data[i + 2];
+        str[0] = table[group >> 18];
+        str[1] = table[(group >> 12) & 0x3F];
+        str[2] = table[(group >> 6) & 0x3F];
+        str[3] = table[group & 0x3F];
+        str += 4;
+    }
+
+    if (size - i == 1) {
+        *str++ = table[data[i] >> 2];
+        *str++ = table[(data[i] & 0x03) << 4];
+        if (padding) {
+            *str++ = '=';
+            *str++ = '=';
+        }
+    } else if (size - i == 2) {
+        *str++ = table[data[i] >> 2];
+        *str++ = table[(data[i] & 0x03) << 4 | data[i + 1] >> 4];
+        *str++ = table[(data[i + 1] & 0x0F) << 2];
+        if (padding) *str++ = '=';
+    }
+    return static_cast<size_t>(str - out);
+}
+
+template <AllocatorType Allocator>
+bool base64_encode(const uint8_t* data, size_t size, StringBase<char, Allocator>& out, Base64 alphabet = Base64::Standard, bool padding = true) {
+    if (!out.reserve(out.length() + base64_encoded_size(size, padding))) return false;
+
+    // whole groups except for the last chunk, so padding only ends up at the end
+    char chunk[65];
+    for (size_t i = 0; i < size; i += 48) {
+        const size_t bytes = size - i < 48 ? size - i : 48;
+        chunk[base64_encode(data + i, bytes, chunk, alphabet, padding)] = '\0';
+        out.concat(chunk);
+    }
+    return true;
+}
+
+// Padding is optional; without it the length must not leave a single
+// character over.
+constexpr size_t base64_decoded_size(const char* text, size_t length) {
+    while (length != 0 && text[length - 1] == '=') length--;
+    return length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
+
+constexpr ptrdiff_t base64_decode(const char* text, size_t length, uint8_t* out, Base64 alphabet = Base64::Standard) {
+    size_t padding = 0;
+    while (length != 0 && text[length - 1] == '=' && padding < 2) {
+        length--;
+        padding++;
+    }
+    if ((padding != 0 && (length + padding) % 4 != 0) || length % 4 == 1) return -1;
+
+    uint8_t* bytes = out;
+    uint32_t group = 0;
+    uint8_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        const auto value = detail::base64_value(text[i], alphabet);
+        if (value < 0) return -1;
+        group = group << 6 | static_cast<uint32_t>(value);
+        if (++count == 4) {
+            *bytes++ = static_cast<uint8_t>(group >> 16);
+            *bytes++ = static_cast<uint8_t>(group >> 8);
+            *bytes++ = static_cast<uint8_t>(group);
+            group = 0;
+            count = 0;
+        }
+    }
+    if (count == 2) {
+        *bytes++ = static_cast<uint8_t>(group >> 4);
+    } else if (count == 3) {
+        *bytes++ = static_cast<uint8_t>(group >> 10);
+        *bytes++ = static_cast<uint8_t>(group >> 2);
+    }
+    return bytes - out;
+}
+
+/*********************************************/
+/*  Base32                                   */
+/*********************************************/
+
+constexpr size_t base32_encoded_size(size_t size, bool padding = true) {
+    if (padding) return (size + 4) / 5 * 8;
+    return (size * 8 + 4) / 5;
+}
+
+// Bits go through a 16-bit accumulator, which suits 8-bit MCUs better
+// than assembling 40-bit groups.
+constexpr size_t base32_encode(const uint8_t* data, size_t size, char* out, bool padding = true) {
+    char* str = out;
+    uint16_t buffer = 0;
+    uint8_t bits = 0;
+    for (size_t i = 0; i < size; i++) {
+        buffer = static_cast<uint16_t>(buffer << 8 | data[i]);
+        bits += 8;
+        while (bits >= 5) {
+            bits -= 5;
+            *str++ = detail::base32_alphabet[(buffer >> bits) & 0x1F];
+        }
+    }
+    if (bits != 0) *str++ = detail::base32_alphabet[(buffer << (5 - bits)) & 0x1F];
+    if (padding) {
+        while ((str - out) % 8 != 0) *str++ = '=';
+    }
+    return static_cast<size_t>(str - out);
+}
+
+template <AllocatorType Allocator>
+bool base32_encode(const uint8_t* data, size_t size, StringBase<char, Allocator>& out, bool padding = true) {
+    if (!out.reserve(out.length() + base32_encoded_size(size, padding))) return false;
+
+    char chunk[65];
+    for (size_t i = 0; i < size; i += 40) {
+        const size_t bytes = size - i < 40 ? size - i : 40;
+        chunk[base32_encode(data + i, bytes, chunk, padding)] = '\0';
+        out.concat(chunk);
+    }
+    return true;
+}
+
+constexpr size_t base32_decoded_size(const char* text, size_t length) {
+    while (length != 0 && text[length - 1] == '=') length--;
+    return length * 5 / 8;
+}
+
+// Padding is optional; lengths that can't come from whole bytes are rejected.
+constexpr ptrdiff_t base32_decode(const char* text, size_t length, uint8_t* out) {
+    const size_t padded = length;
+    while (length != 0 && text[length - 1] == '=') length--;
+    if (padded != length && padded % 8 != 0) return -1;
+    switch (length % 8) {
+        case 1: case 3: case 6: return -1;
+        default: break;
+    }
+
+    uint8_t* bytes = out;
+    uint16_t buffer = 0;
+    uint8_t bits = 0;
+    for (size_t i = 0; i < length; i++) {
+        const auto value = detail::base32_value(text[i]);
+        if (value < 0) return -1;
+        buffer = static_cast<uint16_t>(buffer << 5 | value);
+        bits += 5;
+        if (bits >= 8) {
+            bits -= 8;
+            *bytes++ = static_cast<uint8_t>(buffer >> bits);
+        }
+    }
+    return bytes - out;
+}
@@ -0,0 +1,219 @@
+#pragma once
+// Decimal fixed-point numbers: a Rep integer counting units of
+// 10^-DECIMALS, so 21.37 °C is fixed_point<2>::from_raw(2137). Sensor
+// readings keep their exact decimal digits, arithmetic is integer
+// arithmetic, and formatting and parsing go through utoa() and
+// format_decimal(), so no soft-float code gets linked on MCUs without an
+// FPU.
+//
+//   fixed_point<2> celsius = fixed_point<2>::from_raw(adc * 5);
+//   auto fahrenheit = celsius * fixed_point<2>(1.8) + 32;
+//   char text[fixed_point<2>::STRING_SIZE];
+//   fixtoa(fahrenheit, text);          // "70.47"
+//   String line("t=");
+//   line += celsius;                   // "t=21.37"
+//
+// Products and quotients round half away from zero and are computed in
+// the next wider integer; like the integers themselves, results that don't
+// fit Rep wrap. The floating-point constructor and conversion are there
+// for constants and for the host, not for hot paths on an MCU.
+#include <stddef.h>
+#include <stdint.h>
+#include <compare>
+#include <concepts>
+#include <type_traits>
+#include "stdlib.hpp"
+
+namespace detail {
+
+template <typename Rep>
+using wider_signed_t = std::conditional_t<sizeof(Rep) == 1, int16_t,
+                       std::conditional_t<sizeof(Rep) == 2, int32_t,
+#ifdef __SIZEOF_INT128__
+                       std::conditional_t<sizeof(Rep) == 4, int64_t, __int128>>>;
+#else
+                       int64_t>>;
+#endif
+
+// n / d rounded half away from zero, for d > 0
+template <typename W>
+constexpr W divide_rounded(W n, W d) {
+    return (n < 0 ? n - d / 2 : n + d / 2) / d;
+}
+
+} // namespace detail
+
+template <uint8_t DECIMALS, Int Rep = int32_t>
+class fixed_point {
+    using Unsigned = std::make_unsigned_t<Rep>;
+    using Wide = detail::wider_signed_t<Rep>;
+
+public:
+    static_assert(DECIMALS < detail::max_decimal_digits<Unsigned>, "fixed_point: the scale doesn't fit Rep");
+    static constexpr Rep SCALE = static_cast<Rep>(detail::power_of_10(DECIMALS));
+    // the longest text fixtoa() writes, terminator included
+    static constexpr size_t STRING_SIZE = 1 + detail::max_decimal_digits<Unsigned> + 1 + 1;
+
+    constexpr fixed_point() = default;
+
+    // whole numbers convert implicitly: celsius + 1, celsius < 100
+    template <std::integral I>
+    constexpr fixed_point(I integer) : m_raw(static_cast<Rep>(static_cast<Rep>(integer) * SCALE)) {}
+
+    template <std::floating_point F>
+    constexpr explicit fixed_point(F value) : m_raw(static_cast<Rep>(value < 0 ? value * SCALE - F(0.5) : value * SCALE + F(0.5))) {}
+
+    // the same number at another scale, rounded if that one is coarser
+    template <uint8_t OTHER, Int OtherRep>
+    constexpr explicit fixed_point(fixed_point<OTHER, OtherRep> other) {
+        if constexpr (OTHER <= DECIMALS) {
+            m_raw = static_cast<Rep>(static_cast<Rep>(other.raw()) * static_cast<Rep>(detail::power_of_10(DECIMALS - OTHER)));
+        } else {
+            using W = std::conditional_t<(sizeof(Wide) > sizeof(detail::wider_signed_t<OtherRep>)), Wide, detail::wider_signed_t<OtherRep>>;
+            m_raw = static_cast<Rep>(detail::divide_rounded<W>(other.raw(), static_cast<W>(detail::power_of_10(OTHER - DECIMALS))));
+        }
+    }
+
+    static constexpr fixed_point from_raw(Rep raw) {
+        fixed_point value;
+        value.m_raw = raw;
+        return value;
+    }
+
+    // in units of 10^-DECIMALS
+    constexpr Rep raw() const { return m_raw; }
+    // the whole part, truncated towards zero
+    constexpr Rep integer() const { return m_raw / SCALE; }
+    // the decimals as a number below SCALE, with the sign of the value
+    constexpr Rep fraction() const { return m_raw % SCALE; }
+
+    template <std::floating_point F>
+    constexpr explicit operator F() const { return static_cast<F>(m_raw) / static_cast<F>(SCALE); }
+
+    constexpr fixed_point operator-() const { return from_raw(static_cast<Rep>(-m_raw)); }
+    constexpr fixed_point operator+() const { return *this; }
+
+    constexpr fixed_point& operator+=(fixed_point other) { m_raw = static_cast<Rep>(m_raw + other.m_raw); return *this; }
+    constexpr fixed_point& operator-=(fixed_point other) { m_raw = static_cast<Rep>(m_raw - other.m_raw); return *this; }
+    constexpr fixed_point& operator*=(fixed_point other) {
+        static_assert(sizeof(Wide) > sizeof(Rep), "fixed_point: no wider integer to multiply in");
+        m_raw = static_cast<Rep>(detail::divide_rounded<Wide>(static_cast<Wide>(m_raw) * other.m_raw, SCALE));
+        return *this;
+    }
+    constexpr fixed_point& operator/=(fixed_point other) {
+        static_assert(sizeof(Wide) > sizeof(Rep), "fixed_point: no wider integer to divide in");
+        Wide divisor = other.m_raw;
+        Wide dividend = static_cast<Wide>(m_raw) * SCALE;
+        if (divisor < 0) {
+            divisor = -divisor;
+            dividend = -dividend;
+        }
+        m_raw = static_cast<Rep>(detail::divide_rounded<Wide>(dividend, divisor));
+        return *this;
+    }
+    // scaling by a whole number needs no rescaling
+    template <std::integral I> constexpr fixed_point& operator*=(I factor) { m_raw = static_cast<Rep>(m_raw * factor); return *this; }
+    template <std::integral I> constexpr fixed_point& operator/=(I divisor) {
+        const Wide d = divisor < 0 ? -static_cast<Wide>(divisor) : static_cast<Wide>(divisor);
+        const Wide n = divisor < 0 ? -static_cast<Wide>(m_raw) : static_cast<Wide>(m_raw);
+        m_raw = static_cast<Rep>(detail::divide_rounded<Wide>(n, d));
+        return *this;
+    }
+
+    friend constexpr fixed_point operator+(fixed_point a, fixed_point b) { return a += b; }
+    friend constexpr fixed_point operator-(fixed_point a, fixed_point b) { return a -= b; }
+    friend constexpr fixed_point operator*(fixed_point a, fixed_point b) { return a *= b; }
+    friend constexpr fixed_point operator/(fixed_point a, fixed_point b) { return a /= b; }
+    template <std::integral I> friend constexpr fixed_point operator*(fixed_point a, I b) { return a *= b; }
+    template <std::integral I> friend constexpr fixed_point operator*(I a, fixed_point b) { return b *= a; }
+    template <std::integral I> friend constexpr fixed_point operator/(fixed_point a, I b) { return a /= b; }
+
+    friend constexpr bool operator==(fixed_point, fixed_point) = default;
+    friend constexpr auto operator<=>(fixed_point, fixed_point) = default;
+
+    // Reads [-+]digits[.digits]: at least one digit, nothing else. Decimals
+    // past DECIMALS round the last one. False, leaving 'out' alone, for
+    // anything else or a number out of range.
+    static constexpr bool parse(const char* text, size_t length, fixed_point& out) {
+        size_t i = 0;
+        const bool negative = length > 0 && text[0] == '-';
+        if (length > 0 && (text[0] == '-' || text[0] == '+')) i++;
+
+        const Unsigned limit = static_cast<Unsigned>(static_cast<Unsigned>(~Unsigned{0}) >> 1) + negative;
+        const Unsigned whole_limit = limit / static_cast<Unsigned>(SCALE);
+        bool digits = false;
+        Unsigned whole = 0;
+        for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+            const auto digit = static_cast<Unsigned>(text[i] - '0');
+            if (digit > whole_limit || whole > (whole_limit - digit) / 10) return false;
+            whole = static_cast<Unsigned>(whole * 10 + digit);
+            digits = true;
+        }
+
+        Unsigned fraction = 0;
+        if (i < length && text[i] == '.') {
+            i++;
+            uint8_t decimals = 0;
+            for (; i < length && text[i] >= '0' && text[i] <= '9'; i++, digits = true) {
+                if (decimals < DECIMALS) {
+                    fraction = static_cast<Unsigned>(fraction * 10 + (text[i] - '0'));
+                    decimals++;
+                } else if (decimals == DECIMALS) {
+                    fraction += text[i] >= '5'; // may carry into the whole part
+                    decimals++;
+                }
+            }
+            for (; decimals < DECIMALS; decimals++) fraction = static_cast<Unsigned>(fraction * 10);
+        }
+        if (!digits || i != length) return false;
+
+        const auto scaled = static_cast<Unsigned>(whole * static_cast<Unsigned>(SCALE));
+        if (fraction > limit - scaled) return false;
+        const auto magnitude = static_cast<Unsigned>(scaled + fraction);
+        out.m_raw = static_cast<Rep>(negative ? static_cast<Unsigned>(0 - magnitude) : magnitude);
+        return true;
+    }
+
+    static constexpr bool parse(const char* cstr, fixed_point& out) {
+        size_t length = 0;
+        while (cstr[length]) length++;
+        return parse(cstr, length, out);
+    }
+
+private:
+    Rep m_raw{0};
+};
+
+template <typename T> struct is_fixed_point : std::false_type {};
+template <uint8_t DECIMALS, typename Rep> struct is_fixed_point<fixed_point<DECIMALS, Rep>> : std::true_type {};
+
+// Writes the value with all DECIMALS decimals ("-3.50") and a terminator,
+// like itoa(); 'str' needs fixed_point<...>::STRING_SIZE bytes.
+template <uint8_t DECIMALS, Int Rep>
+constexpr char* fixtoa(fixed_point<DECIMALS, Rep> value, char* str) {
+    using Unsigned = std::make_unsigned_t<Rep>;
+    auto magnitude = static_cast<Unsigned>(value.raw());
+    char* out = str;
+    if (value.raw() < 0) {
+        magnitude = static_cast<Unsigned>(0 - magnitude);
+        *out++ = '-';
+    }
+
+    constexpr auto SCALE = static_cast<Unsigned>(fixed_point<DECIMALS, Rep>::SCALE);
+    Unsigned whole = 0;
+    // without a hardware divider this multiplies by the reciprocal
+    if constexpr (DECIMALS <= 9) whole = detail::divide<static_cast<uint32_t>(SCALE)>(magnitude);
+    else whole = magnitude / SCALE;
+    const auto fraction = static_cast<Unsigned>(magnitude - whole * SCALE);
+    utoa(whole, out);
+    out += count_digits(whole, 10);
+    if constexpr (DECIMALS > 0) {
+        *out++ = '.';
+        // format_decimal() right-aligns the digits; the zeros pad the left
+        for (uint8_t i = 0; i < DECIMALS; i++) out[i] = '0';
+        format_decimal(fraction, out, DECIMALS);
+        out += DECIMALS;
+    }
+    *out = '\0';
+    return str;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <stddef.h>
+#include <initializer_list>
+#include <utility>
+#include "static_vector.hpp"
+
+// Sorted associative array with a fixed capacity. Entries live contiguously
+// in key order, so lookup is a binary search over a single block of memory
+// and iteration is in key order. Lookups accept any type comparable with
+// the key (e.g. a StringView for String keys) without building a Key.
+template <typename Key, typename Value, size_t SIZE>
+class flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using storage_type = static_vector<value_type, SIZE>;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    constexpr flat_map() = default;
+
+    constexpr flat_map(std::initializer_list<value_type> values) {
+        for (const auto& value : values) {
+            insert(value.first, value.second);
+        }
+    }
+
+    constexpr iterator begin() noexcept { return m_entries.begin(); }
+    constexpr iterator end() noexcept { return m_entries.end(); }
+    constexpr const_iterator begin() const noexcept { return m_entries.begin(); }
+    constexpr const_iterator end() const noexcept { return m_entries.end(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_entries.empty(); }
+    constexpr bool full() const noexcept { return m_entries.full(); }
+    constexpr size_type size() const noexcept { return m_entries.size(); }
+    static constexpr size_type capacity() noexcept { return SIZE; }
+
+    // return true if inserted, false if the key exists or the map is full
+    constexpr bool insert(const Key& key, Value value) {
+        const auto index = lower_bound(key);
+        if (index < size() && equal(m_entries[index].first, key)) return false;
+        return m_entries.insert(index, value_type{key, std::move(value)});
+    }
+
+    constexpr bool insert_or_assign(const Key& key, Value value) {
+        const auto index = lower_bound(key);
+        if (index < size() && equal(m_entries[index].first, key)) {
+            m_entries[index].second = std::move(value);
+            return true;
+        }
+        return m_entries.insert(index, value_type{key, std::move(value)});
+    }
+
+    template <typename K>
+    constexpr iterator find(const K& key) {
+        const auto index = lower_bound(key);
+        if (index < size() && equal(m_entries[index].first, key)) return iterator{ m_entries.data() + index };
+        return end();
+    }
+
+    template <typename K>
+    constexpr const_iterator find(const K& key) const {
+        const auto index = lower_bound(key);
+        if (index < size() && equal(m_entries[index].first, key)) return const_iterator{ m_entries.data() + index };
+        return end();
+    }
+
+    template <typename K>
+    constexpr bool contains(const K& key) const { return find(key) != end(); }
+
+    // nullptr when the key is missing
+    template <typename K>
+    constexpr Value* get(const K& key) {
+        auto it = find(key);
+        return it == end() ? nullptr : &it->second;
+    }
+
+    template <typename K>
+    constexpr const Value* get(const K& key) const {
+        auto it = find(key);
+        return it == end() ? nullptr : &it->second;
+    }
+
+    template <typename K>
+    constexpr bool erase(const K& key) {
+        const auto index = lower_bound(key);
+        if (index >= size() || !equal(m_entries[index].first, key)) return false;
+        m_entries.erase(index);
+        return true;
+    }
+
+    constexpr void clear() { m_entries.clear(); }
+
+private:
+    template <typename K>
+    constexpr size_type lower_bound(const K& key) const {
+        size_type first = 0;
+        size_type count = size();
+        while (count > 0) {
+            const auto step = count / 2;
+            if (m_entries[first + step].first < key) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    template <typename K>
+    static constexpr bool equal(const Key& a, const K& b) { return !(a < b) && !(b < a); }
+
+    storage_type m_entries{};
+};
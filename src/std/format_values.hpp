@@ -0,0 +1,127 @@
+#pragma once
+// Formats a whole buffer of integers at once, e.g. a block of ADC readings
+// as one CSV line:
+//
+//   array<uint16_t, 64> samples = ...;
+//   String line;
+//   format_values(samples, line, ",");  // "512,498,1023,..."
+//
+// The exact length is worked out first, so a StringBase grows once and
+// nothing is formatted into a temporary. The values are then written back
+// to front straight into place by the same format_decimal()/format_hex()/...
+// as utoa(), which already write backwards and so need no second count of
+// the digits.
+//
+// Like the encoders in encoding.hpp, the buffer versions write no
+// terminator and return the number of characters; formatted_size() gives
+// that number up front.
+#include <stddef.h>
+#include <stdint.h>
+#include <concepts>
+#include <type_traits>
+#include "String.hpp"
+#include "stdlib.hpp"
+
+// bool isn't a number to print
+template <typename T> concept FormattableInteger = std::integral<T> && !std::is_same_v<T, bool>;
+
+template <typename T> concept IntegerRange = requires(const T& values) {
+    { values.data() } -> std::convertible_to<const void*>;
+    values.size();
+} && FormattableInteger<std::remove_cvref_t<decltype(*std::declval<const T&>().data())>>;
+
+namespace detail {
+
+template <std::integral T>
+constexpr std::make_unsigned_t<T> magnitude(T value) {
+    using Unsigned = std::make_unsigned_t<T>;
+    const auto bits = static_cast<Unsigned>(value);
+    if constexpr (std::is_signed_v<T>) return value < 0 ? static_cast<Unsigned>(0 - bits) : bits;
+    else return bits;
+}
+
+constexpr size_t separator_length(const char* separator) {
+    size_t length = 0;
+    if (separator) {
+        while (separator[length]) length++;
+    }
+    return length;
+}
+
+} // namespace detail
+
+// Characters format_values() writes for these values, without a terminator;
+// none in a base outside 2 to 36
+template <FormattableInteger T>
+constexpr size_t formatted_size(const T* values, size_t count, const char* separator = ",", uint8_t base = 10) {
+    if (count == 0 || !valid_base(base)) return 0;
+    size_t size = (count - 1) * detail::separator_length(separator);
+    for (size_t i = 0; i < count; i++) {
+        if constexpr (std::is_signed_v<T>) size += values[i] < 0;
+        size += count_digits(detail::magnitude(values[i]), base);
+    }
+    return size;
+}
+
+namespace detail {
+
+// Writes the values back to front so that the last one ends at 'end'
+template <FormattableInteger T>
+constexpr void format_values_before(const T* values, size_t count, char* out, char* end, const char* separator, uint8_t base) {
+    // the most digits a value can have in any base: the room to format it
+    // in while its start isn't known yet
+    constexpr uint8_t WIDEST = 8 * sizeof(T);
+    const size_t length = separator_length(separator);
+    for (size_t i = count; i-- > 0;) {
+        const size_t before = static_cast<size_t>(end - out);
+        const auto room = static_cast<uint8_t>(before < WIDEST ? before : WIDEST);
+        end = format_base(magnitude(values[i]), end - room, base, room);
+        if constexpr (std::is_signed_v<T>) {
+            if (values[i] < 0) *--end = '-';
+        }
+        if (i > 0) {
+            end -= length;
+            for (size_t c = 0; c < length; c++) end[c] = separator[c];
+        }
+    }
+}
+
+} // namespace detail
+
+// Writes 'count' values in 'base' with 'separator' between them into 'out',
+// which needs formatted_size() characters; returns how many were written.
+template <FormattableInteger T>
+constexpr size_t format_values(const T* values, size_t count, char* out, const char* separator = ",", uint8_t base = 10) {
+    const size_t size = formatted_size(values, count, separator, base);
+    if (size == 0) return 0;
+    detail::format_values_before(values, count, out, out + size, separator, base);
+    return size;
+}
+
+// Appends the values to 'out'; false (and 'out' unchanged) when there's no
+// memory for them
+template <FormattableInteger T, AllocatorType Allocator>
+bool format_values(const T* values, size_t count, StringBase<char, Allocator>& out, const char* separator = ",", uint8_t base = 10) {
+    const size_t size = formatted_size(values, count, separator, base);
+    if (size == 0) return true;
+    char* str = out.extend(size);
+    if (!str) return false;
+    detail::format_values_before(values, count, str, str + size, separator, base);
+    return true;
+}
+
+// array<T, N>, static_vector<T, N> or anything else with data() and size()
+template <IntegerRange Range>
+constexpr size_t formatted_size(const Range& values, const char* separator = ",", uint8_t base = 10) {
+    return formatted_size(values.data(), values.size(), separator, base);
+}
+
+template <IntegerRange Range>
+constexpr size_t format_values(const Range& values, char* out, const char* separator = ",", uint8_t base = 10) {
+    return format_values(values.data(), values.size(), out, separator, base);
+}
+
+template <IntegerRange Range, AllocatorType Allocator>
+bool format_values(const Range& values, StringBase<char, Allocator>& out, const char* separator = ",", uint8_t base = 10) {
+    return format_values(values.data(), values.size(), out, separator, base);
+}
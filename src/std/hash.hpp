@@ -0,0 +1,291 @@
+#pragma once
+// String hashing that works the same at compile time and at runtime:
+// FNV-1a (32 and 64-bit), which is cheap on 8-bit MCUs, and a wyhash-style
+// hash that reads eight bytes at a time for longer keys on 32/64-bit CPUs.
+// CommandTable builds a perfect hash over a fixed set of names at compile
+// time, so dispatching an incoming command costs one hash and one compare.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "StringView.hpp"
+
+/*********************************************/
+/*  FNV-1a                                   */
+/*********************************************/
+
+constexpr uint32_t FNV1A_BASIS = 0x811c9dc5u;
+constexpr uint64_t FNV1A64_BASIS = 0xcbf29ce484222325ull;
+
+// 'basis' is the offset basis; a different one gives an independent hash
+constexpr uint32_t fnv1a(const char* data, size_t length, uint32_t basis = FNV1A_BASIS) {
+    uint32_t hash = basis;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+constexpr uint32_t fnv1a(StringView text, uint32_t basis = FNV1A_BASIS) {
+    return fnv1a(text.data(), text.length(), basis);
+}
+
+constexpr uint64_t fnv1a64(const char* data, size_t length, uint64_t basis = FNV1A64_BASIS) {
+    uint64_t hash = basis;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x00000100000001b3ull;
+    }
+    return hash;
+}
+
+constexpr uint64_t fnv1a64(StringView text, uint64_t basis = FNV1A64_BASIS) {
+    return fnv1a64(text.data(), text.length(), basis);
+}
+
+// "status"_hash == fnv1a(String("status")), usable as a case label
+consteval uint32_t operator""_hash(const char* str, size_t length) {
+    return fnv1a(str, length);
+}
+
+/*********************************************/
+/*  wyhash                                   */
+/*********************************************/
+
+namespace detail {
+
+// 64 x 64 -> 128-bit multiply; low half in 'a', high half in 'b'
+constexpr void multiply128(uint64_t& a, uint64_t& b) {
+#ifdef __SIZEOF_INT128__
+    const auto product = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t a_high = a >> 32, a_low = static_cast<uint32_t>(a);
+    const uint64_t b_high = b >> 32, b_low = static_cast<uint32_t>(b);
+    const uint64_t high = a_high * b_high, middle0 = a_high * b_low, middle1 = b_high * a_low, low = a_low * b_low;
+    const uint64_t t = low + (middle0 << 32);
+    uint64_t carry = t < low;
+    const uint64_t result_low = t + (middle1 << 32);
+    carry += result_low < t;
+    a = result_low;
+    b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+constexpr uint64_t mix(uint64_t a, uint64_t b) {
+    multiply128(a, b);
+    return a ^ b;
+}
+
+// little-endian loads; the byte loop is for constant evaluation and
+// big-endian CPUs
+constexpr uint64_t read64(const char* p) {
+    if constexpr (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) {
+        if (!std::is_constant_evaluated()) {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    }
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < 8; i++) value |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    return value;
+}
+
+constexpr uint64_t read32(const char* p) {
+    if constexpr (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) {
+        if (!std::is_constant_evaluated()) {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    }
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < 4; i++) value |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    return value;
+}
+
+constexpr uint64_t read_small(const char* p, size_t length) {
+    return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16 | static_cast<uint64_t>(static_cast<uint8_t>(p[length >> 1])) << 8 | static_cast<uint8_t>(p[length - 1]);
+}
+
+inline constexpr uint64_t WYHASH_SECRET[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+} // namespace detail
+
+// Follows wyhash final4 by Wang Yi: keys up to 16 bytes are read as two
+// overlapping words, longer ones 16 or 48 bytes per step, and everything is
+// folded with a 128-bit multiply. Not for 8-bit MCUs, where the multiply is
+// a long library call; use fnv1a() there.
+constexpr uint64_t wyhash(const char* data, size_t length, uint64_t seed = 0) {
+    using detail::mix;
+    using detail::read32;
+    using detail::read64;
+    constexpr auto& secret = detail::WYHASH_SECRET;
+
+    seed ^= mix(seed ^ secret[0], secret[1]);
+    uint64_t a = 0, b = 0;
+    if (length <= 16) {
+        if (length >= 4) {
+            a = read32(data) << 32 | read32(data + ((length >> 3) << 2));
+            b = read32(data + length - 4) << 32 | read32(data + length - 4 - ((length >> 3) << 2));
+        } else if (length > 0) {
+            a = detail::read_small(data, length);
+        }
+    } else {
+        const char* p = data;
+        size_t remaining = length;
+        if (remaining > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                see1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ see1);
+                see2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ see2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (remaining > 16) {
+            seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read64(p + remaining - 16);
+        b = read64(p + remaining - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    detail::multiply128(a, b);
+    return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+constexpr uint64_t wyhash(StringView text, uint64_t seed = 0) {
+    return wyhash(text.data(), text.length(), seed);
+}
+
+/*********************************************/
+/*  Perfect hash command table               */
+/*********************************************/
+
+namespace detail {
+
+// Never defined: reaching a call while building a CommandTable makes the
+// consteval evaluation fail with this name in the diagnostic.
+void command_table_has_duplicate_or_unhashable_names();
+void command_table_unknown_name();
+
+constexpr size_t bit_ceil(size_t value) {
+    size_t power = 1;
+    while (power < value) power <<= 1;
+    return power;
+}
+
+constexpr uint8_t log2(size_t power) {
+    uint8_t bits = 0;
+    while (power >>= 1) bits++;
+    return bits;
+}
+
+} // namespace detail
+
+// Hash and displace: the FNV-1a hash of a name picks a bucket, and every
+// bucket stores the displacement that sends its names to free slots. The
+// displacements are searched at compile time, biggest buckets first.
+//
+//   constexpr auto commands = make_command_table("help", "status", "reset");
+//   switch (commands.find(input)) {
+//       case commands.index("help"): ...
+//       case commands.index("status"): ...
+//       default: // unknown command, find() returned -1
+//   }
+template <size_t N>
+class CommandTable {
+    static_assert(N > 0 && N < 255, "CommandTable: 1 to 254 names");
+public:
+    static constexpr size_t SLOTS = detail::bit_ceil(N) * 2;
+    static constexpr size_t BUCKETS = detail::bit_ceil((N + 1) / 2);
+
+    consteval explicit CommandTable(const StringView (&names)[N]) {
+        uint32_t hashes[N]{};
+        uint8_t bucket_size[BUCKETS]{};
+        for (size_t i = 0; i < N; i++) {
+            m_names[i] = names[i];
+            hashes[i] = fnv1a(names[i]);
+            bucket_size[hashes[i] & (BUCKETS - 1)]++;
+        }
+
+        bool placed[BUCKETS]{};
+        for (size_t round = 0; round < BUCKETS; round++) {
+            size_t bucket = 0;
+            for (size_t b = 0; b < BUCKETS; b++) {
+                if (!placed[b] && (placed[bucket] || bucket_size[b] > bucket_size[bucket])) bucket = b;
+            }
+            placed[bucket] = true;
+            if (bucket_size[bucket] == 0) continue;
+
+            bool found = false;
+            for (unsigned displacement = 0; displacement < 256 && !found; displacement++) {
+                found = true;
+                for (size_t i = 0; i < N && found; i++) {
+                    if ((hashes[i] & (BUCKETS - 1)) != bucket) continue;
+                    const auto s = slot(hashes[i], static_cast<uint8_t>(displacement));
+                    if (m_slots[s] != 0) {
+                        found = false;
+                        break;
+                    }
+                    m_slots[s] = static_cast<uint8_t>(i + 1);
+                }
+                if (!found) {
+                    // undo this attempt
+                    for (auto& s : m_slots) {
+                        if (s != 0 && (hashes[s - 1] & (BUCKETS - 1)) == bucket) s = 0;
+                    }
+                } else {
+                    m_displacements[bucket] = static_cast<uint8_t>(displacement);
+                }
+            }
+            if (!found) detail::command_table_has_duplicate_or_unhashable_names();
+        }
+    }
+
+    // index of 'text' in the list the table was made from, -1 if it isn't one
+    constexpr int find(StringView text) const {
+        const auto hash = fnv1a(text);
+        const auto entry = m_slots[slot(hash, m_displacements[hash & (BUCKETS - 1)])];
+        if (entry == 0 || !(m_names[entry - 1] == text)) return -1;
+        return entry - 1;
+    }
+
+    constexpr bool contains(StringView text) const { return find(text) >= 0; }
+
+    // for case labels; names that aren't in the table don't compile
+    consteval int index(StringView name) const {
+        const auto i = find(name);
+        if (i < 0) detail::command_table_unknown_name();
+        return i;
+    }
+
+    constexpr StringView operator[](size_t index) const { return m_names[index]; }
+    constexpr size_t size() const { return N; }
+
+private:
+    static constexpr uint8_t SLOT_BITS = detail::log2(SLOTS);
+
+    static constexpr uint32_t slot(uint32_t hash, uint8_t displacement) {
+        return ((hash ^ displacement * 0x9e3779b9u) * 0x85ebca6bu) >> (32 - SLOT_BITS);
+    }
+
+    StringView m_names[N]{};
+    uint8_t m_displacements[BUCKETS]{};
+    uint8_t m_slots[SLOTS]{}; // index + 1 into m_names, 0 when empty
+};
+
+template <typename... Names>
+consteval auto make_command_table(const Names&... names) {
+    const StringView views[] = {StringView(names)...};
+    return CommandTable<sizeof...(Names)>(views);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stddef.h>
+#include <compare>
+#include <iterator>
+#include <type_traits>
+
+// Pointer wrapper that models std::contiguous_iterator, shared by the
+// containers that keep their elements in one block (array, static_vector,
+// flat_map). Standard algorithms see it as a raw pointer, so std::sort,
+// std::lower_bound and auto-vectorized loops all work on it.
+template <typename T>
+class contiguous_iterator {
+    T* m_ptr{nullptr};
+public:
+    using iterator_concept  = std::contiguous_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::remove_cv_t<T>;
+    using element_type      = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+    constexpr contiguous_iterator() = default;
+    constexpr explicit contiguous_iterator(pointer ptr) : m_ptr(ptr) {}
+
+    // iterator -> const_iterator
+    template <typename U> requires std::is_convertible_v<U*, T*>
+    constexpr contiguous_iterator(const contiguous_iterator<U>& other) : m_ptr(other.get()) {}
+
+    constexpr reference operator*() const { return *m_ptr; }
+    constexpr pointer operator->() const { return m_ptr; }
+    constexpr reference operator[](difference_type n) const { return m_ptr[n]; }
+    constexpr pointer get() const { return m_ptr; }
+
+    constexpr contiguous_iterator& operator++() { m_ptr++; return *this; }
+    constexpr contiguous_iterator operator++(int) { contiguous_iterator retval = *this; ++(*this); return retval; }
+    constexpr contiguous_iterator& operator--() { m_ptr--; return *this; }
+    constexpr contiguous_iterator operator--(int) { contiguous_iterator retval = *this; --(*this); return retval; }
+    constexpr contiguous_iterator& operator+=(difference_type n) { m_ptr += n; return *this; }
+    constexpr contiguous_iterator& operator-=(difference_type n) { m_ptr -= n; return *this; }
+
+    constexpr friend contiguous_iterator operator+(contiguous_iterator it, difference_type n) { return it += n; }
+    constexpr friend contiguous_iterator operator+(difference_type n, contiguous_iterator it) { return it += n; }
+    constexpr friend contiguous_iterator operator-(contiguous_iterator it, difference_type n) { return it -= n; }
+    constexpr friend difference_type operator-(const contiguous_iterator& a, const contiguous_iterator& b) { return a.m_ptr - b.m_ptr; }
+
+    constexpr friend bool operator==(const contiguous_iterator& a, const contiguous_iterator& b) { return a.m_ptr == b.m_ptr; }
+    constexpr friend auto operator<=>(const contiguous_iterator& a, const contiguous_iterator& b) { return a.m_ptr <=> b.m_ptr; }
+};
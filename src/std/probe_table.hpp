@@ -0,0 +1,81 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "StringView.hpp"
+#include "hash.hpp"
+
+namespace detail {
+
+// The slot table behind string_map and string_pool: 2^k slots for at most
+// SIZE strings, so it is never more than two thirds full, probed linearly
+// from the FNV-1a hash of the key. A slot holds the index of the string in
+// its container and 16 bits of the hash, so a probe only compares strings
+// when those match. The container passes a key_of(index) that returns the
+// string at an index.
+template <size_t SIZE>
+class probe_table {
+    static_assert(SIZE > 0 && SIZE < 65535, "probe_table: 1 to 65534 strings");
+
+public:
+    using index_type = std::conditional_t<(SIZE < 255), uint8_t, uint16_t>;
+
+    static constexpr size_t SLOTS = bit_ceil(SIZE + SIZE / 2 + 1);
+    static constexpr uint8_t SLOT_BITS = log2(SLOTS);
+    static constexpr index_type EMPTY = static_cast<index_type>(~index_type{0});
+
+    // true and the key's slot, or false and the empty slot where it would go
+    template <typename KeyOf>
+    constexpr bool locate(StringView key, uint32_t hash, size_t& slot, const KeyOf& key_of) const {
+        for (slot = home(hash);; slot = next(slot)) {
+            const auto& s = m_slots[slot];
+            if (s.index == EMPTY) return false;
+            if (s.tag == tag(hash) && key_of(s.index) == key) return true;
+        }
+    }
+
+    // the index stored in a slot that locate() found
+    constexpr index_type operator[](size_t slot) const { return m_slots[slot].index; }
+
+    // fills the empty slot that locate() returned, or repoints a full one
+    constexpr void assign(size_t slot, size_t index, uint32_t hash) {
+        m_slots[slot] = Slot{static_cast<index_type>(index), tag(hash)};
+    }
+    constexpr void repoint(size_t slot, size_t index) { m_slots[slot].index = static_cast<index_type>(index); }
+
+    // Backward shift deletion: later slots of the probe run move into the
+    // hole unless that would put them before their home slot, so there are
+    // no tombstones.
+    template <typename KeyOf>
+    constexpr void remove(size_t hole, const KeyOf& key_of) {
+        for (size_t slot = next(hole); m_slots[slot].index != EMPTY; slot = next(slot)) {
+            const auto wanted = home(fnv1a(key_of(m_slots[slot].index)));
+            // distance from home, in probe order, for the hole and the slot
+            const auto hole_distance = (hole - wanted) & (SLOTS - 1);
+            const auto slot_distance = (slot - wanted) & (SLOTS - 1);
+            if (hole_distance <= slot_distance) {
+                m_slots[hole] = m_slots[slot];
+                hole = slot;
+            }
+        }
+        m_slots[hole] = Slot{};
+    }
+
+    constexpr void clear() {
+        for (auto& slot : m_slots) slot = Slot{};
+    }
+
+private:
+    struct Slot {
+        index_type index{EMPTY};
+        uint16_t tag{0};
+    };
+
+    static constexpr size_t home(uint32_t hash) { return hash >> (32 - SLOT_BITS); }
+    static constexpr uint16_t tag(uint32_t hash) { return static_cast<uint16_t>(hash); }
+    static constexpr size_t next(size_t slot) { return (slot + 1) & (SLOTS - 1); }
+
+    Slot m_slots[SLOTS]{};
+};
+
+} // namespace detail
@@ -0,0 +1,30 @@
+#pragma once
+// How the bulk routines of char_traits.hpp, utf8.hpp and encoding.hpp look
+// at more than one character at a time.
+//
+// x86-64 hosts use SSE2, which every x86-64 CPU has, so those paths need no
+// check; wider kernels are compiled with a target attribute and picked with
+// __builtin_cpu_supports(). Other 32 and 64-bit CPUs use SWAR: plain integer
+// arithmetic on a register's worth of characters. 8-bit MCUs have nothing
+// to gain from either and loop over the characters. Defining STD_NO_SIMD
+// leaves out the x86 paths, e.g. to run the SWAR code on the host.
+#include <stdint.h>
+#include <type_traits>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(STD_NO_SIMD)
+#define STD_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define STD_X86_SIMD 0
+#endif
+
+namespace detail {
+
+// the register-wide integer the SWAR paths work on
+using Word = std::conditional_t<sizeof(void*) >= 8, uint64_t, uint32_t>;
+using AliasedWord __attribute__((__may_alias__)) = Word;
+
+// SWAR only pays off where a register holds four bytes or more
+inline constexpr bool USE_WORDS = sizeof(void*) >= 4;
+
+} // namespace detail
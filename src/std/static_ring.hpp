@@ -0,0 +1,102 @@
+#pragma once
+#include <stddef.h>
+#include <iterator>
+#include <utility>
+
+// Double-ended ring buffer with a power-of-two capacity. The read and write
+// counters run freely and are reduced with a mask instead of a modulo, so
+// there is no division and no wasted slot to tell full from empty.
+template <typename T, size_t SIZE>
+class static_ring {
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "static_ring: size must be a power of two");
+    static constexpr size_t MASK = SIZE - 1;
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using difference_type = std::ptrdiff_t;
+    using size_type = size_t;
+
+    template <typename Ring, typename Ref>
+    class basic_iterator {
+        Ring* m_ring{nullptr};
+        size_type m_index{0};
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = Ref;
+
+        constexpr basic_iterator() = default;
+        constexpr basic_iterator(Ring* ring, size_type index) : m_ring(ring), m_index(index) {}
+        constexpr basic_iterator& operator++() { m_index++; return *this; }
+        constexpr basic_iterator operator++(int) { basic_iterator retval = *this; ++(*this); return retval; }
+        constexpr friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.m_index == b.m_index; }
+        constexpr reference operator*() const { return (*m_ring)[m_index]; }
+    };
+
+    using iterator = basic_iterator<static_ring, T&>;
+    using const_iterator = basic_iterator<const static_ring, const T&>;
+
+    constexpr iterator begin() noexcept { return iterator{ this, 0 }; }
+    constexpr iterator end() noexcept { return iterator{ this, size() }; }
+    constexpr const_iterator begin() const noexcept { return const_iterator{ this, 0 }; }
+    constexpr const_iterator end() const noexcept { return const_iterator{ this, size() }; }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_head == m_tail; }
+    constexpr bool full() const noexcept { return size() == SIZE; }
+    constexpr size_type size() const noexcept { return m_tail - m_head; }
+    static constexpr size_type capacity() noexcept { return SIZE; }
+
+    // Index 0 is the oldest element
+    constexpr reference       operator[](size_type n) { return m_array[(m_head + n) & MASK]; }
+    constexpr const_reference operator[](size_type n) const { return m_array[(m_head + n) & MASK]; }
+    constexpr reference       front() { return m_array[m_head & MASK]; }
+    constexpr const_reference front() const { return m_array[m_head & MASK]; }
+    constexpr reference       back() { return m_array[(m_tail - 1) & MASK]; }
+    constexpr const_reference back() const { return m_array[(m_tail - 1) & MASK]; }
+
+    // return true on success, false when the ring is full
+    constexpr bool push_back(T value) {
+        if (full()) return false;
+        m_array[m_tail++ & MASK] = std::move(value);
+        return true;
+    }
+
+    constexpr bool push_front(T value) {
+        if (full()) return false;
+        m_array[--m_head & MASK] = std::move(value);
+        return true;
+    }
+
+    // Drops the oldest element when full; the usual mode for sample buffers
+    constexpr void push_overwrite(T value) {
+        if (full()) m_head++;
+        m_array[m_tail++ & MASK] = std::move(value);
+    }
+
+    // return true and move the element into 'out', or false when empty
+    constexpr bool pop_front(T& out) {
+        if (empty()) return false;
+        out = std::move(m_array[m_head++ & MASK]);
+        return true;
+    }
+
+    constexpr bool pop_back(T& out) {
+        if (empty()) return false;
+        out = std::move(m_array[--m_tail & MASK]);
+        return true;
+    }
+
+    constexpr void pop_front() { if (!empty()) m_head++; }
+    constexpr void pop_back() { if (!empty()) m_tail--; }
+
+    constexpr void clear() { m_head = m_tail = 0; }
+
+private:
+    T m_array[SIZE]{};
+    size_type m_head{0};
+    size_type m_tail{0};
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <stddef.h>
+#include <initializer_list>
+#include <utility>
+#include "iterator.hpp"
+
+// Vector with a fixed capacity and inline storage (never touches the heap).
+// Elements past size() are kept default-constructed, so T must be default
+// constructible; this keeps the whole container usable in constant
+// expressions. Operations that would exceed the capacity fail and return
+// false instead of growing.
+template <typename T, size_t SIZE>
+class static_vector {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using difference_type = std::ptrdiff_t;
+    using size_type = size_t;
+
+    using iterator = contiguous_iterator<T>;
+    using const_iterator = contiguous_iterator<const T>;
+
+    constexpr static_vector() = default;
+
+    constexpr static_vector(std::initializer_list<T> values) {
+        for (const auto& value : values) {
+            if (!push_back(value)) break;
+        }
+    }
+
+    constexpr iterator begin() noexcept { return iterator{ m_array }; }
+    constexpr iterator end() noexcept { return iterator{ m_array + m_size }; }
+    constexpr const_iterator begin() const noexcept { return const_iterator{ m_array }; }
+    constexpr const_iterator end() const noexcept { return const_iterator{ m_array + m_size }; }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr bool full() const noexcept { return m_size == SIZE; }
+    constexpr size_type size() const noexcept { return m_size; }
+    static constexpr size_type capacity() noexcept { return SIZE; }
+    static constexpr size_type max_size() noexcept { return SIZE; }
+
+    constexpr reference       operator[](size_type n) { return m_array[n]; }
+    constexpr const_reference operator[](size_type n) const { return m_array[n]; }
+    constexpr reference       front() { return m_array[0]; }
+    constexpr const_reference front() const { return m_array[0]; }
+    constexpr reference       back() { return m_array[m_size - 1]; }
+    constexpr const_reference back() const { return m_array[m_size - 1]; }
+    constexpr T *       data() noexcept { return m_array; }
+    constexpr const T * data() const noexcept { return m_array; }
+
+    // return true on success, false when the vector is full
+    constexpr bool push_back(const T& value) {
+        if (full()) return false;
+        m_array[m_size++] = value;
+        return true;
+    }
+
+    constexpr bool push_back(T&& value) {
+        if (full()) return false;
+        m_array[m_size++] = std::move(value);
+        return true;
+    }
+
+    template <typename... Args>
+    constexpr bool emplace_back(Args&&... args) {
+        if (full()) return false;
+        m_array[m_size++] = T(std::forward<Args>(args)...);
+        return true;
+    }
+
+    constexpr void pop_back() {
+        if (empty()) return;
+        m_array[--m_size] = T{};
+    }
+
+    // Inserts before 'index', shifting the tail up by one
+    constexpr bool insert(size_type index, T value) {
+        if (full() || index > m_size) return false;
+        for (auto i = m_size; i > index; i--) {
+            m_array[i] = std::move(m_array[i - 1]);
+        }
+        m_array[index] = std::move(value);
+        m_size++;
+        return true;
+    }
+
+    constexpr void erase(size_type index) {
+        if (index >= m_size) return;
+        for (auto i = index; i + 1 < m_size; i++) {
+            m_array[i] = std::move(m_array[i + 1]);
+        }
+        pop_back();
+    }
+
+    constexpr bool resize(size_type count) {
+        if (count > SIZE) return false;
+        while (m_size > count) pop_back();
+        m_size = count;
+        return true;
+    }
+
+    constexpr void clear() {
+        while (m_size > 0) pop_back();
+    }
+
+    constexpr friend bool operator==(const static_vector& a, const static_vector& b) {
+        if (a.m_size != b.m_size) return false;
+        for (size_type i = 0; i < a.m_size; i++) {
+            if (!(a.m_array[i] == b.m_array[i])) return false;
+        }
+        return true;
+    }
+
+private:
+    T m_array[SIZE]{};
+    size_type m_size{0};
+};
@@ -1,86 +1,340 @@
+#ifndef STDLIB_IMPLEMENTATION
+#define STDLIB_IMPLEMENTATION
 #include "./stdlib.hpp"
 #include <string.h>
 #include <concepts>
-#include <assert.h>
+#include <type_traits>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#include <pgmspace.h>
+#endif
 // credit: https://assets.ctfassets.net/oxjq45e8ilak/40Ze5OoEOpGrfParOcbVXF/1b8a361bc269347795e6f068f62de2e7/Ivan_Afanasyev_stdto_string_faster_than_light_2020_06_27_17_37_45.pdf
 // and libfmt
 
-inline void copy2(char* dst, const char* src) { memcpy(dst, src, 2); }
+namespace detail {
+
+struct DigitTables {
+    char pairs[100][2];
+    char digits[36];
+};
+
+inline constexpr DigitTables digit_tables = {{
+        {'0', '0'}, {'0', '1'}, {'0', '2'}, {'0', '3'}, {'0', '4'}, {'0', '5'},
+        {'0', '6'}, {'0', '7'}, {'0', '8'}, {'0', '9'}, {'1', '0'}, {'1', '1'},
+        {'1', '2'}, {'1', '3'}, {'1', '4'}, {'1', '5'}, {'1', '6'}, {'1', '7'},
+        {'1', '8'}, {'1', '9'}, {'2', '0'}, {'2', '1'}, {'2', '2'}, {'2', '3'},
+        {'2', '4'}, {'2', '5'}, {'2', '6'}, {'2', '7'}, {'2', '8'}, {'2', '9'},
+        {'3', '0'}, {'3', '1'}, {'3', '2'}, {'3', '3'}, {'3', '4'}, {'3', '5'},
+        {'3', '6'}, {'3', '7'}, {'3', '8'}, {'3', '9'}, {'4', '0'}, {'4', '1'},
+        {'4', '2'}, {'4', '3'}, {'4', '4'}, {'4', '5'}, {'4', '6'}, {'4', '7'},
+        {'4', '8'}, {'4', '9'}, {'5', '0'}, {'5', '1'}, {'5', '2'}, {'5', '3'},
+        {'5', '4'}, {'5', '5'}, {'5', '6'}, {'5', '7'}, {'5', '8'}, {'5', '9'},
+        {'6', '0'}, {'6', '1'}, {'6', '2'}, {'6', '3'}, {'6', '4'}, {'6', '5'},
+        {'6', '6'}, {'6', '7'}, {'6', '8'}, {'6', '9'}, {'7', '0'}, {'7', '1'},
+        {'7', '2'}, {'7', '3'}, {'7', '4'}, {'7', '5'}, {'7', '6'}, {'7', '7'},
+        {'7', '8'}, {'7', '9'}, {'8', '0'}, {'8', '1'}, {'8', '2'}, {'8', '3'},
+        {'8', '4'}, {'8', '5'}, {'8', '6'}, {'8', '7'}, {'8', '8'}, {'8', '9'},
+        {'9', '0'}, {'9', '1'}, {'9', '2'}, {'9', '3'}, {'9', '4'}, {'9', '5'},
+        {'9', '6'}, {'9', '7'}, {'9', '8'}, {'9', '9'}}, {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
+    'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
+    'u', 'v', 'w', 'x', 'y', 'z'}};
+
+// the copy OptimizeFor::RAM reads, which AVR leaves in flash
+inline constexpr DigitTables digit_tables_P PROGMEM = digit_tables;
+
+// A byte of a table for POLICY; pgm_read_byte() isn't usable in constant
+// expressions, where the flash copy reads like any other
+template <OptimizeFor POLICY>
+constexpr char table_char(const char* entry) {
+    if constexpr (POLICY == OptimizeFor::RAM) {
+        if (!std::is_constant_evaluated()) return static_cast<char>(pgm_read_byte(entry));
+    }
+    return *entry;
+}
+
+// Element-wise so that it stays usable in constant expressions; compilers
+// still turn it into a single 16-bit move
+template <OptimizeFor POLICY>
+constexpr void copy_pair(char* dst, unsigned pair) {
+    const char* src = (POLICY == OptimizeFor::RAM ? digit_tables_P : digit_tables).pairs[pair];
+    dst[0] = table_char<POLICY>(src);
+    dst[1] = table_char<POLICY>(src + 1);
+}
+
+// '0'-'9' and 'a'-'z' for 0 to 35
+template <OptimizeFor POLICY>
+constexpr char digit_char(unsigned digit) {
+    if constexpr (POLICY == OptimizeFor::Size) {
+        return static_cast<char>(digit < 10 ? '0' + digit : 'a' - 10 + digit);
+    } else {
+        return table_char<POLICY>(&(POLICY == OptimizeFor::RAM ? digit_tables_P : digit_tables).digits[digit]);
+    }
+}
+
+template <typename U>
+using wider_t = std::conditional_t<sizeof(U) == 1, uint16_t, std::conditional_t<sizeof(U) == 2, uint32_t, uint64_t>>;
+
+// 64-bit values have no wider type to multiply in and keep dividing
+template <typename U>
+constexpr bool has_wider = sizeof(U) <= sizeof(uint32_t);
+
+// value / divisor == ((value >> pre_shift) * multiplier) >> shift for every
+// value of U. The multiplier is 2^shift / divisor rounded up; the rounding
+// error times the largest input has to stay below 2^shift (Granlund and
+// Montgomery, "Division by Invariant Integers using Multiplication").
+// Shifting out the divisor's factors of two first keeps the multiplier
+// small enough for the product to fit the wider type.
+template <typename Wide>
+struct Reciprocal {
+    Wide multiplier;
+    uint8_t pre_shift;
+    uint8_t shift;
+};
+
+template <UInt U>
+constexpr Reciprocal<wider_t<U>> reciprocal(uint32_t divisor) {
+    using Wide = wider_t<U>;
+    uint8_t pre_shift = 0;
+    while ((divisor & 1) == 0) {
+        divisor >>= 1;
+        pre_shift++;
+    }
+
+    const uint64_t largest = static_cast<U>(~U{0}) >> pre_shift;
+    for (uint8_t shift = 0; shift < 64; shift++) {
+        const uint64_t power = uint64_t{1} << shift;
+        const uint64_t multiplier = power / divisor + (power % divisor != 0);
+        if (multiplier > static_cast<Wide>(~Wide{0}) / largest) break;
+        if ((multiplier * divisor - power) * largest < power) {
+            return {static_cast<Wide>(multiplier), pre_shift, shift};
+        }
+    }
+    return {0, 0, 0};
+}
+
+template <UInt U>
+constexpr U divide(U value, const Reciprocal<wider_t<U>>& r) {
+    using Wide = wider_t<U>;
+    return static_cast<U>((static_cast<Wide>(value >> r.pre_shift) * r.multiplier) >> r.shift);
+}
+
+template <uint32_t DIVISOR, UInt U>
+constexpr U divide(U value) {
+    if constexpr (has_wider<U>) {
+        constexpr auto r = reciprocal<U>(DIVISOR);
+        static_assert(r.multiplier != 0, "divide: no reciprocal fits the wider type");
+        return divide(value, r);
+    } else {
+        return value / DIVISOR;
+    }
+}
+
+// one entry per base, for format() and count_digits() with a runtime base
+template <UInt U>
+inline constexpr auto base_reciprocals = [] {
+    struct { Reciprocal<wider_t<U>> bases[37]; } table{};
+    for (uint32_t base = 2; base <= 36; base++) {
+        table.bases[base] = reciprocal<U>(base);
+    }
+    return table;
+}();
+
+template <UInt U>
+inline constexpr auto base_reciprocals_P PROGMEM = base_reciprocals<U>;
+
+// value / base for a runtime base. The few bases whose reciprocal doesn't
+// fit the wider type (7 for every width, for example) still divide, and
+// so does every base under OptimizeFor::Size, which has no table for them.
+template <OptimizeFor POLICY, UInt U>
+constexpr U divide_by_base(U value, uint8_t base) {
+    if constexpr (!STDLIB_HARDWARE_DIVIDE && has_wider<U> && POLICY != OptimizeFor::Size) {
+        auto r = base_reciprocals<U>.bases[base];
+        if constexpr (POLICY == OptimizeFor::RAM) {
+            if (!std::is_constant_evaluated()) memcpy_P(&r, &base_reciprocals_P<U>.bases[base], sizeof(r));
+        }
+        if (r.multiplier != 0) return divide(value, r);
+    }
+    return static_cast<U>(value / base);
+}
+
+template <UInt U>
+inline constexpr uint8_t max_decimal_digits = [] {
+    uint8_t digits = 1;
+    for (U value = static_cast<U>(~U{0}); value >= 10; value /= 10) digits++;
+    return digits;
+}();
+
+constexpr uint64_t power_of_10(uint8_t exponent) {
+    uint64_t power = 1;
+    while (exponent--) power *= 10;
+    return power;
+}
+
+// Writes the K + 2 digits of 'value' < 10^(K + 2) forwards, leading zeros
+// included, or K + 1 digits when 'odd' (the value then has to be below
+// 10^(K + 1)). The value is scaled once into a 32.32 fixed point number of
+// 10^K units; the integer part is the leading pair and every further pair
+// is the integer part of the fraction times 100, so no division is needed
+// (the "jeaiii" algorithm by James Anhalt). Rounding the scaled value up
+// keeps it within [value / 10^K, (value + 1) / 10^K), which is what makes
+// every extracted pair exact.
+template <uint8_t K, OptimizeFor POLICY>
+constexpr char* format_pairs(uint32_t value, char* str, bool odd) {
+    constexpr uint64_t scale = power_of_10(K);
+    constexpr uint8_t shift = [] {
+        uint8_t s = 0;
+        while ((power_of_10(K + 2) + (uint64_t{1} << s)) * scale >= (uint64_t{1} << (32 + s))) s++;
+        return s;
+    }();
+    constexpr uint64_t multiplier = ((uint64_t{1} << (32 + shift)) + scale - 1) / scale;
+    static_assert(power_of_10(K + 2) <= UINT64_MAX / multiplier, "format_pairs: product overflows");
+
+    uint64_t fixed = ((value * multiplier) >> shift) + 1;
+    const auto leading = static_cast<uint8_t>(fixed >> 32);
+    if (odd) {
+        *str++ = static_cast<char>('0' + leading);
+    } else {
+        copy_pair<POLICY>(str, leading);
+        str += 2;
+    }
+    for (uint8_t i = 0; i < K / 2; i++) {
+        fixed = static_cast<uint64_t>(static_cast<uint32_t>(fixed)) * 100;
+        copy_pair<POLICY>(str, static_cast<unsigned>(fixed >> 32));
+        str += 2;
+    }
+    return str;
+}
+
+// format_decimal() for 32-bit values without a hardware divider: writes
+// backwards from 'end' like the other format_* functions
+template <OptimizeFor POLICY>
+constexpr char* format_decimal32(uint32_t value, char* end) {
+    if (value < 100) {
+        if (value < 10) {
+            *--end = static_cast<char>('0' + value);
+            return end;
+        }
+        end -= 2;
+        copy_pair<POLICY>(end, value);
+        return end;
+    }
+
+    char* str;
+    if (value < 10'000) {
+        const bool odd = value < 1'000;
+        str = end - 4 + odd;
+        format_pairs<2, POLICY>(value, str, odd);
+    } else if (value < 1'000'000) {
+        const bool odd = value < 100'000;
+        str = end - 6 + odd;
+        format_pairs<4, POLICY>(value, str, odd);
+    } else if (value < 100'000'000) {
+        const bool odd = value < 10'000'000;
+        str = end - 8 + odd;
+        format_pairs<6, POLICY>(value, str, odd);
+    } else {
+        const auto high = divide<100'000'000u>(value);
+        const auto low = value - high * 100'000'000u;
+        str = end - 8;
+        format_pairs<6, POLICY>(low, str, false);
+        if (high < 10) {
+            *--str = static_cast<char>('0' + high);
+        } else {
+            str -= 2;
+            copy_pair<POLICY>(str, high);
+        }
+    }
+    return str;
+}
+
+} // namespace detail
+
+// The format_* functions write the digits backwards so that the last one
+// ends up at str[size - 1] and return a pointer to the first one. They do
+// not terminate the string; utoa() sizes and terminates the output.
 
 // std::numeric_limits<unsigned>::digits10 + 2 
-constexpr char* format_hex(unsigned value, char* str, const uint8_t size = 11) {
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format_hex(U value, char* str, const uint8_t size = 11) {
     // todo: sanity checks for 'size'
     str += size;
 
-    constexpr const char digits[] = {
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-        'a', 'b', 'c', 'd', 'e', 'f'
-    };
+    constexpr auto digits = detail::digit_char<POLICY>;
 
     while (value >= 0x100)
 	{
 	  auto number = value & 0xF;
 	  value >>= 4;
-	  *--str = digits[number];
+	  *--str = digits(number);
 
 	  number = value & 0xF;
 	  value >>= 4;
-	  *--str = digits[number];
+	  *--str = digits(number);
 	}
     if (value >= 0x10)
     {
         const auto number = value & 0xF;
         value >>= 4;
-        *--str = digits[number];
-        *--str = digits[value];
+        *--str = digits(number);
+        *--str = digits(value);
     } else {
-        *--str = digits[value];
+        *--str = digits(value);
     }
 
     return str;
 }
-constexpr char* format_decimal(unsigned value, char* str, const uint8_t size = 11) {
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format_decimal(U value, char* str, const uint8_t size = 11) {
     // todo: sanity checks for 'size'
     str += size;
 
-    constexpr const char digits[100][2] = {
-      {'0', '0'}, {'0', '1'}, {'0', '2'}, {'0', '3'}, {'0', '4'}, {'0', '5'},
-      {'0', '6'}, {'0', '7'}, {'0', '8'}, {'0', '9'}, {'1', '0'}, {'1', '1'},
-      {'1', '2'}, {'1', '3'}, {'1', '4'}, {'1', '5'}, {'1', '6'}, {'1', '7'},
-      {'1', '8'}, {'1', '9'}, {'2', '0'}, {'2', '1'}, {'2', '2'}, {'2', '3'},
-      {'2', '4'}, {'2', '5'}, {'2', '6'}, {'2', '7'}, {'2', '8'}, {'2', '9'},
-      {'3', '0'}, {'3', '1'}, {'3', '2'}, {'3', '3'}, {'3', '4'}, {'3', '5'},
-      {'3', '6'}, {'3', '7'}, {'3', '8'}, {'3', '9'}, {'4', '0'}, {'4', '1'},
-      {'4', '2'}, {'4', '3'}, {'4', '4'}, {'4', '5'}, {'4', '6'}, {'4', '7'},
-      {'4', '8'}, {'4', '9'}, {'5', '0'}, {'5', '1'}, {'5', '2'}, {'5', '3'},
-      {'5', '4'}, {'5', '5'}, {'5', '6'}, {'5', '7'}, {'5', '8'}, {'5', '9'},
-      {'6', '0'}, {'6', '1'}, {'6', '2'}, {'6', '3'}, {'6', '4'}, {'6', '5'},
-      {'6', '6'}, {'6', '7'}, {'6', '8'}, {'6', '9'}, {'7', '0'}, {'7', '1'},
-      {'7', '2'}, {'7', '3'}, {'7', '4'}, {'7', '5'}, {'7', '6'}, {'7', '7'},
-      {'7', '8'}, {'7', '9'}, {'8', '0'}, {'8', '1'}, {'8', '2'}, {'8', '3'},
-      {'8', '4'}, {'8', '5'}, {'8', '6'}, {'8', '7'}, {'8', '8'}, {'8', '9'},
-      {'9', '0'}, {'9', '1'}, {'9', '2'}, {'9', '3'}, {'9', '4'}, {'9', '5'},
-      {'9', '6'}, {'9', '7'}, {'9', '8'}, {'9', '9'}};
+    if constexpr (POLICY == OptimizeFor::Size) {
+        // no pair table: a digit per division
+        do {
+            U quotient;
+            if constexpr (!STDLIB_HARDWARE_DIVIDE) quotient = detail::divide<10>(value);
+            else quotient = static_cast<U>(value / 10);
+            *--str = static_cast<char>('0' + (value - quotient * 10));
+            value = quotient;
+        } while (value > 0);
+        return str;
+    }
+
+    if constexpr (!STDLIB_HARDWARE_DIVIDE && sizeof(U) == sizeof(uint32_t)) {
+        return detail::format_decimal32<POLICY>(value, str);
+    }
 
+    using detail::copy_pair;
     while (value >= 100) {
         // Integer division is slow so do it for a group of two digits instead
         // of for every digit. The idea comes from the talk by Alexandrescu
-        // "Three Optimization Tips for C++". See speed-test for a comparison.
+        // "Three Optimization Tips for C++". See bench/format_bench.cpp for a comparison.
         str -= 2;
-        copy2(str, digits[value % 100]);
-        value /= 100;
+        if constexpr (!STDLIB_HARDWARE_DIVIDE) {
+            const auto quotient = detail::divide<100>(value);
+            copy_pair<POLICY>(str, value - quotient * 100);
+            value = quotient;
+        } else {
+            copy_pair<POLICY>(str, value % 100);
+            value /= 100;
+        }
     }
     if (value < 10) {
         *--str = static_cast<char>('0' + value);
         return str;
     }
     str -= 2;
-    copy2(str, digits[value]);
+    copy_pair<POLICY>(str, value);
 
     return str;
 }
 
-constexpr char* format_octal(unsigned value, char* str, const uint8_t size = 11) {
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format_octal(U value, char* str, const uint8_t size = 11) {
     // todo: sanity checks for 'size'
     str += size;
 
@@ -108,72 +362,144 @@ constexpr char* format_octal(unsigned value, char* str, const uint8_t size = 11)
     return str;
 }
 
-constexpr char* format_binary(unsigned value, char* str, const uint8_t size = 20) {
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format_binary(U value, char* str, const uint8_t size = 20) {
     // todo: sanity checks for 'size'
     str += size;
 
-    while (value > 0) {
+    do {
         *--str = static_cast<char>('0' + (value & 1));
         value >>= 1;
-    }
+    } while (value > 0);
 
     return str;
 }
 
-constexpr char* format(unsigned value, char* str, const uint8_t base, const uint8_t size = 11) {
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format(U value, char* str, const uint8_t base, const uint8_t size = 11) {
     str += size;
+    if (!valid_base(base)) [[unlikely]] return str;
 
-    if (base < 2 || base > 32) { [[unlikely]]
-        // throw std::runtime_error("utoa: Invalid base");
-        assert(base > 2 && base < 32);
-    }
+    constexpr auto digits = detail::digit_char<POLICY>;
 
-    constexpr const char digits[] = {
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
-        'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
-        'u', 'v', 'w', 'x', 'y', 'z'
-    };
-
-    while (value >= static_cast<unsigned>(base))
+    while (value >= static_cast<U>(base))
 	{
-	  const auto quotient = value / base;
-	  const auto remainder = value % base;
-	  *--str = digits[remainder];
+	  const auto quotient = detail::divide_by_base<POLICY>(value, base);
+	  const auto remainder = value - quotient * base;
+	  *--str = digits(remainder);
 	  value = quotient;
 	}
 
-    *--str = digits[value];
+    *--str = digits(value);
 
     return str;
 }
 
-    template <UInt U> constexpr char* utoa(const U value, char* str, const uint8_t base) {
-        switch (base) {
-            case 16:
-                return format_hex(value, str);
-            case 10:
-                return format_decimal(value, str);
-            case 8:
-                return format_octal(value, str);
-            case 2:
-                return format_binary(value, str);
-            default:
-                return format(value, str, base);
-        }
+// Number of digits 'value' has in 'base'; none in an invalid base
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr uint8_t count_digits(U value, const uint8_t base) {
+    if (!valid_base(base)) [[unlikely]] return 0;
+    uint8_t count = 1;
+
+    switch (base) {
+        case 16:
+            while (value >>= 4) count++;
+            return count;
+        case 8:
+            while (value >>= 3) count++;
+            return count;
+        case 2:
+            while (value >>= 1) count++;
+            return count;
+        case 10:
+            if constexpr (!STDLIB_HARDWARE_DIVIDE) {
+                // compares against the powers of ten only
+                for (U power = 10; value >= power; power *= 10) {
+                    if (++count == detail::max_decimal_digits<U>) break;
+                }
+                return count;
+            }
+            // four digits per division, then compares
+            while (value >= 10000) {
+                value /= 10000;
+                count += 4;
+            }
+            return count + (value >= 10) + (value >= 100) + (value >= 1000);
+        default:
+            while (value >= base) {
+                value = detail::divide_by_base<POLICY>(value, base);
+                count++;
+            }
+            return count;
     }
+}
 
-    template <Int I> constexpr char* itoa(const I value, char* str, const uint8_t base) {
-        auto abs_value = static_cast<unsigned>(value);
-        const bool negative = value < 0;
+// format() with the shortcuts for the common bases
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR>
+constexpr char* format_base(U value, char* str, const uint8_t base, const uint8_t size) {
+    switch (base) {
+        case 16: return format_hex<U, POLICY>(value, str, size);
+        case 10: return format_decimal<U, POLICY>(value, str, size);
+        case 8: return format_octal<U, POLICY>(value, str, size);
+        case 2: return format_binary<U, POLICY>(value, str, size);
+        default: return format<U, POLICY>(value, str, base, size);
+    }
+}
+
+    template <UInt U, OptimizeFor POLICY> constexpr char* utoa(const U value, char* str, const uint8_t base) {
+        const auto length = count_digits<U, POLICY>(value, base);
+        str[length] = '\0';
+        format_base<U, POLICY>(value, str, base, length);
+        return str;
+    }
+
+    template <Int I, OptimizeFor POLICY> constexpr char* itoa(const I value, char* str, const uint8_t base) {
+        using Unsigned = std::make_unsigned_t<I>;
+        auto abs_value = static_cast<Unsigned>(value);
+        const bool negative = value < 0 && valid_base(base);
 
         if (negative) {
-            abs_value = 0 - abs_value;
+            abs_value = static_cast<Unsigned>(0 - abs_value);
+            *str = '-';
+            utoa<Unsigned, POLICY>(abs_value, str + 1, base);
+            return str;
         }
 
-        auto formatted = utoa(abs_value, str, base);
+        return utoa<Unsigned, POLICY>(abs_value, str, base);
+    }
 
-        if (negative) *--formatted = '-';
+    template <std::floating_point F, OptimizeFor POLICY> constexpr char* ftoa(F value, char* str, uint8_t digits) {
+        if (digits > FTOA_MAX_DIGITS) digits = FTOA_MAX_DIGITS;
+        const auto word = [str](const char* text) {
+            for (uint8_t i = 0; i < 4; i++) str[i] = text[i];
+            return str;
+        };
+        if (value != value) return word("nan");
+        // inf is the only value bigger than this that halving doesn't change
+        if (value > F(4294967040.0) || value < F(-4294967040.0)) return word(value * F(0.5) == value ? "inf" : "ovf");
 
-        return formatted;
+        char* out = str;
+        if (value < 0) {
+            *out++ = '-';
+            value = -value;
+        }
+        F rounding = F(0.5);
+        for (uint8_t i = 0; i < digits; i++) rounding /= F(10.0);
+        value += rounding;
+
+        const auto integer = static_cast<unsigned long>(value);
+        utoa<unsigned long, POLICY>(integer, out);
+        out += count_digits<unsigned long, POLICY>(integer, 10);
+        if (digits > 0) *out++ = '.';
+        F remainder = value - static_cast<F>(integer);
+        for (uint8_t i = 0; i < digits; i++) {
+            remainder *= F(10.0);
+            const auto digit = static_cast<uint8_t>(remainder);
+            *out++ = static_cast<char>('0' + digit);
+            remainder -= digit;
+        }
+        *out = '\0';
+        return str;
     }
+
+#endif // STDLIB_IMPLEMENTATION
@@ -1,8 +1,61 @@
+#pragma once
 #include <stdint.h>
 #include <concepts>
 
+// Without a hardware divider (AVR, Cortex-M0, RISC-V without the M
+// extension's divide) every '/' is a library call of hundreds of cycles, so
+// decimal and generic formatting multiply by compile-time reciprocals
+// instead. Define as 1 or 0 to override the detection.
+#ifndef STDLIB_HARDWARE_DIVIDE
+#if defined(__AVR__) || defined(__ARM_ARCH_6M__) || (defined(__riscv) && !defined(__riscv_div))
+#define STDLIB_HARDWARE_DIVIDE 0
+#else
+#define STDLIB_HARDWARE_DIVIDE 1
+#endif
+#endif
+
+// What the number formatting spends flash and RAM on:
+//   Speed - digit-pair and digit tables (about 240 bytes of constants),
+//           which AVR copies into RAM at startup like any other constant
+//   RAM   - the same tables, but kept in flash (PROGMEM) and read with
+//           pgm_read_byte() on AVR; everywhere else constants already
+//           stay in flash and this is the same as Speed
+//   Size  - no tables at all: one digit per division and the digits
+//           computed, for the smallest flash footprint
+// Every routine below takes the policy as an optional template argument,
+// e.g. utoa<uint32_t, OptimizeFor::Size>(value, str). The default for the
+// whole build, which String and Logger use too, is RAM on AVR and Speed
+// elsewhere; define STDLIB_OPTIMIZE_FOR as Speed, RAM or Size to change it.
+enum class OptimizeFor : uint8_t { Speed, RAM, Size };
+
+#ifndef STDLIB_OPTIMIZE_FOR
+#ifdef __AVR__
+#define STDLIB_OPTIMIZE_FOR RAM
+#else
+#define STDLIB_OPTIMIZE_FOR Speed
+#endif
+#endif
+
+inline constexpr OptimizeFor DEFAULT_OPTIMIZE_FOR = OptimizeFor::STDLIB_OPTIMIZE_FOR;
+
 template<typename T> concept UInt = std::is_unsigned_v<T> && std::is_integral_v<T>;
 template<typename T> concept Int = std::is_signed_v<T> && std::is_integral_v<T>;
 
-template <UInt U> constexpr char* utoa(const U value, char* str, const uint8_t base = 10);
-template <Int I> constexpr char* itoa(const I value, char* str, const uint8_t base = 10);
+// Same contract as the libc extensions: the digits are written to 'str'
+// followed by a terminator and 'str' is returned. 'str' needs room for
+// every digit of the type in the given base plus the sign and terminator.
+// A base outside 2 to 36 gives an empty string.
+constexpr bool valid_base(uint8_t base) { return base >= 2 && base <= 36; }
+
+template <UInt U, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR> constexpr char* utoa(const U value, char* str, const uint8_t base = 10);
+template <Int I, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR> constexpr char* itoa(const I value, char* str, const uint8_t base = 10);
+
+// Fixed-point text like Arduino's Print::print(double, digits): 'digits'
+// rounded decimals (at most FTOA_MAX_DIGITS), "nan", "inf", or "ovf" past
+// the range of an unsigned long. 'str' needs ftoa_size(digits) bytes.
+constexpr uint8_t FTOA_MAX_DIGITS = 15;
+constexpr uint8_t ftoa_size(uint8_t digits) { return 13 + (digits < FTOA_MAX_DIGITS ? digits : FTOA_MAX_DIGITS); }
+template <std::floating_point F, OptimizeFor POLICY = DEFAULT_OPTIMIZE_FOR> constexpr char* ftoa(F value, char* str, uint8_t digits = 2);
+
+// The definitions are constexpr templates and have to be visible to callers
+#include "stdlib.cpp"
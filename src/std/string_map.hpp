@@ -0,0 +1,213 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include "StringView.hpp"
+#include "hash.hpp"
+#include "probe_table.hpp"
+
+// Fixed-capacity hash map from strings to values that never touches the
+// heap. Keys are copied into an internal arena of ARENA bytes, so callers
+// look up with a StringView or a String without building a key object.
+//
+// Entries are kept densely in insertion order (until an erase moves the last
+// one into the hole), which is what iteration walks; they are found through
+// a detail::probe_table of their indexes. Arena space of erased keys is
+// reclaimed by compacting when an insert runs out of room.
+template <typename Value, size_t SIZE, size_t ARENA = SIZE * 16>
+class string_map {
+    static_assert(SIZE > 0 && SIZE < 65535, "string_map: 1 to 65534 entries");
+
+    using table_type = detail::probe_table<SIZE>;
+    using index_type = typename table_type::index_type;
+    using offset_type = std::conditional_t<(ARENA < 65536), uint16_t, size_t>;
+
+    struct Entry {
+        offset_type offset{0};
+        offset_type length{0};
+        Value value{};
+    };
+
+public:
+    using mapped_type = Value;
+    using size_type = size_t;
+
+    // what iteration yields: for (auto [key, value] : map)
+    template <typename Ref>
+    struct basic_item {
+        StringView key;
+        Ref value;
+    };
+
+    template <typename Map, typename Ref>
+    class basic_iterator {
+        Map* m_map{nullptr};
+        size_type m_index{0};
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = basic_item<Ref>;
+        using difference_type = std::ptrdiff_t;
+        using reference = basic_item<Ref>;
+
+        constexpr basic_iterator() = default;
+        constexpr basic_iterator(Map* map, size_type index) : m_map(map), m_index(index) {}
+        constexpr basic_iterator& operator++() { m_index++; return *this; }
+        constexpr basic_iterator operator++(int) { basic_iterator retval = *this; ++(*this); return retval; }
+        constexpr friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.m_index == b.m_index; }
+        constexpr reference operator*() const { return {m_map->key_of(m_index), m_map->m_entries[m_index].value}; }
+    };
+
+    using iterator = basic_iterator<string_map, Value&>;
+    using const_iterator = basic_iterator<const string_map, const Value&>;
+
+    constexpr string_map() = default;
+
+    constexpr iterator begin() noexcept { return iterator{ this, 0 }; }
+    constexpr iterator end() noexcept { return iterator{ this, size() }; }
+    constexpr const_iterator begin() const noexcept { return const_iterator{ this, 0 }; }
+    constexpr const_iterator end() const noexcept { return const_iterator{ this, size() }; }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr bool full() const noexcept { return m_size == SIZE; }
+    constexpr size_type size() const noexcept { return m_size; }
+    static constexpr size_type capacity() noexcept { return SIZE; }
+    // arena bytes held by keys, including erased ones not yet compacted
+    constexpr size_type arena_used() const noexcept { return m_arena_top; }
+    static constexpr size_type arena_capacity() noexcept { return ARENA; }
+
+    // return true if inserted, false if the key exists or the map or its
+    // arena is full
+    constexpr bool insert(StringView key, Value value) {
+        const auto hash = fnv1a(key);
+        size_t slot = 0;
+        if (locate(key, hash, slot)) return false;
+        return add(key, hash, slot, std::move(value));
+    }
+
+    constexpr bool insert_or_assign(StringView key, Value value) {
+        const auto hash = fnv1a(key);
+        size_t slot = 0;
+        if (locate(key, hash, slot)) {
+            m_entries[m_slots[slot]].value = std::move(value);
+            return true;
+        }
+        return add(key, hash, slot, std::move(value));
+    }
+
+    constexpr iterator find(StringView key) {
+        size_t slot = 0;
+        if (!locate(key, fnv1a(key), slot)) return end();
+        return iterator{ this, m_slots[slot] };
+    }
+
+    constexpr const_iterator find(StringView key) const {
+        size_t slot = 0;
+        if (!locate(key, fnv1a(key), slot)) return end();
+        return const_iterator{ this, m_slots[slot] };
+    }
+
+    constexpr bool contains(StringView key) const { return find(key) != end(); }
+
+    // nullptr when the key is missing
+    constexpr Value* get(StringView key) {
+        size_t slot = 0;
+        if (!locate(key, fnv1a(key), slot)) return nullptr;
+        return &m_entries[m_slots[slot]].value;
+    }
+
+    constexpr const Value* get(StringView key) const {
+        size_t slot = 0;
+        if (!locate(key, fnv1a(key), slot)) return nullptr;
+        return &m_entries[m_slots[slot]].value;
+    }
+
+    constexpr bool erase(StringView key) {
+        size_t slot = 0;
+        if (!locate(key, fnv1a(key), slot)) return false;
+
+        const auto index = m_slots[slot];
+        m_garbage += m_entries[index].length;
+        m_slots.remove(slot, keys());
+
+        // keep the entries dense by moving the last one into the hole
+        const auto last = static_cast<index_type>(m_size - 1);
+        if (index != last) {
+            size_t last_slot = 0;
+            locate(key_of(last), fnv1a(key_of(last)), last_slot);
+            m_slots.repoint(last_slot, index);
+            m_entries[index] = std::move(m_entries[last]);
+        }
+        m_entries[last] = Entry{};
+        m_size--;
+        return true;
+    }
+
+    constexpr void clear() {
+        m_slots.clear();
+        for (size_t i = 0; i < m_size; i++) m_entries[i] = Entry{};
+        m_size = 0;
+        m_arena_top = 0;
+        m_garbage = 0;
+    }
+
+private:
+    constexpr StringView key_of(size_t index) const {
+        return StringView(m_arena + m_entries[index].offset, m_entries[index].length);
+    }
+
+    constexpr auto keys() const {
+        return [this](size_t index) { return key_of(index); };
+    }
+
+    constexpr bool locate(StringView key, uint32_t hash, size_t& slot) const {
+        return m_slots.locate(key, hash, slot, keys());
+    }
+
+    constexpr bool add(StringView key, uint32_t hash, size_t slot, Value&& value) {
+        if (full() || key.length() > ARENA) return false;
+        if (ARENA - m_arena_top < key.length()) {
+            if (ARENA - m_arena_top + m_garbage < key.length()) return false;
+            compact();
+        }
+
+        auto& entry = m_entries[m_size];
+        entry.offset = static_cast<offset_type>(m_arena_top);
+        entry.length = static_cast<offset_type>(key.length());
+        entry.value = std::move(value);
+        for (size_t i = 0; i < key.length(); i++) m_arena[m_arena_top + i] = key.data()[i];
+        m_arena_top += key.length();
+
+        m_slots.assign(slot, m_size, hash);
+        m_size++;
+        return true;
+    }
+
+    // Moves the live keys down over the erased ones, lowest offset first so
+    // that nothing is overwritten before it has moved.
+    constexpr void compact() {
+        index_type order[SIZE]{};
+        for (size_t i = 0; i < m_size; i++) {
+            size_t j = i;
+            for (; j > 0 && m_entries[order[j - 1]].offset > m_entries[i].offset; j--) order[j] = order[j - 1];
+            order[j] = static_cast<index_type>(i);
+        }
+
+        size_t top = 0;
+        for (size_t i = 0; i < m_size; i++) {
+            auto& entry = m_entries[order[i]];
+            for (size_t c = 0; c < entry.length; c++) m_arena[top + c] = m_arena[entry.offset + c];
+            entry.offset = static_cast<offset_type>(top);
+            top += entry.length;
+        }
+        m_arena_top = top;
+        m_garbage = 0;
+    }
+
+    table_type m_slots{};
+    Entry m_entries[SIZE]{};
+    char m_arena[ARENA]{};
+    size_type m_size{0};
+    size_type m_arena_top{0};
+    size_type m_garbage{0};
+};
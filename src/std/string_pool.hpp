@@ -0,0 +1,103 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "StringView.hpp"
+#include "hash.hpp"
+#include "probe_table.hpp"
+
+// Interns strings: every distinct text is stored once, null-terminated, in
+// a fixed arena, and callers keep a one or two byte handle to it. Equal
+// texts intern to equal handles, so comparing labels is an integer compare
+// and a table of N labels costs N handles plus the distinct texts.
+//
+// Texts are found through a detail::probe_table of their indexes. Nothing
+// is ever removed, which keeps views and c_str() pointers valid for the
+// life of the pool. Handles from different pools must not be mixed.
+//
+//   string_pool<32> labels;
+//   const auto topic = labels.intern(String("sensors/temperature"));
+//   if (topic == labels.find("sensors/temperature")) ...
+template <size_t SIZE, size_t ARENA = SIZE * 16>
+class string_pool {
+    static_assert(SIZE > 0 && SIZE < 65535, "string_pool: 1 to 65534 strings");
+
+    using table_type = detail::probe_table<SIZE>;
+    using index_type = typename table_type::index_type;
+    using offset_type = std::conditional_t<(ARENA < 65536), uint16_t, size_t>;
+
+    static constexpr index_type NONE = table_type::EMPTY;
+
+public:
+    class Handle {
+        friend class string_pool;
+        index_type m_index{NONE};
+        constexpr explicit Handle(index_type index) : m_index(index) {}
+    public:
+        // an invalid handle, as returned when a string isn't in the pool
+        constexpr Handle() = default;
+        constexpr bool valid() const { return m_index != NONE; }
+        constexpr explicit operator bool() const { return valid(); }
+        constexpr index_type index() const { return m_index; }
+        constexpr bool operator==(const Handle&) const = default;
+    };
+
+    constexpr string_pool() = default;
+
+    // the handle of 'text', adding it if it isn't in the pool yet; invalid
+    // when the pool or its arena is full
+    constexpr Handle intern(StringView text) {
+        const auto hash = fnv1a(text);
+        size_t slot = 0;
+        if (locate(text, hash, slot)) return Handle{m_slots[slot]};
+        if (m_size == SIZE || ARENA - m_arena_top < text.length() + 1) return Handle{};
+
+        m_offsets[m_size] = static_cast<offset_type>(m_arena_top);
+        for (size_t i = 0; i < text.length(); i++) m_arena[m_arena_top + i] = text.data()[i];
+        m_arena[m_arena_top + text.length()] = '\0';
+        m_arena_top += text.length() + 1;
+
+        m_slots.assign(slot, m_size, hash);
+        return Handle{static_cast<index_type>(m_size++)};
+    }
+
+    // the handle of 'text' if it has been interned, otherwise invalid
+    constexpr Handle find(StringView text) const {
+        size_t slot = 0;
+        if (!locate(text, fnv1a(text), slot)) return Handle{};
+        return Handle{m_slots[slot]};
+    }
+
+    constexpr bool contains(StringView text) const { return find(text).valid(); }
+
+    // 'handle' must be valid and come from this pool
+    constexpr StringView view(Handle handle) const {
+        return StringView(c_str(handle), length(handle.m_index));
+    }
+    constexpr StringView operator[](Handle handle) const { return view(handle); }
+    constexpr const char* c_str(Handle handle) const { return m_arena + m_offsets[handle.m_index]; }
+
+    constexpr size_t size() const { return m_size; }
+    static constexpr size_t capacity() { return SIZE; }
+    // arena bytes used, terminators included
+    constexpr size_t arena_used() const { return m_arena_top; }
+    static constexpr size_t arena_capacity() { return ARENA; }
+
+private:
+    constexpr size_t length(size_t index) const {
+        const size_t end = index + 1 < m_size ? m_offsets[index + 1] : m_arena_top;
+        return end - m_offsets[index] - 1;
+    }
+
+    constexpr bool locate(StringView text, uint32_t hash, size_t& slot) const {
+        return m_slots.locate(text, hash, slot, [this](size_t index) {
+            return StringView(m_arena + m_offsets[index], length(index));
+        });
+    }
+
+    table_type m_slots{};
+    offset_type m_offsets[SIZE]{};
+    char m_arena[ARENA]{};
+    size_t m_size{0};
+    size_t m_arena_top{0};
+};
@@ -1,34 +1,223 @@
 #pragma once
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.hpp"
 
 template <typename PtrType>
+struct default_delete {
+    constexpr default_delete() noexcept = default;
+
+    template <typename U> requires std::is_convertible_v<U*, PtrType*>
+    constexpr default_delete(const default_delete<U>&) noexcept {}
+
+    constexpr void operator()(PtrType *ptr) const { delete ptr; }
+};
+
+template <typename PtrType>
+struct default_delete<PtrType[]> {
+    constexpr void operator()(PtrType *ptr) const { delete[] ptr; }
+};
+
+// Stateless deleters take up no space ([[no_unique_address]]), so a
+// unique_ptr with one is exactly as big as a raw pointer.
+template <typename PtrType, typename Deleter = default_delete<PtrType>>
 class unique_ptr {
 public:
-    unique_ptr(PtrType *ptr)
+    using pointer = PtrType*;
+    using element_type = PtrType;
+    using deleter_type = Deleter;
+
+    constexpr unique_ptr() noexcept = default;
+    constexpr unique_ptr(nullptr_t) noexcept {}
+
+    constexpr explicit unique_ptr(pointer ptr) noexcept
+    : m_ptr(ptr) {}
+
+    constexpr unique_ptr(pointer ptr, Deleter deleter) noexcept
+    : m_ptr(ptr),
+      m_deleter(std::move(deleter)) {}
+
+    constexpr unique_ptr(unique_ptr &&other) noexcept
+    : m_ptr(other.release()),
+      m_deleter(std::move(other.m_deleter)) {}
+
+    // unique_ptr<Derived> -> unique_ptr<Base>
+    template <typename U, typename E> requires std::is_convertible_v<U*, pointer> && std::is_convertible_v<E, Deleter>
+    constexpr unique_ptr(unique_ptr<U, E> &&other) noexcept
+    : m_ptr(other.release()),
+      m_deleter(std::move(other.get_deleter())) {}
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr& other) = delete;
+
+    constexpr unique_ptr& operator=(unique_ptr&& other) noexcept
+    {
+        // Guard self assignment
+        if (this == &other) {
+            return *this;
+        }
+
+        reset(other.release()); // leave other in valid state
+        m_deleter = std::move(other.m_deleter);
+        return *this;
+    }
+
+    constexpr unique_ptr& operator=(nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    constexpr ~unique_ptr() {
+        if (m_ptr != nullptr) {
+            m_deleter(m_ptr);
+        }
+    }
+
+    constexpr pointer get() const noexcept { return m_ptr; }
+    constexpr Deleter& get_deleter() noexcept { return m_deleter; }
+    constexpr const Deleter& get_deleter() const noexcept { return m_deleter; }
+
+    // Gives up ownership without destroying the object
+    [[nodiscard]] constexpr pointer release() noexcept { return std::exchange(m_ptr, nullptr); }
+
+    constexpr void reset(pointer ptr = nullptr) noexcept {
+        if (auto *old = std::exchange(m_ptr, ptr)) {
+            m_deleter(old);
+        }
+    }
+
+    constexpr void swap(unique_ptr &other) noexcept {
+        std::swap(m_ptr, other.m_ptr);
+        std::swap(m_deleter, other.m_deleter);
+    }
+
+    constexpr explicit operator bool() const noexcept { return m_ptr != nullptr; }
+    constexpr PtrType& operator*() const noexcept { return *m_ptr; }
+    constexpr pointer operator->() const noexcept { return m_ptr; }
+
+private:
+    pointer m_ptr{nullptr};
+    [[no_unique_address]] Deleter m_deleter{};
+};
+
+template <typename PtrType, typename Deleter>
+class unique_ptr<PtrType[], Deleter> {
+public:
+    using pointer = PtrType*;
+    using element_type = PtrType;
+    using deleter_type = Deleter;
+
+    constexpr unique_ptr() noexcept = default;
+    constexpr unique_ptr(nullptr_t) noexcept {}
+
+    constexpr explicit unique_ptr(pointer ptr) noexcept
     : m_ptr(ptr) {}
 
-    unique_ptr(unique_ptr<PtrType> ptr)
-    : m_ptr(std::move(ptr)) {}
+    constexpr unique_ptr(pointer ptr, Deleter deleter) noexcept
+    : m_ptr(ptr),
+      m_deleter(std::move(deleter)) {}
+
+    constexpr unique_ptr(unique_ptr &&other) noexcept
+    : m_ptr(other.release()),
+      m_deleter(std::move(other.m_deleter)) {}
 
-    T& operator=(const T& other) = delete;
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr& other) = delete;
 
-    T& operator=(T&& other) noexcept
-	{
-	    // Guard self assignment
-	    if (this == &other) {
+    constexpr unique_ptr& operator=(unique_ptr&& other) noexcept
+    {
+        if (this == &other) {
             return *this;
         }
 
-	    delete m_ptr;
+        reset(other.release());
+        m_deleter = std::move(other.m_deleter);
+        return *this;
+    }
 
-	    m_ptr = std::exchange(other.m_ptr, nullptr); // leave other in valid state
-	    return *this;
-	}
+    constexpr unique_ptr& operator=(nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
 
-    ~unique_ptr() {
+    constexpr ~unique_ptr() {
         if (m_ptr != nullptr) {
-            delete m_ptr;
+            m_deleter(m_ptr);
         }
     }
+
+    constexpr pointer get() const noexcept { return m_ptr; }
+    constexpr Deleter& get_deleter() noexcept { return m_deleter; }
+    constexpr const Deleter& get_deleter() const noexcept { return m_deleter; }
+
+    [[nodiscard]] constexpr pointer release() noexcept { return std::exchange(m_ptr, nullptr); }
+
+    constexpr void reset(pointer ptr = nullptr) noexcept {
+        if (auto *old = std::exchange(m_ptr, ptr)) {
+            m_deleter(old);
+        }
+    }
+
+    constexpr void swap(unique_ptr &other) noexcept {
+        std::swap(m_ptr, other.m_ptr);
+        std::swap(m_deleter, other.m_deleter);
+    }
+
+    constexpr explicit operator bool() const noexcept { return m_ptr != nullptr; }
+    constexpr PtrType& operator[](size_t index) const noexcept { return m_ptr[index]; }
+
 private:
-    PtrType *m_ptr{nullptr};
+    pointer m_ptr{nullptr};
+    [[no_unique_address]] Deleter m_deleter{};
 };
+
+static_assert(sizeof(unique_ptr<int>) == sizeof(int*), "unique_ptr: a stateless deleter must not add to the size");
+static_assert(sizeof(unique_ptr<int[]>) == sizeof(int*), "unique_ptr: a stateless deleter must not add to the size");
+
+template <typename A, typename DA, typename B, typename DB>
+constexpr bool operator==(const unique_ptr<A, DA> &a, const unique_ptr<B, DB> &b) noexcept { return a.get() == b.get(); }
+
+template <typename A, typename DA>
+constexpr bool operator==(const unique_ptr<A, DA> &a, nullptr_t) noexcept { return !a; }
+
+template <typename PtrType, typename Deleter>
+constexpr void swap(unique_ptr<PtrType, Deleter> &a, unique_ptr<PtrType, Deleter> &b) noexcept { a.swap(b); }
+
+/*********************************************/
+/*  make_unique                              */
+/*********************************************/
+
+template <typename PtrType, typename... Args> requires (!std::is_array_v<PtrType>)
+constexpr unique_ptr<PtrType> make_unique(Args&&... args) {
+    return unique_ptr<PtrType>(new PtrType(std::forward<Args>(args)...));
+}
+
+template <typename PtrType> requires std::is_unbounded_array_v<PtrType>
+constexpr unique_ptr<PtrType> make_unique(size_t count) {
+    return unique_ptr<PtrType>(new std::remove_extent_t<PtrType>[count]());
+}
+
+// Constructs the object in an arena or pool with static storage duration,
+// e.g. make_unique<Sensor, g_pool>(pin). Holds nullptr if the resource is
+// exhausted.
+template <typename PtrType, auto& Resource, typename... Args> requires (!std::is_array_v<PtrType>)
+unique_ptr<PtrType, resource_delete<Resource>> make_unique(Args&&... args) {
+    void *memory = Resource.allocate(sizeof(PtrType));
+    if (!memory) return nullptr;
+    return unique_ptr<PtrType, resource_delete<Resource>>(new (memory) PtrType(std::forward<Args>(args)...));
+}
+
+// Only trivially destructible elements, since the deleter does not know the count
+template <typename PtrType, auto& Resource> requires std::is_unbounded_array_v<PtrType>
+unique_ptr<PtrType, resource_delete<Resource>> make_unique(size_t count) {
+    using element_type = std::remove_extent_t<PtrType>;
+    static_assert(std::is_trivially_destructible_v<element_type>, "make_unique: pool/arena arrays need trivially destructible elements");
+
+    void *memory = Resource.allocate(sizeof(element_type) * count);
+    if (!memory) return nullptr;
+    return unique_ptr<PtrType, resource_delete<Resource>>(new (memory) element_type[count]());
+}
@@ -0,0 +1,285 @@
+#pragma once
+// UTF-8 on top of the byte strings: validation, counting and iterating code
+// points, and subString()/remove()/trim() that take code point positions and
+// never cut a character in half.
+//
+// Validation follows table 3-7 of the Unicode standard, so overlong forms,
+// surrogates and anything above U+10FFFF are rejected. Runs of ASCII, which
+// is most of any payload, are skipped a word or a vector at a time (see
+// simd.hpp). Malformed bytes decode to U+FFFD one at a time.
+//
+//   if (!utf8::valid(payload)) return;
+//   auto name = utf8::subString(label, 0, 12); // the first 12 characters
+//   for (char32_t c : utf8::codepoints(name)) ...
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+#include "String.hpp"
+#include "StringView.hpp"
+#include "simd.hpp"
+
+namespace utf8 {
+
+inline constexpr char32_t REPLACEMENT = 0xFFFD;
+
+namespace detail {
+
+constexpr bool is_continuation(uint8_t byte) { return (byte & 0xC0) == 0x80; }
+
+using ::detail::Word, ::detail::USE_WORDS;
+inline constexpr Word ONES = static_cast<Word>(0x0101010101010101ull);
+inline constexpr Word HIGH_BITS = ONES * 0x80;
+
+// true if none of the 16 bytes at 'data' has its top bit set
+inline bool ascii_block(const char* data) {
+#if STD_X86_SIMD
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))) == 0;
+#else
+    Word words[16 / sizeof(Word)];
+    memcpy(words, data, sizeof(words));
+    Word any = 0;
+    for (auto word : words) any |= word;
+    return (any & HIGH_BITS) == 0;
+#endif
+}
+
+// Bytes in the well-formed sequence at data[i], or 0 if there isn't one
+constexpr uint8_t sequence_length(const char* data, size_t size, size_t i) {
+    const auto lead = static_cast<uint8_t>(data[i]);
+    if (lead < 0x80) return 1;
+
+    uint8_t length = 0;
+    // the range of the second byte is narrower than 80..BF after these leads
+    uint8_t low = 0x80, high = 0xBF;
+    if (lead < 0xC2) return 0; // a continuation byte or an overlong pair
+    else if (lead < 0xE0) length = 2;
+    else if (lead < 0xF0) {
+        length = 3;
+        if (lead == 0xE0) low = 0xA0;      // overlong
+        else if (lead == 0xED) high = 0x9F; // surrogates
+    } else if (lead < 0xF5) {
+        length = 4;
+        if (lead == 0xF0) low = 0x90;      // overlong
+        else if (lead == 0xF4) high = 0x8F; // above U+10FFFF
+    } else return 0;
+
+    if (size - i < length) return 0;
+    const auto second = static_cast<uint8_t>(data[i + 1]);
+    if (second < low || second > high) return 0;
+    for (uint8_t k = 2; k < length; k++) {
+        if (!is_continuation(static_cast<uint8_t>(data[i + k]))) return 0;
+    }
+    return length;
+}
+
+} // namespace detail
+
+// true if all 'size' bytes are well-formed UTF-8
+constexpr bool valid(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        // whole blocks of ASCII are skipped at once, the rest of the text
+        // is checked 16 bytes at a time
+        if (detail::USE_WORDS && !std::is_constant_evaluated() && size - i >= 16 && detail::ascii_block(data + i)) {
+            i += 16;
+            continue;
+        }
+        const size_t stop = size - i < 16 ? size : i + 16;
+        while (i < stop) {
+            if (static_cast<uint8_t>(data[i]) < 0x80) {
+                i++;
+                continue;
+            }
+            const auto length = detail::sequence_length(data, size, i);
+            if (length == 0) return false;
+            i += length;
+        }
+    }
+    return true;
+}
+
+constexpr bool valid(StringView text) { return valid(text.data(), text.length()); }
+
+// Number of code points, counting every byte that doesn't continue a
+// sequence; only meaningful for valid() text.
+constexpr size_t length(const char* data, size_t size) {
+    size_t count = size;
+    size_t i = 0;
+    if constexpr (detail::USE_WORDS) {
+        if (!std::is_constant_evaluated()) {
+            using detail::Word, detail::ONES, detail::HIGH_BITS;
+            constexpr Word EVEN_BYTES = static_cast<Word>(0x00FF00FF00FF00FFull);
+            while (size - i >= sizeof(Word)) {
+                // one counter per byte lane, added up before any can overflow
+                Word counts = 0;
+                for (size_t n = 0; n < 255 && size - i >= sizeof(Word); n++, i += sizeof(Word)) {
+                    Word word;
+                    memcpy(&word, data + i, sizeof(word));
+                    // 10xxxxxx: the top bit set and, shifted up into its place, the next one clear
+                    counts += (word & ~(word << 1) & HIGH_BITS) >> 7;
+                }
+                const Word pairs = (counts & EVEN_BYTES) + (counts >> 8 & EVEN_BYTES);
+                count -= static_cast<size_t>(pairs * (ONES & EVEN_BYTES) >> (8 * sizeof(Word) - 16)) & 0xFFFF;
+            }
+        }
+    }
+    for (; i < size; i++) {
+        if (detail::is_continuation(static_cast<uint8_t>(data[i]))) count--;
+    }
+    return count;
+}
+
+constexpr size_t length(StringView text) { return length(text.data(), text.length()); }
+
+// true if a code point starts at byte 'index' (or 'index' is the end)
+constexpr bool is_boundary(const char* data, size_t size, size_t index) {
+    return index >= size || !detail::is_continuation(static_cast<uint8_t>(data[index]));
+}
+
+// Byte offset of code point number 'index', or 'size' if there are fewer
+constexpr size_t offset(const char* data, size_t size, size_t index) {
+    size_t i = 0;
+    for (; i < size; i++) {
+        if (!detail::is_continuation(static_cast<uint8_t>(data[i])) && index-- == 0) return i;
+    }
+    return size;
+}
+
+// Decodes the code point at byte 'index' and moves 'index' past it. A
+// malformed byte gives REPLACEMENT and is skipped on its own.
+constexpr char32_t decode(const char* data, size_t size, size_t& index) {
+    const auto length = detail::sequence_length(data, size, index);
+    const auto lead = static_cast<uint8_t>(data[index]);
+    if (length == 0) {
+        index++;
+        return REPLACEMENT;
+    }
+    char32_t c = length == 1 ? lead : lead & (0x7F >> length);
+    for (uint8_t k = 1; k < length; k++) c = c << 6 | (static_cast<uint8_t>(data[index + k]) & 0x3F);
+    index += length;
+    return c;
+}
+
+// Writes 'c' into 'out' (up to 4 bytes, no terminator) and returns the
+// number of bytes; surrogates and values above U+10FFFF are written as
+// REPLACEMENT.
+constexpr size_t encode(char32_t c, char* out) {
+    if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) c = REPLACEMENT;
+    if (c < 0x80) {
+        out[0] = static_cast<char>(c);
+        return 1;
+    }
+    if (c < 0x800) {
+        out[0] = static_cast<char>(0xC0 | c >> 6);
+        out[1] = static_cast<char>(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | c >> 12);
+        out[1] = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+        out[2] = static_cast<char>(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | c >> 18);
+    out[1] = static_cast<char>(0x80 | (c >> 12 & 0x3F));
+    out[2] = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+    out[3] = static_cast<char>(0x80 | (c & 0x3F));
+    return 4;
+}
+
+// The White_Space property of the Unicode character database
+constexpr bool is_space(char32_t c) {
+    return c == ' ' || (c >= '\t' && c <= '\r') || c == 0x85 || c == 0xA0 || c == 0x1680 ||
+           (c >= 0x2000 && c <= 0x200A) || c == 0x2028 || c == 0x2029 || c == 0x202F || c == 0x205F || c == 0x3000;
+}
+
+// for (char32_t c : utf8::codepoints(text))
+class codepoint_iterator {
+    const char* m_data{nullptr};
+    size_t m_size{0};
+    size_t m_index{0};
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char32_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = char32_t;
+
+    constexpr codepoint_iterator() = default;
+    constexpr codepoint_iterator(const char* data, size_t size, size_t index) : m_data(data), m_size(size), m_index(index) {}
+
+    constexpr char32_t operator*() const {
+        size_t index = m_index;
+        return decode(m_data, m_size, index);
+    }
+    constexpr codepoint_iterator& operator++() {
+        const auto length = detail::sequence_length(m_data, m_size, m_index);
+        m_index += length == 0 ? 1 : length;
+        return *this;
+    }
+    constexpr codepoint_iterator operator++(int) { codepoint_iterator retval = *this; ++(*this); return retval; }
+    constexpr friend bool operator==(const codepoint_iterator& a, const codepoint_iterator& b) { return a.m_index == b.m_index; }
+    // byte offset of the current code point
+    constexpr size_t offset() const { return m_index; }
+};
+
+class codepoint_range {
+    StringView m_text;
+public:
+    constexpr explicit codepoint_range(StringView text) : m_text(text) {}
+    constexpr codepoint_iterator begin() const { return {m_text.data(), m_text.length(), 0}; }
+    constexpr codepoint_iterator end() const { return {m_text.data(), m_text.length(), m_text.length()}; }
+};
+
+constexpr codepoint_range codepoints(StringView text) { return codepoint_range(text); }
+
+// The code points from 'beginIndex' up to (not including) 'endIndex'; a
+// SharedString gets a slice as with StringBase::subString().
+template <AllocatorType Allocator>
+constexpr StringBase<char, Allocator> subString(const StringBase<char, Allocator>& str, size_t beginIndex, size_t endIndex) {
+    const auto left = offset(str.begin(), str.length(), beginIndex);
+    const auto right = endIndex <= beginIndex ? left : left + offset(str.begin() + left, str.length() - left, endIndex - beginIndex);
+    return str.subString(left, right);
+}
+
+template <AllocatorType Allocator>
+constexpr StringBase<char, Allocator> subString(const StringBase<char, Allocator>& str, size_t beginIndex) {
+    return str.subString(offset(str.begin(), str.length(), beginIndex));
+}
+
+// Removes 'count' code points starting at code point 'index'
+template <AllocatorType Allocator>
+constexpr void remove(StringBase<char, Allocator>& str, size_t index, size_t count = static_cast<size_t>(-1)) {
+    const char* data = std::as_const(str).begin();
+    const auto left = offset(data, str.length(), index);
+    if (left == str.length() || count == 0) return;
+    const auto right = left + offset(data + left, str.length() - left, count);
+    str.remove(left, right - left);
+}
+
+// Like StringBase::trim(), but also strips the non-ASCII white space
+// (no-break spaces, the U+2000 block, ideographic space)
+template <AllocatorType Allocator>
+constexpr void trim(StringBase<char, Allocator>& str) {
+    const char* data = std::as_const(str).begin();
+    const size_t size = str.length();
+    size_t left = 0;
+    while (left < size) {
+        size_t next = left;
+        if (!is_space(decode(data, size, next))) break;
+        left = next;
+    }
+    size_t right = size;
+    while (right > left) {
+        size_t start = right - 1;
+        while (start > left && detail::is_continuation(static_cast<uint8_t>(data[start]))) start--;
+        size_t next = start;
+        if (!is_space(decode(data, size, next)) || next != right) break;
+        right = start;
+    }
+    if (right < size) str.remove(right);
+    if (left > 0) str.remove(0, left);
+}
+
+} // namespace utf8
@@ -0,0 +1,67 @@
+#pragma once
+// Minimal self-registering test harness; every test file is its own
+// executable that returns non-zero when a CHECK failed.
+#include <stdio.h>
+#include <string.h>
+
+struct TestCase {
+    const char *name;
+    void (*function)();
+    TestCase *next;
+};
+
+inline TestCase *&test_list() {
+    static TestCase *head{nullptr};
+    return head;
+}
+
+inline int &test_failures() {
+    static int failures{0};
+    return failures;
+}
+
+struct TestRegistrar {
+    explicit TestRegistrar(TestCase &test) {
+        // keep the declaration order
+        auto **tail = &test_list();
+        while (*tail) tail = &(*tail)->next;
+        *tail = &test;
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestCase name##_case{#name, name, nullptr}; \
+    static TestRegistrar name##_registrar{name##_case}; \
+    static void name()
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            test_failures()++; \
+        } \
+    } while (0)
+
+// a function rather than locals in the macro, so that a temporary's
+// c_str() stays alive for the comparison
+inline void check_str(const char *actual, const char *expected, const char *file, int line, const char *text) {
+    if (!actual || strcmp(actual, expected) != 0) {
+        printf("%s:%d: CHECK_STR(%s): \"%s\" != \"%s\"\n", file, line, text, actual ? actual : "(null)", expected);
+        test_failures()++;
+    }
+}
+
+#define CHECK_STR(actual, expected) check_str((actual), (expected), __FILE__, __LINE__, #actual)
+
+inline int run_tests() {
+    int count = 0;
+    for (auto *test = test_list(); test; test = test->next) {
+        const auto before = test_failures();
+        test->function();
+        printf("%s %s\n", test_failures() == before ? "[ OK ]" : "[FAIL]", test->name);
+        count++;
+    }
+    printf("%d tests, %d failed checks\n", count, test_failures());
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#include "test.hpp"
+// tracing on its own, with DEBUG left at its default of false
+#define TRACE_ALLOCATIONS true
+#include <Arduino.h>
+#include "Logger.hpp"
+
+TEST(dumps_allocations_without_debug) {
+    static_assert(!DEBUG);
+    AllocationTracer::reset();
+    {
+        String s("abc");
+        s += "0123456789012345678901234567890123456789";
+    }
+    CHECK(AllocationTracer::allocations() == AllocationTracer::frees());
+
+    Serial.clear();
+    Logger::log("not printed");
+    CHECK(Serial.output().empty());
+    Logger::allocations();
+    CHECK(Serial.output().find("construct: 1 calls") != std::string::npos);
+    CHECK(Serial.output().find("peak: ") != std::string::npos);
+}
+
+int main() { return run_tests(); }
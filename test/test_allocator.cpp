@@ -0,0 +1,86 @@
+#include "test.hpp"
+#include "std/allocator.hpp"
+#include "std/unique_ptr.hpp"
+
+namespace {
+arena<128> g_arena;
+pool<16, 4> g_pool;
+
+struct Counted {
+    static inline int alive = 0;
+    int value;
+    explicit Counted(int v) : value(v) { alive++; }
+    ~Counted() { alive--; }
+};
+}
+
+TEST(arena_bumps_and_rewinds) {
+    g_arena.reset();
+    auto *a = g_arena.allocate(10);
+    auto *b = g_arena.allocate(10);
+    CHECK(a && b && a != b);
+    CHECK(reinterpret_cast<uintptr_t>(b) % alignof(max_align_t) == 0);
+    {
+        decltype(g_arena)::scope scope(g_arena);
+        CHECK(g_arena.allocate(40));
+        CHECK(g_arena.used() > 40);
+    }
+    const auto used = g_arena.used();
+    CHECK(g_arena.reallocate(b, 10, 30) == b); // last allocation grows in place
+    CHECK(g_arena.used() == used + 20);
+    CHECK(g_arena.allocate(1000) == nullptr);
+    g_arena.reset();
+    CHECK(g_arena.used() == 0);
+}
+
+TEST(pool_allocates_fixed_blocks) {
+    void *blocks[4];
+    for (auto &block : blocks) {
+        block = g_pool.allocate(16);
+        CHECK(block);
+    }
+    CHECK(g_pool.allocate(1) == nullptr);
+    g_pool.deallocate(blocks[2]);
+    CHECK(g_pool.allocate(8) == blocks[2]);
+    CHECK(g_pool.allocate(17) == nullptr);
+    for (auto *block : blocks) g_pool.deallocate(block);
+    CHECK(g_pool.used() == 0);
+}
+
+TEST(unique_ptr_owns) {
+    static_assert(sizeof(unique_ptr<Counted>) == sizeof(Counted *));
+    static_assert(sizeof(unique_ptr<Counted, resource_delete<g_pool>>) == sizeof(Counted *));
+    {
+        auto a = make_unique<Counted>(1);
+        CHECK(a->value == 1 && (*a).value == 1);
+        auto b = std::move(a);
+        CHECK(!a && b);
+        b.reset(new Counted(2));
+        CHECK(Counted::alive == 1);
+        Counted *raw = b.release();
+        CHECK(!b);
+        delete raw;
+        auto array = make_unique<int[]>(3);
+        array[2] = 5;
+        CHECK(array[0] == 0 && array[2] == 5);
+    }
+    CHECK(Counted::alive == 0);
+}
+
+TEST(unique_ptr_from_pool) {
+    {
+        auto a = make_unique<Counted, g_pool>(7);
+        CHECK(a && a->value == 7);
+        CHECK(g_pool.used() == 1);
+        auto bytes = make_unique<char[], g_arena>(8);
+        CHECK(bytes);
+    }
+    CHECK(g_pool.used() == 0);
+    CHECK(Counted::alive == 0);
+
+    unique_ptr<Counted, resource_delete<g_pool>> held[5];
+    for (int i = 0; i < 5; i++) held[i] = make_unique<Counted, g_pool>(i);
+    CHECK(held[3] && !held[4]); // exhausted pool gives an empty pointer
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,95 @@
+#include "test.hpp"
+#define DEBUG true
+#include <Arduino.h>
+#include "BufferedStream.hpp"
+#include "Logger.hpp"
+
+static_assert(BasicStreamType<BufferedStream<HardwareSerial>>);
+static_assert(WritableStreamType<BufferedStream<HardwareSerial>>);
+
+TEST(batches_prints_into_one_write) {
+    Serial.clear();
+    {
+        BufferedStream<HardwareSerial> out(Serial);
+        out.print("value=");
+        out.print(42);
+        out.print(' ');
+        out.print(-7L);
+        out.print(' ');
+        out.print(255u, HEX);
+        out.print(' ');
+        out.print(String("ok"));
+        out.print(StringView(" view"));
+        out.print(F(" flash"));
+        CHECK(Serial.writes() == 0);
+        CHECK(out.pending() == 28);
+        out.flush();
+        CHECK(Serial.writes() == 1);
+        out.println(1.5);
+    }
+    // the destructor flushes the rest
+    CHECK(Serial.output() == "value=42 -7 ff ok view flash1.50\r\n");
+    CHECK(Serial.writes() == 2);
+}
+
+TEST(flushes_when_full_and_passes_large_writes_through) {
+    Serial.clear();
+    BufferedStream<HardwareSerial, 70> out(Serial);
+    for (int i = 0; i < 30; i++) out.print("abc");
+    CHECK(Serial.writes() == 1);
+    CHECK(Serial.output().size() == 69);
+
+    char large[100];
+    memset(large, 'x', sizeof(large));
+    out.write(large, sizeof(large));
+    CHECK(Serial.writes() == 3);
+    CHECK(Serial.output().size() == 190);
+    CHECK(out.pending() == 0);
+
+    // numbers never straddle a flush
+    out.print("12345678901234567890123456789012345678901234567890123456789012345");
+    out.print(0xFFFFFFFFFFFFFFFFull, BIN);
+    out.flush();
+    CHECK(Serial.output().size() == 190 + 65 + 64);
+    CHECK(Serial.output().substr(255) == std::string(64, '1'));
+
+    // and go through a temporary when the buffer is smaller than they are
+    Serial.clear();
+    BufferedStream<HardwareSerial, 8> small(Serial);
+    small.print(-1234567890123LL);
+    small.print(0xFFFFull, BIN);
+    small.flush();
+    CHECK(Serial.output() == "-12345678901231111111111111111");
+}
+
+TEST(flushes_on_newline_when_asked) {
+    Serial.clear();
+    BufferedStream<HardwareSerial> out(Serial, FlushOn::Newline);
+    Logger::print(out, "t=", 10, " v=", 3, '\n');
+    CHECK(Serial.writes() == 1);
+    CHECK(Serial.output() == "t=10 v=3\n");
+    out.print("a\nb");
+    CHECK(Serial.writes() == 2);
+    CHECK(out.pending() == 0);
+    out.print(F("c"));
+    CHECK(out.pending() == 1);
+}
+
+TEST(prints_floats_like_arduino) {
+    Serial.clear();
+    {
+        BufferedStream<HardwareSerial> out(Serial);
+        out.print(3.14159);
+        out.print(' ');
+        out.print(-0.005, 3);
+        out.print(' ');
+        out.print(2.5, 0);
+        out.print(' ');
+        out.print(1e10);
+        out.print(' ');
+        out.print(0.0 / 0.0);
+    }
+    CHECK(Serial.output() == "3.14 -0.005 3 ovf nan");
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,313 @@
+#include "test.hpp"
+#include "std/array.hpp"
+#include "std/bitset.hpp"
+#include "std/flat_map.hpp"
+#include "std/static_ring.hpp"
+#include "std/static_vector.hpp"
+#include "std/string_map.hpp"
+#include "std/string_pool.hpp"
+#include <Arduino.h>
+#include <algorithm>
+
+static_assert(std::ranges::contiguous_range<array<int, 4>>);
+static_assert(std::ranges::contiguous_range<const array<int, 4>>);
+static_assert(std::ranges::contiguous_range<static_vector<int, 4>>);
+
+constexpr int sorted_sum() {
+    array<int, 5> values{5, 1, 4, 2, 3};
+    std::sort(values.begin(), values.end());
+    return values[0] * 10000 + values[4] * 1000 + values.sum();
+}
+static_assert(sorted_sum() == 10000 + 5000 + 15);
+
+static_assert(sizeof(bitset<8>) == 1 && sizeof(bitset<12>) == 2 && sizeof(bitset<64>) == 8);
+static_assert(bitset<10>(0xFFFF).count() == 10);
+static_assert(bitset<70>().set(69).find_first() == 69);
+static_assert(bitset<16>(0x8421).find_next(1) == 5);
+
+TEST(array_iterates_both_ways) {
+    const array<int, 4> values{1, 2, 3, 4};
+    int forward = 0;
+    for (auto v : values) forward = forward * 10 + v;
+    CHECK(forward == 1234);
+
+    int backward = 0;
+    for (auto it = values.rbegin(); it != values.rend(); ++it) backward = backward * 10 + *it;
+    CHECK(backward == 4321);
+
+    CHECK(values.end() - values.begin() == 4);
+    CHECK(values.data() == &values[0]);
+    CHECK(!values.empty());
+    CHECK(values.max_size() == 4);
+    CHECK(*std::lower_bound(values.begin(), values.end(), 3) == 3);
+}
+
+TEST(array_bulk_operations) {
+    array<float, 7> values{};
+    values.fill(1.5f);
+    CHECK(values.sum() == 10.5f);
+    values[3] = -2.f;
+    values[5] = 9.f;
+    CHECK(values.min() == -2.f);
+    CHECK(values.max() == 9.f);
+
+    const int source[3]{7, 8, 9};
+    array<int, 3> copied{};
+    copied.copy_from(source);
+    CHECK(copied == (array<int, 3>{7, 8, 9}));
+    CHECK((array<int, 3>{1, 2, 3}) < copied);
+
+    array<int, 3> other{};
+    swap(copied, other);
+    CHECK(other[2] == 9 && copied[2] == 0);
+}
+
+TEST(static_vector_grows_to_capacity) {
+    static_vector<int, 3> v;
+    CHECK(v.empty());
+    CHECK(v.push_back(1));
+    CHECK(v.emplace_back(3));
+    CHECK(v.insert(1, 2));
+    CHECK(!v.push_back(4));
+    CHECK(v.full());
+    CHECK(v[0] == 1 && v[1] == 2 && v[2] == 3);
+    v.erase(0);
+    CHECK(v.size() == 2 && v.front() == 2 && v.back() == 3);
+    v.clear();
+    CHECK(v.empty());
+}
+
+TEST(static_ring_wraps) {
+    static_ring<int, 4> ring;
+    for (int i = 0; i < 4; i++) CHECK(ring.push_back(i));
+    CHECK(!ring.push_back(4));
+    int value = -1;
+    CHECK(ring.pop_front(value) && value == 0);
+    CHECK(ring.push_back(4));
+    CHECK(ring.front() == 1 && ring.back() == 4);
+    ring.push_overwrite(5);
+    CHECK(ring.front() == 2);
+    CHECK(ring.push_front(9) == false);
+    CHECK(ring.pop_back(value) && value == 5);
+    CHECK(ring.push_front(9));
+    int order = 0;
+    for (auto v : ring) order = order * 10 + v;
+    CHECK(order == 9234);
+}
+
+TEST(flat_map_keeps_keys_sorted) {
+    flat_map<int, const char*, 4> map{{3, "c"}, {1, "a"}};
+    CHECK(map.insert(2, "b"));
+    CHECK(!map.insert(2, "x"));
+    CHECK(map.insert_or_assign(2, "B"));
+    CHECK_STR(*map.get(2), "B");
+    CHECK(map.get(7) == nullptr);
+    CHECK(map.contains(3));
+    int keys = 0;
+    for (const auto& [key, value] : map) keys = keys * 10 + key;
+    CHECK(keys == 123);
+    CHECK(map.erase(1));
+    CHECK(!map.contains(1));
+    CHECK(map.size() == 2);
+}
+
+constexpr int string_map_lookups() {
+    string_map<int, 4> map;
+    map.insert("one", 1);
+    map.insert("two", 2);
+    map.insert_or_assign("one", 10);
+    return *map.get("one") + *map.get("two") + (map.contains("three") ? 100 : 0);
+}
+static_assert(string_map_lookups() == 12);
+
+TEST(string_map_looks_up_without_temporaries) {
+    string_map<int, 8> map;
+    CHECK(map.insert("status", 1));
+    CHECK(map.insert("reset", 2));
+    CHECK(map.insert("", 3));
+    CHECK(!map.insert("status", 4));
+    CHECK(*map.get("status") == 1);
+
+    const String key("reset");
+    CHECK(*map.get(key) == 2);
+    CHECK(*map.get(StringView("resetting", 5)) == 2);
+    CHECK(*map.get("") == 3);
+    CHECK(map.get("rese") == nullptr);
+    CHECK(map.find("statuses") == map.end());
+
+    CHECK(map.insert_or_assign(key, 20));
+    CHECK(map.insert_or_assign("led", 5));
+    CHECK(*map.get("reset") == 20);
+    CHECK(map.size() == 4);
+    CHECK(map.arena_used() == 14);
+}
+
+TEST(string_map_iterates_in_insertion_order) {
+    string_map<int, 4> map;
+    map.insert("a", 1);
+    map.insert("bb", 2);
+    map.insert("ccc", 3);
+
+    int sum = 0;
+    size_t lengths = 0;
+    for (auto [key, value] : map) {
+        sum = sum * 10 + value;
+        lengths += key.length();
+        value *= 2;
+    }
+    CHECK(sum == 123);
+    CHECK(lengths == 6);
+    CHECK(*map.get("bb") == 4);
+
+    const auto& view = map;
+    auto found = view.find("ccc");
+    CHECK(found != view.end() && (*found).value == 6 && (*found).key == StringView("ccc"));
+}
+
+TEST(string_map_erases_and_reuses_space) {
+    string_map<int, 4, 12> map;
+    CHECK(map.insert("alpha", 1));
+    CHECK(map.insert("beta", 2));
+    CHECK(map.insert("xyz", 3));
+    CHECK(!map.insert("q", 4)); // arena full
+    CHECK(map.erase("alpha"));
+    CHECK(!map.erase("alpha"));
+    CHECK(map.size() == 2);
+    CHECK(map.arena_used() == 12);
+
+    // compacts the arena to fit the new key
+    CHECK(map.insert("gamma", 5));
+    CHECK(map.arena_used() == 12);
+    CHECK(*map.get("beta") == 2 && *map.get("xyz") == 3 && *map.get("gamma") == 5);
+    CHECK(!map.contains("alpha"));
+
+    map.clear();
+    CHECK(map.empty() && map.arena_used() == 0);
+    CHECK(map.insert("alpha", 1));
+}
+
+TEST(string_map_survives_churn) {
+    // erase and reinsert many keys so probe runs wrap around and shift back
+    string_map<int, 200, 200 * 6> map;
+    char key[8];
+    const auto make_key = [&](int i) {
+        return StringView(key, static_cast<size_t>(snprintf(key, sizeof(key), "k%d", i)));
+    };
+    for (int i = 0; i < 200; i++) CHECK(map.insert(make_key(i), i));
+    CHECK(map.full() && !map.insert("extra", 0));
+    for (int i = 0; i < 200; i += 3) CHECK(map.erase(make_key(i)));
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 200; i += 3) CHECK(map.insert_or_assign(make_key(i + 1000 * (round + 1)), i));
+        for (int i = 0; i < 200; i += 3) CHECK(map.erase(make_key(i + 1000 * (round + 1))));
+    }
+
+    bool all_found = true;
+    for (int i = 0; i < 200; i++) {
+        const auto* value = map.get(make_key(i));
+        all_found &= (i % 3 == 0) ? value == nullptr : value != nullptr && *value == i;
+    }
+    CHECK(all_found);
+    CHECK(map.size() == 133);
+}
+
+constexpr bool string_pool_deduplicates() {
+    string_pool<4> pool;
+    const auto a = pool.intern("temperature");
+    const auto b = pool.intern("humidity");
+    return pool.intern("temperature") == a && a != b && pool.size() == 2 && pool[b] == StringView("humidity");
+}
+static_assert(string_pool_deduplicates());
+static_assert(sizeof(string_pool<4>::Handle) == 1);
+
+TEST(string_pool_interns_each_text_once) {
+    string_pool<8, 64> pool;
+    const auto temperature = pool.intern("sensors/temperature");
+    const auto humidity = pool.intern(String("sensors/humidity"));
+    const auto empty = pool.intern("");
+    CHECK(temperature.valid() && humidity.valid() && empty.valid());
+    CHECK(temperature != humidity);
+    CHECK(pool.intern(String("sensors/temperature")) == temperature);
+    CHECK(pool.find(StringView("sensors/humidity!!", 16)) == humidity);
+    CHECK(pool.find("") == empty);
+    CHECK(pool.size() == 3);
+    CHECK(pool.arena_used() == 20 + 17 + 1);
+
+    CHECK_STR(pool.c_str(temperature), "sensors/temperature");
+    CHECK(pool.view(humidity).length() == 16);
+    CHECK(pool[empty].length() == 0);
+
+    CHECK(!pool.find("sensors").valid());
+    CHECK(!pool.contains("sensors/pressure"));
+    CHECK(!string_pool<8>::Handle{});
+}
+
+TEST(string_pool_refuses_when_full) {
+    string_pool<2, 8> pool;
+    CHECK(pool.intern("abc").valid());
+    CHECK(!pool.intern("defgh").valid()); // needs 6 bytes, 4 left
+    CHECK(pool.intern("def").valid());
+    CHECK(!pool.intern("g").valid()); // out of handles
+    CHECK(pool.intern("abc").valid()); // existing texts still resolve
+    CHECK_STR(pool.c_str(pool.find("def")), "def");
+}
+
+TEST(string_pool_with_many_labels) {
+    string_pool<300, 300 * 8> pool;
+    string_pool<300, 300 * 8>::Handle handles[300];
+    char text[8];
+    for (int i = 0; i < 300; i++) {
+        handles[i] = pool.intern(StringView(text, static_cast<size_t>(snprintf(text, sizeof(text), "l%d", i))));
+        CHECK(handles[i].index() == i);
+    }
+    bool all_found = true;
+    for (int i = 0; i < 300; i++) {
+        snprintf(text, sizeof(text), "l%d", i);
+        all_found &= pool.find(StringView(text, strlen(text))) == handles[i] && strcmp(pool.c_str(handles[i]), text) == 0;
+    }
+    CHECK(all_found);
+}
+
+TEST(bitset_sets_and_counts) {
+    bitset<12> flags;
+    CHECK(flags.none() && flags.size() == 12);
+    flags.set(0).set(3).set(11);
+    CHECK(flags.count() == 3);
+    CHECK(flags[3] && !flags[4]);
+    flags.flip(3).reset(0);
+    CHECK(flags.to_ullong() == 0x800);
+    flags.flip();
+    CHECK(flags.count() == 11 && !flags.all());
+    flags.set();
+    CHECK(flags.all() && flags.to_ullong() == 0xFFF);
+    CHECK((~flags).none());
+
+    const bitset<8> a(0b1100'1010), b(0b1010'0110);
+    CHECK((a & b).to_ullong() == 0b1000'0010);
+    CHECK((a | b).to_ullong() == 0b1110'1110);
+    CHECK((a ^ b).to_ullong() == 0b0110'1100);
+    CHECK(a == bitset<8>(0x1CA));
+}
+
+TEST(bitset_visits_set_bits_only) {
+    bitset<200> pending;
+    const size_t expected[] = {0, 7, 63, 64, 65, 127, 128, 199};
+    for (auto i : expected) pending.set(i);
+
+    size_t visited = 0;
+    bool in_order = true;
+    for (size_t i : pending) in_order = in_order && visited < 8 && i == expected[visited++];
+    CHECK(in_order && visited == 8);
+    CHECK(pending.count() == 8);
+
+    CHECK(pending.find_first() == 0);
+    CHECK(pending.find_next(1) == 7);
+    CHECK(pending.find_next(66) == 127);
+    CHECK(pending.find_next(199) == 199);
+    CHECK(pending.reset(199).find_next(129) == 200);
+
+    bitset<200> empty;
+    CHECK(empty.begin() == empty.end() && empty.find_first() == 200);
+    CHECK(empty.set().count() == 200 && (~empty).none());
+}
+
+int main() { return run_tests(); }
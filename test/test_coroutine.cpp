@@ -0,0 +1,135 @@
+#include "test.hpp"
+// frames are a lot larger with the sanitizers and without optimization
+#define COROUTINE_FRAME_SIZE 512
+#include <Arduino.h>
+#include "Coroutine.hpp"
+
+namespace {
+int g_steps = 0;
+
+async::task wait_then_count(uint32_t ms) {
+    co_await async::delay(ms);
+    g_steps++;
+}
+
+async::task sequence() {
+    co_await async::delay(10);
+    g_steps++;
+    co_await wait_then_count(5);
+    co_await async::readable(Serial);
+    g_steps++;
+    co_await async::interrupt<0>{FALLING};
+    g_steps++;
+}
+
+// Suspends like an awaiter from another library would, without parking
+struct ForeignAwaiter {
+    static inline std::coroutine_handle<> suspended{};
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) noexcept { suspended = h; }
+    void await_resume() const noexcept {}
+};
+
+async::task foreign_wait() {
+    co_await ForeignAwaiter{};
+    g_steps++;
+    co_await async::delay(1);
+    g_steps++;
+}
+
+async::task foreign_wait_nested() {
+    co_await foreign_wait();
+    g_steps++;
+}
+
+void run_for(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        async::Scheduler::poll();
+        host::advance_millis(1);
+    }
+}
+}
+
+TEST(delays_nested_tasks_and_events) {
+    host::set_millis(0);
+    Serial.clear();
+    const auto free_frames = async::FrameArena::available();
+
+    CHECK(async::Scheduler::spawn(sequence()));
+    run_for(9);
+    CHECK(g_steps == 0);
+    run_for(2);
+    CHECK(g_steps == 1);
+    run_for(10);
+    CHECK(g_steps == 2);
+
+    run_for(5);
+    CHECK(g_steps == 2);
+    Serial.feed("x");
+    run_for(1);
+    CHECK(g_steps == 3);
+
+    run_for(5);
+    CHECK(g_steps == 3);
+    CHECK(EICRA == FALLING); // ISC01 set, ISC00 clear
+    CHECK(EIMSK == 0x01);
+    INT0_vect();
+    run_for(1);
+    CHECK(g_steps == 4);
+    CHECK(async::Scheduler::idle());
+    CHECK(async::FrameArena::available() == free_frames);
+}
+
+TEST(tasks_run_concurrently) {
+    host::set_millis(0);
+    g_steps = 0;
+    CHECK(async::Scheduler::spawn(wait_then_count(20)));
+    CHECK(async::Scheduler::spawn(wait_then_count(10)));
+    run_for(15);
+    CHECK(g_steps == 1);
+    run_for(10);
+    CHECK(g_steps == 2);
+    CHECK(async::Scheduler::idle());
+}
+
+TEST(delay_survives_millis_wraparound) {
+    host::set_millis(0xFFFFFFF0u);
+    g_steps = 0;
+    CHECK(async::Scheduler::spawn(wait_then_count(32)));
+    run_for(20);
+    CHECK(g_steps == 0);
+    run_for(20);
+    CHECK(g_steps == 1);
+}
+
+TEST(foreign_awaiters_are_left_to_resume_the_task) {
+    host::set_millis(0);
+    g_steps = 0;
+    const auto free_frames = async::FrameArena::available();
+    CHECK(async::Scheduler::spawn(foreign_wait()));
+    run_for(5);
+    CHECK(g_steps == 0);
+    CHECK(!async::Scheduler::idle());
+
+    // resumed from loop(), outside poll(), it still parks in its own slot
+    ForeignAwaiter::suspended.resume();
+    CHECK(g_steps == 1);
+    run_for(2);
+    CHECK(g_steps == 2);
+    CHECK(async::Scheduler::idle());
+    CHECK(async::FrameArena::available() == free_frames);
+
+    // and so does a nested task, next to one that keeps polling
+    g_steps = 0;
+    CHECK(async::Scheduler::spawn(wait_then_count(3)));
+    CHECK(async::Scheduler::spawn(foreign_wait_nested()));
+    run_for(1);
+    ForeignAwaiter::suspended.resume();
+    CHECK(g_steps == 1);
+    run_for(5);
+    CHECK(g_steps == 4);
+    CHECK(async::Scheduler::idle());
+    CHECK(async::FrameArena::available() == free_frames);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,184 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/encoding.hpp"
+
+static const uint8_t* bytes(const char* str) {
+    return reinterpret_cast<const uint8_t*>(str);
+}
+
+template <typename Encode>
+static const char* encoded(char* buffer, Encode&& encode) {
+    buffer[encode(buffer)] = '\0';
+    return buffer;
+}
+
+constexpr bool encodes_at_compile_time() {
+    const uint8_t data[] = {0xde, 0xad, 0xbe, 0xef};
+    char out[16]{};
+    const auto length = hex_encode(data, 4, out, ":");
+    return length == 11 && out[0] == 'd' && out[2] == ':' && out[10] == 'f' && base64_encode(data, 4, out) == 8 && out[0] == '3' && out[7] == '=';
+}
+static_assert(encodes_at_compile_time());
+
+TEST(hex_encodes) {
+    char buffer[128];
+    const uint8_t data[] = {0x00, 0x01, 0x7f, 0x80, 0xab, 0xff};
+    CHECK_STR(encoded(buffer, [&](char* out) { return hex_encode(data, 6, out); }), "00017f80abff");
+    CHECK_STR(encoded(buffer, [&](char* out) { return hex_encode(data, 6, out, nullptr, true); }), "00017F80ABFF");
+    CHECK_STR(encoded(buffer, [&](char* out) { return hex_encode(data, 6, out, ":"); }), "00:01:7f:80:ab:ff");
+    CHECK_STR(encoded(buffer, [&](char* out) { return hex_encode(data, 6, out, ", ", true); }), "00, 01, 7F, 80, AB, FF");
+    CHECK_STR(encoded(buffer, [&](char* out) { return hex_encode(data, 0, out, ":"); }), "");
+    CHECK(hex_encoded_size(6, 2) == 22);
+    CHECK(hex_encoded_size(0, 2) == 0);
+}
+
+TEST(hex_every_length_matches_table_lookup) {
+    // covers the SIMD, SWAR and tail paths
+    uint8_t data[100];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    char actual[201], expected[201];
+    for (size_t size = 0; size <= sizeof(data); size++) {
+        for (bool upper : {false, true}) {
+            actual[hex_encode(data, size, actual, nullptr, upper)] = '\0';
+            const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            for (size_t i = 0; i < size; i++) {
+                expected[2 * i] = digits[data[i] >> 4];
+                expected[2 * i + 1] = digits[data[i] & 0xF];
+            }
+            expected[2 * size] = '\0';
+            CHECK_STR(actual, expected);
+
+            detail::hex_encode_swar(data, size, actual, upper);
+            CHECK_STR(actual, expected);
+        }
+    }
+}
+
+TEST(hex_decodes) {
+    uint8_t out[8];
+    CHECK(hex_decode("00017f80ABff", 12, out) == 6);
+    CHECK(out[0] == 0x00 && out[2] == 0x7f && out[4] == 0xab && out[5] == 0xff);
+    CHECK(hex_decode("de:ad:be:ef", 11, out, ":") == 4);
+    CHECK(out[0] == 0xde && out[3] == 0xef);
+    CHECK(hex_decode("", 0, out) == 0);
+    CHECK(hex_decode("abc", 3, out) == -1);
+    CHECK(hex_decode("zz", 2, out) == -1);
+    CHECK(hex_decode("de:ad:", 6, out, ":") == -1);
+    CHECK(hex_decode("de-ad", 5, out, ":") == -1);
+    CHECK(hex_decoded_size(11, 1) == 4);
+}
+
+TEST(base64_rfc4648_vectors) {
+    const char* inputs[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* padded[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    const char* unpadded[] = {"", "Zg", "Zm8", "Zm9v", "Zm9vYg", "Zm9vYmE", "Zm9vYmFy"};
+    char buffer[16];
+    uint8_t decoded[16];
+    for (size_t i = 0; i < 7; i++) {
+        const auto size = strlen(inputs[i]);
+        CHECK_STR(encoded(buffer, [&](char* out) { return base64_encode(bytes(inputs[i]), size, out); }), padded[i]);
+        CHECK_STR(encoded(buffer, [&](char* out) { return base64_encode(bytes(inputs[i]), size, out, Base64::Standard, false); }), unpadded[i]);
+        CHECK(base64_encoded_size(size) == strlen(padded[i]));
+        CHECK(base64_encoded_size(size, false) == strlen(unpadded[i]));
+
+        for (const char* text : {padded[i], unpadded[i]}) {
+            CHECK(base64_decoded_size(text, strlen(text)) == size);
+            CHECK(base64_decode(text, strlen(text), decoded) == static_cast<ptrdiff_t>(size));
+            CHECK(memcmp(decoded, inputs[i], size) == 0);
+        }
+    }
+}
+
+TEST(base64_url_alphabet) {
+    const uint8_t data[] = {0xfb, 0xff, 0xbf};
+    char buffer[8];
+    uint8_t decoded[4];
+    CHECK_STR(encoded(buffer, [&](char* out) { return base64_encode(data, 3, out); }), "+/+/");
+    CHECK_STR(encoded(buffer, [&](char* out) { return base64_encode(data, 3, out, Base64::Url); }), "-_-_");
+    CHECK(base64_decode("-_-_", 4, decoded, Base64::Url) == 3);
+    CHECK(decoded[0] == 0xfb && decoded[2] == 0xbf);
+    CHECK(base64_decode("-_-_", 4, decoded) == -1);
+}
+
+TEST(base64_rejects_malformed_input) {
+    uint8_t decoded[16];
+    CHECK(base64_decode("Zm9vY", 5, decoded) == -1);
+    CHECK(base64_decode("Zg=", 3, decoded) == -1);
+    CHECK(base64_decode("Zg===", 5, decoded) == -1);
+    CHECK(base64_decode("Zm 9v", 5, decoded) == -1);
+}
+
+TEST(base64_every_length_round_trips) {
+    // long enough for the SIMD path and every tail
+    uint8_t data[80];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = static_cast<uint8_t>(i * 91 + 7);
+
+    const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char text[128];
+    uint8_t decoded[80];
+    for (size_t size = 0; size <= sizeof(data); size++) {
+        const auto length = base64_encode(data, size, text);
+        CHECK(length == base64_encoded_size(size));
+        bool matches = true;
+        for (size_t i = 0; i + 3 <= size; i += 3) {
+            const uint32_t group = static_cast<uint32_t>(data[i]) << 16 | data[i + 1] << 8 | data[i + 2];
+            const char* chars = text + i / 3 * 4;
+            matches &= chars[0] == table[group >> 18] && chars[1] == table[(group >> 12) & 63] && chars[2] == table[(group >> 6) & 63] && chars[3] == table[group & 63];
+        }
+        CHECK(matches);
+        CHECK(base64_decode(text, length, decoded) == static_cast<ptrdiff_t>(size));
+        CHECK(memcmp(decoded, data, size) == 0);
+    }
+}
+
+TEST(base32_rfc4648_vectors) {
+    const char* inputs[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* padded[] = {"", "MY======", "MZXQ====", "MZXW6===", "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"};
+    char buffer[24];
+    uint8_t decoded[16];
+    for (size_t i = 0; i < 7; i++) {
+        const auto size = strlen(inputs[i]);
+        CHECK_STR(encoded(buffer, [&](char* out) { return base32_encode(bytes(inputs[i]), size, out); }), padded[i]);
+        CHECK(base32_encoded_size(size) == strlen(padded[i]));
+
+        const auto unpadded = base32_encode(bytes(inputs[i]), size, buffer, false);
+        CHECK(unpadded == base32_encoded_size(size, false));
+        CHECK(base32_decode(buffer, unpadded, decoded) == static_cast<ptrdiff_t>(size));
+        CHECK(memcmp(decoded, inputs[i], size) == 0);
+        CHECK(base32_decode(padded[i], strlen(padded[i]), decoded) == static_cast<ptrdiff_t>(size));
+        CHECK(base32_decoded_size(padded[i], strlen(padded[i])) == size);
+    }
+    CHECK(base32_decode("mzxw6ytboi", 10, decoded) == 6);
+    CHECK(memcmp(decoded, "foobar", 6) == 0);
+    CHECK(base32_decode("MZX", 3, decoded) == -1);
+    CHECK(base32_decode("MY=", 3, decoded) == -1);
+    CHECK(base32_decode("M1======", 8, decoded) == -1);
+}
+
+TEST(appends_to_strings) {
+    const uint8_t data[] = {0xde, 0xad, 0xbe, 0xef};
+    String text("id=");
+    CHECK(hex_encode(data, 4, text, ":", true));
+    CHECK_STR(text.c_str(), "id=DE:AD:BE:EF");
+
+    String hex;
+    uint8_t large[100];
+    for (size_t i = 0; i < sizeof(large); i++) large[i] = static_cast<uint8_t>(i);
+    CHECK(hex_encode(large, sizeof(large), hex));
+    CHECK(hex.length() == 200);
+    CHECK(hex.startsWith(String("000102")) && hex.endsWith(String("6263")));
+
+    String base64;
+    CHECK(base64_encode(large, sizeof(large), base64));
+    CHECK(base64.length() == base64_encoded_size(sizeof(large)));
+    uint8_t decoded[100];
+    CHECK(base64_decode(base64.c_str(), base64.length(), decoded) == 100);
+    CHECK(memcmp(decoded, large, sizeof(large)) == 0);
+
+    String base32;
+    CHECK(base32_encode(bytes("foobar"), 6, base32));
+    CHECK_STR(base32.c_str(), "MZXW6YTBOI======");
+}
+
+int main() { return run_tests(); }
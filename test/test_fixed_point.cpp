@@ -0,0 +1,117 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/fixed_point.hpp"
+#include "std/String.hpp"
+
+using celsius = fixed_point<2>;
+
+static_assert(celsius(21).raw() == 2100);
+static_assert(celsius(1.805).raw() == 181);
+static_assert((celsius::from_raw(2137) * celsius(1.8) + 32).raw() == 7047);
+static_assert(celsius(3) / 4 == celsius::from_raw(75));
+static_assert(celsius::from_raw(-150) < celsius(-1));
+
+template <typename F>
+static const char* text(char* buffer, F value) {
+    return fixtoa(value, buffer);
+}
+
+TEST(fixed_point_arithmetic_rounds_half_away_from_zero) {
+    CHECK((celsius::from_raw(150) * celsius::from_raw(150)).raw() == 225);   // 1.5 * 1.5
+    CHECK((celsius::from_raw(105) * celsius::from_raw(105)).raw() == 110);   // 1.1025
+    CHECK((celsius::from_raw(-105) * celsius::from_raw(105)).raw() == -110);
+    CHECK((celsius(1) / celsius(3)).raw() == 33);
+    CHECK((celsius(2) / celsius(3)).raw() == 67);
+    CHECK((celsius(-2) / celsius(3)).raw() == -67);
+    CHECK((celsius(2) / celsius(-3)).raw() == -67);
+    CHECK((celsius::from_raw(5) / 2).raw() == 3);
+    CHECK((celsius::from_raw(-5) / 2).raw() == -3);
+    CHECK((celsius(2) * 3).raw() == 600);
+    CHECK((3 * celsius(2)).raw() == 600);
+    CHECK((celsius(10) - celsius::from_raw(1)).raw() == 999);
+    CHECK((-celsius(4)).raw() == -400);
+
+    celsius total;
+    for (int i = 0; i < 10; i++) total += celsius::from_raw(10);
+    CHECK(total == 1);
+    CHECK(total.integer() == 1 && total.fraction() == 0);
+    CHECK(celsius::from_raw(-1234).integer() == -12 && celsius::from_raw(-1234).fraction() == -34);
+    CHECK(static_cast<double>(celsius::from_raw(-1234)) == -12.34);
+
+    // 32-bit values multiply in 64 bits
+    const fixed_point<3> big = fixed_point<3>(40000);
+    CHECK((big * fixed_point<3>(50)).raw() == 2000000000);
+    CHECK(fixed_point<1>(fixed_point<3>::from_raw(1250)).raw() == 13);
+    CHECK(fixed_point<1>(fixed_point<3>::from_raw(-1250)).raw() == -13);
+    CHECK(fixed_point<4>(celsius::from_raw(-5)).raw() == -500);
+}
+
+TEST(fixed_point_formats) {
+    char buffer[fixed_point<3, int64_t>::STRING_SIZE];
+    CHECK_STR(text(buffer, celsius::from_raw(2137)), "21.37");
+    CHECK_STR(text(buffer, celsius::from_raw(-5)), "-0.05");
+    CHECK_STR(text(buffer, celsius::from_raw(0)), "0.00");
+    CHECK_STR(text(buffer, celsius::from_raw(100)), "1.00");
+    CHECK_STR(text(buffer, fixed_point<0>(42)), "42");
+    CHECK_STR(text(buffer, fixed_point<3>::from_raw(-2147483647 - 1)), "-2147483.648");
+    CHECK_STR(text(buffer, fixed_point<1, int8_t>::from_raw(-128)), "-12.8");
+    CHECK_STR(text(buffer, fixed_point<3, int64_t>::from_raw(9223372036854775807)), "9223372036854775.807");
+    CHECK_STR(text(buffer, fixed_point<12, int64_t>::from_raw(-1)), "-0.000000000001");
+    using wide = fixed_point<3, int64_t>;
+    CHECK(strlen(text(buffer, wide::from_raw(-9223372036854775807 - 1))) < wide::STRING_SIZE);
+}
+
+TEST(fixed_point_parses) {
+    celsius value;
+    CHECK(celsius::parse("21.37", value) && value.raw() == 2137);
+    CHECK(celsius::parse("-0.5", value) && value.raw() == -50);
+    CHECK(celsius::parse("+7", value) && value.raw() == 700);
+    CHECK(celsius::parse(".25", value) && value.raw() == 25);
+    CHECK(celsius::parse("3.", value) && value.raw() == 300);
+    CHECK(celsius::parse("1.005", value) && value.raw() == 101);
+    CHECK(celsius::parse("1.0049", value) && value.raw() == 100);
+    CHECK(celsius::parse("0.999", value) && value.raw() == 100);
+    CHECK(celsius::parse("-21474836.48", value) && value.raw() == -2147483647 - 1);
+    CHECK(celsius::parse("21474836.47", value) && value.raw() == 2147483647);
+
+    value = celsius(9);
+    CHECK(!celsius::parse("21474836.48", value));
+    CHECK(!celsius::parse("99999999999", value));
+    CHECK(!celsius::parse("", value));
+    CHECK(!celsius::parse("-", value));
+    CHECK(!celsius::parse(".", value));
+    CHECK(!celsius::parse("1.2.3", value));
+    CHECK(!celsius::parse("12a", value));
+    CHECK(!celsius::parse(" 1", value));
+    CHECK(value == 9);
+    using tiny = fixed_point<1, int8_t>;
+    tiny small;
+    CHECK(tiny::parse("-12.8", small) && small.raw() == -128);
+    CHECK(!tiny::parse("12.8", small));
+
+    // formatting and parsing round-trip
+    char buffer[celsius::STRING_SIZE];
+    for (int32_t raw = -100000; raw <= 100000; raw += 777) {
+        celsius parsed;
+        CHECK(celsius::parse(fixtoa(celsius::from_raw(raw), buffer), parsed) && parsed.raw() == raw);
+    }
+}
+
+TEST(fixed_point_with_strings) {
+    String line("t=");
+    line += celsius::from_raw(2137);
+    CHECK_STR(line.c_str(), "t=21.37");
+    line.concat(fixed_point<1>::from_raw(-5));
+    CHECK_STR(line.c_str(), "t=21.37-0.5");
+    CHECK_STR((String("v") + fixed_point<3>::from_raw(1)).c_str(), "v0.001");
+    CHECK_STR(String(celsius(-3)).c_str(), "-3.00");
+    CHECK(U16String(celsius::from_raw(250)) == u"2.50");
+
+    CHECK(String("12.5").toFixed<2>().raw() == 1250);
+    CHECK(String("12.5x").toFixed<2>().raw() == 0);
+    CHECK(U16String(u"-0.25").toFixed<3>().raw() == -250);
+    using deci = fixed_point<1, int16_t>;
+    CHECK((String("7").toFixed<1, int16_t>() == deci(7)));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,102 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/array.hpp"
+#include "std/format_values.hpp"
+#include "std/static_vector.hpp"
+
+template <typename T, size_t N>
+static const char* formatted(char* buffer, const T (&values)[N], const char* separator = ",", uint8_t base = 10) {
+    const auto size = format_values(values, N, buffer, separator, base);
+    buffer[size] = '\0';
+    return buffer;
+}
+
+constexpr bool formats_at_compile_time() {
+    const int values[] = {-5, 0, 120};
+    char out[16]{};
+    const auto size = format_values(values, 3, out, ", ");
+    return size == 10 && size == formatted_size(values, 3, ", ") && out[0] == '-' && out[4] == '0' && out[9] == '0';
+}
+static_assert(formats_at_compile_time());
+
+TEST(format_values_joins_with_separator) {
+    char buffer[128];
+    const uint16_t samples[] = {512, 0, 1023, 7, 65535};
+    CHECK_STR(formatted(buffer, samples), "512,0,1023,7,65535");
+    CHECK_STR(formatted(buffer, samples, " "), "512 0 1023 7 65535");
+    CHECK_STR(formatted(buffer, samples, ", "), "512, 0, 1023, 7, 65535");
+    CHECK_STR(formatted(buffer, samples, ""), "512010237" "65535");
+    CHECK_STR(formatted(buffer, samples, nullptr), "512010237" "65535");
+    CHECK(formatted_size(samples, 5, ", ") == 22);
+    CHECK(format_values(samples, 0, buffer) == 0);
+
+    const uint8_t single[] = {9};
+    CHECK_STR(formatted(buffer, single), "9");
+}
+
+TEST(format_values_signed_and_bases) {
+    char buffer[256];
+    const int32_t readings[] = {-2147483647 - 1, -1, 0, 2147483647};
+    CHECK_STR(formatted(buffer, readings), "-2147483648,-1,0,2147483647");
+    CHECK_STR(formatted(buffer, readings, ":", 16), "-80000000:-1:0:7fffffff");
+
+    const uint8_t bytes[] = {0, 5, 255};
+    CHECK_STR(formatted(buffer, bytes, " ", 2), "0 101 11111111");
+    CHECK_STR(formatted(buffer, bytes, " ", 8), "0 5 377");
+    CHECK_STR(formatted(buffer, bytes, " ", 36), "0 5 73");
+
+    const uint64_t wide[] = {18446744073709551615ull, 10000000000ull};
+    CHECK_STR(formatted(buffer, wide, ";"), "18446744073709551615;10000000000");
+    const int8_t small[] = {-128, 127};
+    CHECK_STR(formatted(buffer, small), "-128,127");
+
+    // nothing at all in an invalid base
+    CHECK(formatted_size(readings, 4, ",", 1) == 0);
+    CHECK_STR(formatted(buffer, readings, ",", 0), "");
+    String line("x");
+    CHECK(format_values(readings, 4, line, ",", 1));
+    CHECK_STR(line.c_str(), "x");
+}
+
+TEST(format_values_matches_itoa) {
+    char buffer[64 * 12];
+    char expected[64 * 12];
+    int32_t values[64];
+    uint32_t seed = 12345;
+    for (auto& value : values) {
+        seed = seed * 1103515245u + 12345u;
+        value = static_cast<int32_t>(seed) >> (seed % 31);
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < 64; i++) {
+        if (i > 0) expected[used++] = ',';
+        itoa(values[i], expected + used);
+        used += strlen(expected + used);
+    }
+    CHECK(formatted_size(values, 64) == used);
+    CHECK_STR(formatted(buffer, values), expected);
+}
+
+TEST(format_values_appends_to_strings) {
+    array<uint16_t, 4> samples{{1, 22, 333, 4444}};
+    String line("adc:");
+    CHECK(format_values(samples, line, " "));
+    CHECK_STR(line.c_str(), "adc:1 22 333 4444");
+    CHECK(line.length() == 17);
+
+    static_vector<int, 8> deltas;
+    deltas.push_back(-3);
+    deltas.push_back(4);
+    CHECK(formatted_size(deltas) == 4);
+    SharedString shared("d=");
+    SharedString copy(shared);
+    CHECK(format_values(deltas, shared));
+    CHECK_STR(shared.c_str(), "d=-3,4");
+    CHECK_STR(copy.c_str(), "d=");
+
+    char out[8];
+    CHECK(format_values(deltas, out, "|", 16) == 4);
+    CHECK(memcmp(out, "-3|4", 4) == 0);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,153 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "FrameReader.hpp"
+
+static StringView view(const char* text) {
+    return StringView(text, strlen(text));
+}
+
+// a stream that hands over bytes in bulk, like ESP32's HardwareSerial
+struct BulkStream {
+    const char* data;
+    size_t size;
+    size_t position{0};
+    size_t calls{0};
+
+    int available() { return static_cast<int>(size - position); }
+    int read() { return position < size ? static_cast<uint8_t>(data[position++]) : -1; }
+    size_t read(uint8_t* buffer, size_t count) {
+        calls++;
+        memcpy(buffer, data + position, count);
+        position += count;
+        return count;
+    }
+};
+
+TEST(reads_lines_from_serial) {
+    Serial.clear();
+    Serial.feed("help\r\nstatus\n\nled o");
+    FrameReader<16> reader;
+    StringView line;
+    CHECK(reader.next(Serial, line) && line == view("help"));
+    CHECK(reader.next(Serial, line) && line == view("status"));
+    CHECK(reader.next(Serial, line) && line.length() == 0);
+    CHECK(!reader.next(Serial, line));
+    CHECK(reader.buffered() == 5);
+
+    Serial.feed("n\n");
+    CHECK(reader.next(Serial, line) && line == view("led on"));
+    CHECK(!reader.next(Serial, line));
+    CHECK(reader.dropped() == 0);
+}
+
+TEST(frames_point_into_the_buffer) {
+    FrameReader<32> reader;
+    reader.feed("abc\ndef\n", 8);
+    StringView first, second;
+    CHECK(reader.next(first) && reader.next(second));
+    CHECK(second.data() == first.data() + 4);
+}
+
+TEST(drops_lines_longer_than_the_buffer) {
+    Serial.clear();
+    Serial.feed("this line is far too long for eight bytes\nok\n");
+    FrameReader<8> reader;
+    StringView line;
+    CHECK(reader.next(Serial, line) && line == view("ok"));
+    CHECK(reader.dropped() == 1);
+    CHECK(!reader.next(Serial, line));
+}
+
+TEST(compacts_across_many_refills) {
+    // 200 lines through a 12 byte buffer, fed a few bytes at a time
+    FrameReader<12> reader;
+    char text[8];
+    size_t lines = 0;
+    bool in_order = true;
+    for (int i = 0; i < 200; i++) {
+        const auto length = snprintf(text, sizeof(text), "n%d\n", i);
+        for (int sent = 0; sent < length;) {
+            sent += static_cast<int>(reader.feed(text + sent, static_cast<size_t>(length - sent < 3 ? length - sent : 3)));
+            StringView line;
+            while (reader.next(line)) {
+                char expected[8];
+                snprintf(expected, sizeof(expected), "n%zu", lines++);
+                in_order &= line == view(expected);
+            }
+        }
+    }
+    CHECK(in_order);
+    CHECK(lines == 200);
+}
+
+TEST(uses_bulk_reads_when_the_stream_has_them) {
+    static_assert(BulkReadableStreamType<BulkStream>);
+    static_assert(!BulkReadableStreamType<HardwareSerial>);
+    BulkStream stream{"one\ntwo\nthree\n", 14};
+    FrameReader<64> reader;
+    StringView line;
+    size_t count = 0;
+    while (reader.next(stream, line)) count++;
+    CHECK(count == 3);
+    CHECK(stream.calls == 1);
+}
+
+TEST(decodes_cobs) {
+    // examples from the COBS paper and Wikipedia
+    const char encoded[] = "\x01\x01\x00" "\x03\x11\x22\x02\x33\x00" "\x00" "\x02\x11\x01\x01\x01\x00" "\x03\x11\x00";
+    FrameReader<32, Framing::Cobs> reader;
+    reader.feed(encoded, sizeof(encoded) - 1);
+    StringView frame;
+    CHECK(reader.next(frame) && frame.length() == 1 && frame[0] == 0);
+    CHECK(reader.next(frame) && frame.length() == 4 && memcmp(frame.data(), "\x11\x22\x00\x33", 4) == 0);
+    CHECK(reader.next(frame) && frame.length() == 4 && memcmp(frame.data(), "\x11\x00\x00\x00", 4) == 0);
+    CHECK(!reader.next(frame)); // "\x03\x11" claims one byte more than it has
+    CHECK(reader.dropped() == 1);
+}
+
+TEST(decodes_cobs_blocks_of_254) {
+    char encoded[258];
+    encoded[0] = static_cast<char>(0xFF);
+    for (int i = 1; i < 255; i++) encoded[i] = static_cast<char>(i);
+    encoded[255] = 0x02;
+    encoded[256] = 'x';
+    encoded[257] = 0;
+    FrameReader<300, Framing::Cobs> reader;
+    reader.feed(encoded, sizeof(encoded));
+    StringView frame;
+    CHECK(reader.next(frame) && frame.length() == 255);
+    CHECK(static_cast<uint8_t>(frame[253]) == 254 && frame[254] == 'x');
+}
+
+TEST(decodes_slip) {
+    const char encoded[] = "\xC0" "ab\xDB\xDC" "c\xDB\xDD\xC0" "\xC0" "d\xC0";
+    FrameReader<16, Framing::Slip> reader;
+    reader.feed(encoded, sizeof(encoded) - 1);
+    StringView frame;
+    CHECK(reader.next(frame) && frame == StringView("ab\xC0" "c\xDB", 5));
+    CHECK(reader.next(frame) && frame == view("d"));
+    CHECK(!reader.next(frame));
+}
+
+TEST(reads_length_prefixed_frames) {
+    const char encoded[] = "\x00\x03" "abc" "\x00\x00" "\x00\x20" "0123456789abcdef0123456789abcdef" "\x00\x02" "hi" "\x00\x05" "par";
+    FrameReader<16, Framing::LengthPrefixed> reader;
+    StringView frame;
+    size_t sent = 0;
+    const auto feed = [&](size_t size) { sent += reader.feed(encoded + sent, size); };
+
+    feed(4);
+    CHECK(!reader.next(frame));
+    feed(3);
+    CHECK(reader.next(frame) && frame == view("abc"));
+    CHECK(reader.next(frame) && frame.length() == 0);
+    // the 32 byte frame can't fit and is skipped as it streams past
+    while (!reader.next(frame) && sent < sizeof(encoded) - 1) feed(5);
+    CHECK(frame == view("hi"));
+    CHECK(reader.dropped() == 1);
+    feed(sizeof(encoded) - 1 - sent);
+    CHECK(!reader.next(frame));
+    CHECK(reader.buffered() == 5);
+}
+
+int main() { return run_tests(); }
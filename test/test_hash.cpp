@@ -0,0 +1,106 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/hash.hpp"
+
+// reference values from the FNV specification's test suite
+static_assert(fnv1a("", 0) == 0x811c9dc5u);
+static_assert(fnv1a("a", 1) == 0xe40c292cu);
+static_assert(fnv1a("foobar", 6) == 0xbf9cf968u);
+static_assert(fnv1a64("", 0) == 0xcbf29ce484222325ull);
+static_assert(fnv1a64("a", 1) == 0xaf63dc4c8601ec8cull);
+static_assert(fnv1a64("foobar", 6) == 0x85944171f73967e8ull);
+static_assert("foobar"_hash == 0xbf9cf968u);
+
+static_assert(wyhash("status") == wyhash("status", 6));
+static_assert(wyhash("status") != wyhash("statut"));
+
+constexpr auto g_commands = make_command_table("help", "status", "reset", "led on", "led off", "version", "reboot", "log level", "", "set");
+
+TEST(fnv1a_matches_at_runtime) {
+    const String text("foobar");
+    CHECK(fnv1a(text) == "foobar"_hash);
+    CHECK(fnv1a(StringView(text)) == 0xbf9cf968u);
+    CHECK(fnv1a64(text) == 0x85944171f73967e8ull);
+
+    switch (fnv1a(String("status"))) {
+        case "help"_hash: CHECK(false); break;
+        case "status"_hash: break;
+        default: CHECK(false);
+    }
+}
+
+TEST(wyhash_matches_compile_time_for_every_length) {
+    // crosses the 3, 4, 8, 16 and 48 byte boundaries of the algorithm
+    char text[130];
+    for (size_t i = 0; i < sizeof(text); i++) text[i] = static_cast<char>('a' + i % 26);
+
+    constexpr auto expected_long = wyhash("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+    CHECK(wyhash(text, 130) == expected_long);
+
+    uint64_t previous = 0;
+    for (size_t length = 0; length <= sizeof(text); length++) {
+        const auto hash = wyhash(text, length);
+        CHECK(hash != previous);
+        CHECK(wyhash(text, length, 1) != hash);
+        previous = hash;
+    }
+}
+
+TEST(wyhash_spreads_small_differences) {
+    // single bit changes should flip about half of the output bits
+    char key[24] = "sensor/temperature/0001";
+    const auto base = wyhash(key, 23);
+    int total = 0;
+    for (size_t i = 0; i < 23; i++) {
+        key[i] ^= 1;
+        total += __builtin_popcountll(wyhash(key, 23) ^ base);
+        key[i] ^= 1;
+    }
+    CHECK(total / 23 > 24 && total / 23 < 40);
+}
+
+TEST(command_table_finds_every_name) {
+    for (size_t i = 0; i < g_commands.size(); i++) {
+        CHECK(g_commands.find(g_commands[i]) == static_cast<int>(i));
+    }
+    CHECK(g_commands.find("status") == 1);
+    CHECK(g_commands.find(String("led off")) == 4);
+    CHECK(g_commands.find("") == 8);
+}
+
+TEST(command_table_rejects_other_text) {
+    CHECK(g_commands.find("stat") == -1);
+    CHECK(g_commands.find("statuss") == -1);
+    CHECK(g_commands.find("HELP") == -1);
+    CHECK(g_commands.find("led") == -1);
+    CHECK(!g_commands.contains(String("reboot now")));
+}
+
+TEST(command_table_dispatches_in_a_switch) {
+    const auto dispatch = [](const String& input) {
+        switch (g_commands.find(input)) {
+            case g_commands.index("help"): return 1;
+            case g_commands.index("reset"): return 2;
+            case g_commands.index("log level"): return 3;
+            default: return 0;
+        }
+    };
+    CHECK(dispatch(String("help")) == 1);
+    CHECK(dispatch(String("reset")) == 2);
+    CHECK(dispatch(String("log level")) == 3);
+    CHECK(dispatch(String("status")) == 0);
+    CHECK(dispatch(String("nope")) == 0);
+}
+
+TEST(command_table_with_many_names) {
+    static constexpr auto table = make_command_table(
+        "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "a8", "a9", "b0", "b1", "b2", "b3", "b4", "b5",
+        "b6", "b7", "b8", "b9", "c0", "c1", "c2", "c3", "c4", "c5", "c6", "c7", "c8", "c9", "d0", "d1",
+        "d2", "d3", "d4", "d5", "d6", "d7", "d8", "d9", "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7");
+    for (size_t i = 0; i < table.size(); i++) {
+        CHECK(table.find(table[i]) == static_cast<int>(i));
+    }
+    CHECK(table.find("f0") == -1);
+}
+
+int main() { return run_tests(); }
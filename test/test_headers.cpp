@@ -0,0 +1,62 @@
+// Every public header has to compile on its own and together with the rest.
+// stdlib_compatibility.hpp is left out: it provides std:: pieces that only
+// the microcontroller toolchains lack and would clash with the host's.
+#include <Arduino.h>
+#include "BufferedStream.hpp"
+#include "Coroutine.hpp"
+#include "DeviceCapture.hpp"
+#include "FrameReader.hpp"
+#include "Interrupt.hpp"
+#include "Logger.hpp"
+#include "RecordLog.hpp"
+#include "Register.hpp"
+#include "unique_ptr.hpp"
+#include "std/allocation_trace.hpp"
+#include "std/allocator.hpp"
+#include "std/array.hpp"
+#include "std/bitset.hpp"
+#include "std/char_traits.hpp"
+#include "std/encoding.hpp"
+#include "std/fixed_point.hpp"
+#include "std/flat_map.hpp"
+#include "std/format_values.hpp"
+#include "std/hash.hpp"
+#include "std/iterator.hpp"
+#include "std/probe_table.hpp"
+#include "std/simd.hpp"
+#include "std/static_ring.hpp"
+#include "std/static_vector.hpp"
+#include "std/stdlib.hpp"
+#include "std/string_map.hpp"
+#include "std/string_pool.hpp"
+#include "std/String.hpp"
+#include "std/StringView.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utf8.hpp"
+
+// Instantiate everything so that errors in members nobody calls yet show up
+template class StringBase<char>;
+template class StringBase<char, copy_on_write<>>;
+template class StringBase<char16_t>;
+template class StringBase<char32_t, copy_on_write<>>;
+template class array<int, 4>;
+template class bitset<8>;
+template class bitset<100>;
+template class fixed_point<2>;
+template class fixed_point<1, int8_t>;
+template class static_vector<int, 4>;
+template class static_ring<int, 4>;
+template class flat_map<int, int, 4>;
+template class string_map<int, 4>;
+template class string_pool<4>;
+template class detail::probe_table<300>;
+template class FrameReader<8>;
+template class DeviceCapture<>;
+template class BufferedStream<HardwareSerial>;
+template class FrameReader<8, Framing::Cobs>;
+template class FrameReader<8, Framing::Slip>;
+template class FrameReader<8, Framing::LengthPrefixed>;
+template class unique_ptr<int>;
+template class unique_ptr<int[]>;
+
+int main() { return 0; }
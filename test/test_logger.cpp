@@ -0,0 +1,126 @@
+#include "test.hpp"
+#define DEBUG true
+#define TRACE_ALLOCATIONS true
+#include <Arduino.h>
+#include "Logger.hpp"
+#include "BufferedStream.hpp"
+
+enum class Mode : uint8_t { Idle = 0, Running = 3 };
+
+namespace sensors {
+struct Reading {
+    uint8_t channel;
+    int millivolts;
+};
+
+template <BasicStreamType S>
+void print_to(S& str, const Reading& reading) {
+    Logger::print(str, "ch", reading.channel, '=', reading.millivolts, "mV");
+}
+} // namespace sensors
+
+struct Opaque {};
+static_assert(BasicPrintableType<sensors::Reading>);
+static_assert(BasicPrintableType<Mode>);
+static_assert(BasicPrintableType<array<int, 3>>);
+static_assert(!BasicPrintableType<Opaque>);
+
+TEST(prints_every_argument) {
+    Serial.clear();
+    Logger::log("value=", 42, ' ', String("ok"));
+    CHECK(Serial.output() == "value=42 ok");
+}
+
+TEST(prints_numbers_without_building_strings) {
+    Serial.clear();
+    AllocationTracer::reset();
+    Logger::log(-32768, ' ', 65535u, ' ', -9223372036854775807LL - 1, ' ', static_cast<uint8_t>(200), ' ', true, ' ', 2.345f, ' ', -1.0 / 0.0);
+    CHECK(Serial.output() == "-32768 65535 -9223372036854775808 200 1 2.35 inf");
+    CHECK(AllocationTracer::allocations() == 0);
+}
+
+TEST(prints_fixed_point_values) {
+    Serial.clear();
+    AllocationTracer::reset();
+    Logger::log("t=", fixed_point<2>::from_raw(-2137), ' ', fixed_point<3, int16_t>::from_raw(5));
+    CHECK(Serial.output() == "t=-21.37 0.005");
+    CHECK(AllocationTracer::allocations() == 0);
+}
+
+TEST(prints_enums_views_arrays_and_custom_types) {
+    Serial.clear();
+    const array<int, 3> samples{1, -2, 3};
+    const char text[] = "sensor/temperature";
+    Logger::log(Mode::Running, ' ', StringView(text, 6), ' ', samples, ' ', sensors::Reading{2, 1250}, ' ', F("flash"));
+    CHECK(Serial.output() == "3 sensor [1, -2, 3] ch2=1250mV flash");
+}
+
+TEST(prints_through_a_buffered_stream) {
+    Serial.clear();
+    {
+        BufferedStream<HardwareSerial> out(Serial);
+        Logger::print(out, "adc=", 512, " v=", 1.5, ' ', sensors::Reading{0, -5});
+    }
+    CHECK(Serial.output() == "adc=512 v=1.50 ch0=-5mV");
+    CHECK(Serial.writes() == 1);
+}
+
+TEST(traces_string_allocations) {
+    AllocationTracer::reset();
+    {
+        String s("abc");
+        for (int i = 0; i < 5; i++) s += "0123456789";
+        String moved(std::move(s));
+    }
+    CHECK(AllocationTracer::site(AllocationSite::Construct).calls == 2);
+    CHECK(AllocationTracer::site(AllocationSite::Concat).calls > 0);
+    CHECK(AllocationTracer::site(AllocationSite::Move).calls == 1);
+    CHECK(AllocationTracer::allocations() == AllocationTracer::frees());
+    CHECK(AllocationTracer::current() == 0);
+    CHECK(AllocationTracer::peak() >= 53);
+
+    Serial.clear();
+    Logger::allocations();
+    CHECK(Serial.output().find("concat: ") != std::string::npos);
+    CHECK(Serial.output().find("peak: ") != std::string::npos);
+}
+
+TEST(traces_each_operation_to_its_site) {
+    const auto calls = [](AllocationSite site) { return AllocationTracer::site(site).calls; };
+    AllocationTracer::reset();
+    {
+        String s("abc");
+        s.reserve(40);
+        CHECK(calls(AllocationSite::Reserve) == 1);
+        s = "0123456789012345678901234567890123456789012345";
+        CHECK(calls(AllocationSite::Copy) == 1);
+        s += "0123456789";
+        CHECK(calls(AllocationSite::Concat) == 1);
+        s.replace(String("0"), String("00000000"));
+        CHECK(calls(AllocationSite::Replace) == 1);
+
+        SharedString a("shared");
+        SharedString b(a);
+        b.setCharAt(0, 'S');
+        CHECK(calls(AllocationSite::Unshare) == 1);
+    }
+    CHECK(calls(AllocationSite::Reserve) == 1 && calls(AllocationSite::Copy) == 1 && calls(AllocationSite::Concat) == 1);
+    CHECK(AllocationTracer::allocations() == AllocationTracer::frees());
+}
+
+TEST(traces_shared_copies) {
+    AllocationTracer::reset();
+    {
+        SharedString a("0123456789");
+        SharedString b(a);
+        SharedString c = a.subString(2, 5);
+        CHECK(AllocationTracer::allocations() == 1);
+        CHECK(AllocationTracer::site(AllocationSite::Share).calls == 2);
+        c += "x";
+        CHECK(AllocationTracer::allocations() == 2);
+    }
+    CHECK(AllocationTracer::allocations() == AllocationTracer::frees());
+    CHECK(AllocationTracer::current() == 0);
+}
+
+int main() { return run_tests(); }
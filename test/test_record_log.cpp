@@ -0,0 +1,227 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "DeviceCapture.hpp"
+#include "RecordLog.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+// a file name of its own for every test, removed at the end of it
+struct TempPath {
+    char path[32];
+    TempPath() {
+        strcpy(path, "/tmp/record_logXXXXXX");
+        const int fd = mkstemp(path);
+        if (fd >= 0) close(fd);
+    }
+    ~TempPath() { unlink(path); }
+};
+
+// a pseudo-terminal: the test writes to 'device' like firmware would, and
+// the capture reads the slave side like a serial port
+struct FakeDevice {
+    int device{-1};
+    int port{-1};
+    FakeDevice() {
+        device = posix_openpt(O_RDWR | O_NOCTTY);
+        if (device >= 0 && grantpt(device) == 0 && unlockpt(device) == 0) port = open_device(ptsname(device));
+    }
+    ~FakeDevice() {
+        hang_up();
+        if (port >= 0) close(port);
+    }
+    void send(const char* text) const { CHECK(write(device, text, strlen(text)) == static_cast<ssize_t>(strlen(text))); }
+    void hang_up() {
+        if (device >= 0) close(device);
+        device = -1;
+    }
+};
+
+// pseudo-terminals pass bytes on asynchronously, so one poll() may see
+// only part of what was sent
+template <typename Capture>
+size_t poll_until(Capture& capture, size_t records) {
+    for (int i = 0; i < 100 && capture.records() < records; i++) capture.poll(10);
+    return capture.records();
+}
+
+bool equals(StringView view, const char* text) { return view == StringView(text, strlen(text)); }
+
+} // namespace
+
+TEST(appends_and_reads_back_records) {
+    TempPath file;
+    auto log = RecordLog::create(file.path, 256, 8);
+    CHECK(static_cast<bool>(log));
+    CHECK(log.empty() && log.capacity() == 8 && log.data_capacity() == 256);
+
+    CHECK(log.append(3, 100, "boot", 4));
+    CHECK(log.append(1, 200, StringView("t=21.37")));
+    CHECK(log.append(3, 200, "", 0));
+    CHECK(log.append(2, 350, StringView("v=512")));
+    CHECK(log.size() == 4);
+    CHECK(log.data_used() == 16 + 16 + 8 + 16);
+
+    CHECK(log[0].source == 3 && log[0].timestamp == 100 && equals(log[0].payload, "boot"));
+    CHECK(log[1].source == 1 && equals(log[1].payload, "t=21.37"));
+    CHECK(log[2].payload.length() == 0);
+    CHECK(log.seek(0) == 0);
+    CHECK(log.seek(150) == 1);
+    CHECK(log.seek(200) == 1);
+    CHECK(log.seek(201) == 3);
+    CHECK(log.seek(1000) == 4);
+
+    size_t count = 0;
+    for (auto record : log) count += record.payload.length();
+    CHECK(count == 4 + 7 + 0 + 5);
+}
+
+TEST(refuses_records_when_full) {
+    TempPath file;
+    auto log = RecordLog::create(file.path, 64, 3);
+    char payload[100] = {};
+    CHECK(!log.append(0, 0, payload, 57)); // 8 + 57 bytes don't fit 64
+    CHECK(log.append(0, 0, payload, 56));
+    CHECK(!log.append(0, 0, payload, 0));
+    CHECK(log.size() == 1);
+
+    auto short_index = RecordLog::create(file.path, 1024, 2);
+    CHECK(short_index.append(0, 0, "a", 1) && short_index.append(0, 0, "b", 1));
+    CHECK(!short_index.append(0, 0, "c", 1));
+}
+
+TEST(reopens_a_segment) {
+    TempPath file;
+    {
+        auto log = RecordLog::create(file.path, 1024, 16);
+        CHECK(log.append(7, 10, StringView("first")));
+        CHECK(log.flush(true));
+    }
+    auto log = RecordLog::open(file.path);
+    CHECK(static_cast<bool>(log) && log.size() == 1);
+    CHECK(log.append(7, 20, StringView("second")));
+
+    // a reader sees the writer's records through its own mapping
+    const auto reader = RecordLog::open(file.path, false);
+    CHECK(reader.size() == 2 && equals(reader[1].payload, "second"));
+    CHECK(log.append(8, 30, StringView("third")));
+    CHECK(reader.size() == 3 && reader[2].source == 8);
+
+    auto read_only = RecordLog::open(file.path, false);
+    CHECK(!read_only.append(0, 0, "x", 1));
+
+    TempPath other;
+    FILE* text = fopen(other.path, "w");
+    fputs("not a segment, but long enough to hold a header of 64 bytes......", text);
+    fclose(text);
+    CHECK(!RecordLog::open(other.path));
+    CHECK(errno == EINVAL);
+    CHECK(!RecordLog::open("/nonexistent/segment"));
+}
+
+TEST(rejects_records_outside_the_data) {
+    TempPath file;
+    {
+        auto log = RecordLog::create(file.path, 1024, 16);
+        CHECK(log.append(1, 10, StringView("first")));
+        CHECK(log.append(1, 20, StringView("second")));
+    }
+    CHECK(RecordLog::open(file.path, false).size() == 2);
+
+    // the second record's index entry and header, as a hand-edit would change them
+    const off_t entry = sizeof(RecordLog::Header) + sizeof(RecordLog::IndexEntry);
+    const off_t record = sizeof(RecordLog::Header) + 16 * sizeof(RecordLog::IndexEntry) + 16;
+    const int fd = open(file.path, O_RDWR);
+    const uint64_t past_end = 4096;
+    CHECK(pwrite(fd, &past_end, sizeof(past_end), entry) == sizeof(past_end));
+    CHECK(!RecordLog::open(file.path, false));
+    CHECK(errno == EINVAL);
+
+    const uint64_t offset = 16;
+    const uint32_t too_long = 1000;
+    CHECK(pwrite(fd, &offset, sizeof(offset), entry) == sizeof(offset));
+    CHECK(RecordLog::open(file.path, false).size() == 2);
+    CHECK(pwrite(fd, &too_long, sizeof(too_long), record) == sizeof(too_long));
+    CHECK(!RecordLog::open(file.path, false));
+    CHECK(errno == EINVAL);
+    close(fd);
+}
+
+TEST(captures_pseudo_terminals) {
+    TempPath file;
+    auto log = RecordLog::create(file.path, 1 << 16, 256);
+    DeviceCapture<32> capture(log);
+    FakeDevice sensor, gateway;
+    CHECK(sensor.port >= 0 && gateway.port >= 0);
+    capture.add(sensor.port, 1);
+    capture.add(gateway.port, 2);
+
+    sensor.send("t=21.37\r\nt=21.");
+    CHECK(poll_until(capture, 1) == 1);
+    gateway.send("rssi=-70\n");
+    CHECK(poll_until(capture, 2) == 2);
+    sensor.send("40\r\n");
+    CHECK(poll_until(capture, 3) == 3);
+    CHECK(capture.poll(0) == 0);
+
+    // a line longer than the reader's buffer is dropped, not split
+    sensor.send("this line is far too long for 32 bytes\nok\n");
+    CHECK(poll_until(capture, 4) == 4);
+    CHECK(capture.dropped() == 1);
+
+    CHECK(log.size() == 4 && capture.records() == 4);
+    CHECK(log[0].source == 1 && equals(log[0].payload, "t=21.37"));
+    CHECK(log[1].source == 2 && equals(log[1].payload, "rssi=-70"));
+    CHECK(log[2].source == 1 && equals(log[2].payload, "t=21.40"));
+    CHECK(equals(log[3].payload, "ok"));
+    CHECK(log[0].timestamp <= log[2].timestamp && log[2].timestamp <= log[3].timestamp);
+
+    gateway.send("bye\n");
+    CHECK(poll_until(capture, 5) == 5);
+    // closing the master side hangs the port up, which stops the capture
+    sensor.hang_up();
+    gateway.hang_up();
+    for (int i = 0; i < 10 && capture.active(); i++) capture.poll(100);
+    CHECK(!capture.active());
+    CHECK(log.size() == 5 && equals(log[4].payload, "bye"));
+}
+
+TEST(refuses_ports_that_are_not_terminals) {
+    TempPath file;
+    errno = 0;
+    CHECK(open_device(file.path) == -1);
+    CHECK(errno == ENOTTY);
+    CHECK(open_device("/nonexistent/tty") == -1);
+    CHECK(errno == ENOENT);
+}
+
+TEST(captures_cobs_frames) {
+    TempPath file;
+    auto log = RecordLog::create(file.path, 1024, 16);
+    DeviceCapture<64, Framing::Cobs> capture(log);
+    FakeDevice device;
+    capture.add(device.port, 9);
+
+    // {0x11, 0x00, 0x22} and {0x33}
+    const char frames[] = {0x02, 0x11, 0x02, 0x22, 0x00, 0x02, 0x33, 0x00};
+    CHECK(write(device.device, frames, sizeof(frames)) == sizeof(frames));
+    CHECK(poll_until(capture, 2) == 2);
+    CHECK(log[0].payload.length() == 3 && log[0].payload[1] == '\0' && log[0].payload[2] == 0x22);
+    CHECK(log[1].payload.length() == 1 && log[1].payload[0] == 0x33);
+
+}
+
+TEST(stops_appending_when_the_log_is_full) {
+    TempPath file;
+    auto log = RecordLog::create(file.path, 4096, 2);
+    DeviceCapture<> capture(log);
+    FakeDevice device;
+    capture.add(device.port, 0);
+    device.send("a\nb\nc\n");
+    for (int i = 0; i < 100 && capture.records() + capture.lost() < 3; i++) capture.poll(10);
+    CHECK(capture.records() == 2 && log.size() == 2);
+    CHECK(capture.lost() == 1);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,62 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "Register.hpp"
+
+namespace {
+volatile uint8_t g_control = 0;
+volatile uint16_t g_timer = 0;
+}
+
+REGISTER_TYPE(g_control);
+REGISTER_TYPE(g_timer);
+
+enum class Prescaler : uint8_t { Stopped = 0, Div1 = 1, Div8 = 2, Div64 = 3, Div256 = 4 };
+
+using enable = register_field<g_control_register, 7>;
+using prescaler = register_field<g_control_register, 2, 3, Prescaler>;
+using mode = register_field<g_control_register, 0, 2>;
+using top = register_field<g_timer_register, 4, 12, uint16_t>;
+
+static_assert(RegisterType<g_control_register>);
+static_assert(enable::MASK == 0x80 && prescaler::MASK == 0x1C && top::MASK == 0xFFF0);
+static_assert(prescaler::encode(Prescaler::Div64) == 0x0C);
+static_assert(prescaler::decode(0xFF) == static_cast<Prescaler>(7));
+static_assert(mode::encode(7) == 3); // the bits above the field are dropped
+static_assert((mode(1) | prescaler(Prescaler::Div8)).mask == 0x1F);
+static_assert((mode(1) | prescaler(Prescaler::Div8)).bits == 0x09);
+// a later field wins where two overlap
+static_assert((mode(3) | mode(1)).bits == 0x01);
+
+template <typename A, typename B> concept Combinable = requires(A a, B b) { a | b; };
+static_assert(Combinable<mode, prescaler>);
+static_assert(!Combinable<mode, top>); // fields of different registers
+
+TEST(fields_leave_the_other_bits_alone) {
+    g_control = 0x60;
+    prescaler::write(Prescaler::Div256);
+    CHECK(g_control == 0x70);
+    CHECK(prescaler::read() == Prescaler::Div256);
+    mode::write(2);
+    CHECK(g_control == 0x72);
+    enable::set();
+    CHECK(g_control == 0xF2 && enable::test());
+    enable::clear();
+    CHECK(g_control == 0x72 && !enable::test());
+    prescaler::write(Prescaler::Stopped);
+    CHECK(g_control == 0x62);
+}
+
+TEST(fields_combine_into_one_write) {
+    g_control = 0xFF;
+    modify(mode(1) | prescaler(Prescaler::Div1) | enable(0));
+    CHECK(g_control == 0x65);
+    assign(mode(2) | enable(1));
+    CHECK(g_control == 0x82);
+
+    g_timer = 0x000F;
+    top::write(0xABC);
+    CHECK(g_timer == 0xABCF);
+    CHECK(top::read() == 0xABC);
+}
+
+int main() { return run_tests(); }
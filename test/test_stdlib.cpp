@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include "std/stdlib.hpp"
+#include <limits.h>
+#include <stdint.h>
+
+constexpr bool formats_at_compile_time() {
+    char buffer[12]{};
+    utoa(4096u, buffer, 10);
+    return buffer[0] == '4' && buffer[3] == '6' && buffer[4] == '\0';
+}
+static_assert(formats_at_compile_time());
+
+TEST(utoa_decimal) {
+    char buffer[24];
+    CHECK_STR(utoa(0u, buffer, 10), "0");
+    CHECK_STR(utoa(7u, buffer, 10), "7");
+    CHECK_STR(utoa(10u, buffer, 10), "10");
+    CHECK_STR(utoa(99u, buffer, 10), "99");
+    CHECK_STR(utoa(100u, buffer, 10), "100");
+    CHECK_STR(utoa(12345u, buffer, 10), "12345");
+    CHECK_STR(utoa(UINT_MAX, buffer, 10), "4294967295");
+    CHECK_STR(utoa(ULLONG_MAX, buffer, 10), "18446744073709551615");
+    CHECK_STR(utoa(uint8_t{255}, buffer, 10), "255");
+}
+
+TEST(utoa_writes_from_the_start_of_the_buffer) {
+    char buffer[24];
+    memset(buffer, 'x', sizeof(buffer));
+    CHECK(utoa(42u, buffer, 10) == buffer);
+    CHECK_STR(buffer, "42");
+}
+
+TEST(utoa_other_bases) {
+    char buffer[72];
+    CHECK_STR(utoa(0u, buffer, 16), "0");
+    CHECK_STR(utoa(0xbeefu, buffer, 16), "beef");
+    CHECK_STR(utoa(0xfu, buffer, 16), "f");
+    CHECK_STR(utoa(UINT_MAX, buffer, 16), "ffffffff");
+    CHECK_STR(utoa(0u, buffer, 8), "0");
+    CHECK_STR(utoa(0755u, buffer, 8), "755");
+    CHECK_STR(utoa(0u, buffer, 2), "0");
+    CHECK_STR(utoa(5u, buffer, 2), "101");
+    CHECK_STR(utoa(ULLONG_MAX, buffer, 2), "1111111111111111111111111111111111111111111111111111111111111111");
+    CHECK_STR(utoa(35u, buffer, 36), "z");
+    CHECK_STR(utoa(80u, buffer, 3), "2222");
+}
+
+TEST(itoa_signed) {
+    char buffer[24];
+    CHECK_STR(itoa(0, buffer, 10), "0");
+    CHECK_STR(itoa(-1, buffer, 10), "-1");
+    CHECK_STR(itoa(123, buffer, 10), "123");
+    CHECK_STR(itoa(INT_MIN, buffer, 10), "-2147483648");
+    CHECK_STR(itoa(INT_MAX, buffer, 10), "2147483647");
+    CHECK_STR(itoa(LLONG_MIN, buffer, 10), "-9223372036854775808");
+    CHECK_STR(itoa(int8_t{-128}, buffer, 10), "-128");
+    CHECK_STR(itoa(-255, buffer, 16), "-ff");
+}
+
+TEST(invalid_bases_give_empty_strings) {
+    char buffer[24];
+    memset(buffer, 'x', sizeof(buffer));
+    CHECK_STR(utoa(5u, buffer, 1), "");
+    CHECK_STR(utoa(5u, buffer, 0), "");
+    CHECK_STR(utoa(5u, buffer, 37), "");
+    CHECK_STR(itoa(-5, buffer, 1), "");
+    CHECK(count_digits(5u, 1) == 0 && count_digits(5u, 0) == 0);
+}
+
+TEST(count_digits_matches_output) {
+    char buffer[24];
+    for (unsigned value = 1; value < 2'000'000; value = value * 3 + 1) {
+        utoa(value, buffer, 10);
+        CHECK(count_digits(value, 10) == strlen(buffer));
+    }
+}
+
+TEST(ftoa_matches_arduino_print) {
+    char buffer[ftoa_size(FTOA_MAX_DIGITS)];
+    CHECK_STR(ftoa(0.0, buffer), "0.00");
+    CHECK_STR(ftoa(3.14159, buffer), "3.14");
+    CHECK_STR(ftoa(2.5, buffer, 0), "3");
+    CHECK_STR(ftoa(-0.005, buffer, 3), "-0.005");
+    CHECK_STR(ftoa(-1.999, buffer, 2), "-2.00");
+    CHECK_STR(ftoa(123.456f, buffer, 1), "123.5");
+    CHECK_STR(ftoa(4294967040.0, buffer, 0), "4294967040");
+    CHECK_STR(ftoa(4294967296.0, buffer), "ovf");
+    CHECK_STR(ftoa(-1e300, buffer), "ovf");
+    CHECK_STR(ftoa(1.0 / 0.0, buffer), "inf");
+    CHECK_STR(ftoa(-1.0 / 0.0, buffer), "inf");
+    CHECK_STR(ftoa(0.0 / 0.0, buffer), "nan");
+    CHECK(strlen(ftoa(-4294967040.0, buffer, 200)) == ftoa_size(FTOA_MAX_DIGITS) - 1);
+}
+
+int main() { return run_tests(); }
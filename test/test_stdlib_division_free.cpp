@@ -0,0 +1,108 @@
+// The multiply-shift paths taken on CPUs without a hardware divider
+#define STDLIB_HARDWARE_DIVIDE 0
+#include "test.hpp"
+#include "std/stdlib.hpp"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+constexpr bool formats_at_compile_time() {
+    char buffer[12]{};
+    utoa(uint32_t{4294967295u}, buffer, 10);
+    return buffer[0] == '4' && buffer[9] == '5' && buffer[10] == '\0';
+}
+static_assert(formats_at_compile_time());
+
+static_assert(detail::divide<100>(uint16_t{65535}) == 655);
+static_assert(detail::divide<100'000'000u>(uint32_t{4294967295u}) == 42);
+
+// plain division, as the reference
+static const char* reference(uint32_t value, unsigned base, char* buffer) {
+    char* str = buffer + 40;
+    *str = '\0';
+    do {
+        *--str = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+        value /= base;
+    } while (value);
+    return str;
+}
+
+TEST(decimal_around_every_digit_count) {
+    char buffer[24], expected[41];
+    uint64_t power = 1;
+    for (int digits = 0; digits <= 10; digits++, power *= 10) {
+        for (int64_t delta = -2; delta <= 2; delta++) {
+            const int64_t value = static_cast<int64_t>(power) + delta;
+            if (value < 0 || value > UINT32_MAX) continue;
+            CHECK_STR(utoa(static_cast<uint32_t>(value), buffer, 10), reference(static_cast<uint32_t>(value), 10, expected));
+        }
+    }
+    CHECK_STR(utoa(uint32_t{UINT32_MAX}, buffer, 10), "4294967295");
+    CHECK_STR(utoa(uint32_t{4'200'000'000u}, buffer, 10), "4200000000");
+    CHECK_STR(utoa(uint32_t{100'000'009u}, buffer, 10), "100000009");
+    CHECK_STR(itoa(INT32_MIN, buffer, 10), "-2147483648");
+}
+
+TEST(decimal_matches_division) {
+    char buffer[24], expected[41];
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < 200'000; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const uint32_t value = state >> (i % 32);
+        CHECK_STR(utoa(value, buffer, 10), reference(value, 10, expected));
+    }
+}
+
+TEST(narrow_types_every_value) {
+    char buffer[24], expected[41];
+    for (uint32_t value = 0; value <= UINT16_MAX; value++) {
+        CHECK_STR(utoa(static_cast<uint16_t>(value), buffer, 10), reference(value, 10, expected));
+        CHECK(count_digits(static_cast<uint16_t>(value), 10) == strlen(buffer));
+    }
+    for (uint32_t value = 0; value <= UINT8_MAX; value++) {
+        CHECK_STR(utoa(static_cast<uint8_t>(value), buffer, 10), reference(value, 10, expected));
+    }
+}
+
+TEST(every_base) {
+    char buffer[40], expected[41];
+    for (unsigned base = 2; base <= 36; base++) {
+        for (uint32_t value = 0; value < 5'000'000; value = value * 3 + base) {
+            CHECK_STR(utoa(value, buffer, static_cast<uint8_t>(base)), reference(value, base, expected));
+            CHECK_STR(utoa(static_cast<uint16_t>(value), buffer, static_cast<uint8_t>(base)), reference(static_cast<uint16_t>(value), base, expected));
+        }
+        CHECK_STR(utoa(uint32_t{UINT32_MAX}, buffer, static_cast<uint8_t>(base)), reference(UINT32_MAX, base, expected));
+        CHECK_STR(utoa(uint16_t{UINT16_MAX}, buffer, static_cast<uint8_t>(base)), reference(UINT16_MAX, base, expected));
+        CHECK_STR(utoa(uint8_t{UINT8_MAX}, buffer, static_cast<uint8_t>(base)), reference(UINT8_MAX, base, expected));
+    }
+}
+
+// the flash-resident tables and the table-free code divide by reciprocals too
+TEST(every_policy_without_division) {
+    char buffer[40], expected[41];
+    for (unsigned base = 2; base <= 36; base++) {
+        const auto b = static_cast<uint8_t>(base);
+        for (uint32_t value = 0; value < 5'000'000; value = value * 3 + base) {
+            CHECK_STR((utoa<uint32_t, OptimizeFor::RAM>(value, buffer, b)), reference(value, base, expected));
+            CHECK_STR((utoa<uint32_t, OptimizeFor::Size>(value, buffer, b)), reference(value, base, expected));
+            CHECK((count_digits<uint32_t, OptimizeFor::Size>(value, b) == strlen(buffer)));
+        }
+        CHECK_STR((utoa<uint32_t, OptimizeFor::RAM>(UINT32_MAX, buffer, b)), reference(UINT32_MAX, base, expected));
+        CHECK_STR((utoa<uint32_t, OptimizeFor::Size>(UINT32_MAX, buffer, b)), reference(UINT32_MAX, base, expected));
+    }
+}
+
+TEST(count_digits_without_division) {
+    CHECK(count_digits(uint32_t{0}, 10) == 1);
+    CHECK(count_digits(uint32_t{9}, 10) == 1);
+    CHECK(count_digits(uint32_t{10}, 10) == 2);
+    CHECK(count_digits(uint32_t{999'999'999}, 10) == 9);
+    CHECK(count_digits(uint32_t{1'000'000'000}, 10) == 10);
+    CHECK(count_digits(uint32_t{UINT32_MAX}, 10) == 10);
+    CHECK(count_digits(uint8_t{255}, 10) == 3);
+    CHECK(count_digits(uint32_t{UINT32_MAX}, 7) == 12);
+}
+
+int main() { return run_tests(); }
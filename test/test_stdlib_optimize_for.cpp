@@ -0,0 +1,68 @@
+// The table-free formatting of OptimizeFor::Size as the build default, and
+// every policy side by side through the explicit template argument
+#define STDLIB_OPTIMIZE_FOR Size
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/stdlib.hpp"
+#include "std/String.hpp"
+#include <limits.h>
+#include <stdint.h>
+
+static_assert(DEFAULT_OPTIMIZE_FOR == OptimizeFor::Size);
+
+template <OptimizeFor POLICY>
+constexpr bool formats_at_compile_time() {
+    char buffer[40]{};
+    utoa<uint32_t, POLICY>(4294967295u, buffer, 10);
+    if (buffer[0] != '4' || buffer[9] != '5' || buffer[10] != '\0') return false;
+    utoa<uint16_t, POLICY>(0xBEEF, buffer, 16);
+    if (buffer[0] != 'b' || buffer[3] != 'f') return false;
+    itoa<int32_t, POLICY>(-35, buffer, 36);
+    return buffer[0] == '-' && buffer[1] == 'z' && buffer[2] == '\0';
+}
+static_assert(formats_at_compile_time<OptimizeFor::Speed>());
+static_assert(formats_at_compile_time<OptimizeFor::RAM>());
+static_assert(formats_at_compile_time<OptimizeFor::Size>());
+
+// plain division, as the reference
+static const char* reference(uint64_t value, unsigned base, char* buffer) {
+    char* str = buffer + 70;
+    *str = '\0';
+    do {
+        *--str = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+        value /= base;
+    } while (value);
+    return str;
+}
+
+template <OptimizeFor POLICY>
+static void check_every_base() {
+    char buffer[72], expected[72];
+    for (unsigned base = 2; base <= 36; base++) {
+        const auto b = static_cast<uint8_t>(base);
+        for (uint64_t value = 0; value < UINT64_MAX / 4; value = value * 5 + base) {
+            CHECK_STR((utoa<uint64_t, POLICY>(value, buffer, b)), reference(value, base, expected));
+            CHECK_STR((utoa<uint32_t, POLICY>(static_cast<uint32_t>(value), buffer, b)), reference(static_cast<uint32_t>(value), base, expected));
+            CHECK_STR((utoa<uint16_t, POLICY>(static_cast<uint16_t>(value), buffer, b)), reference(static_cast<uint16_t>(value), base, expected));
+            CHECK_STR((utoa<uint8_t, POLICY>(static_cast<uint8_t>(value), buffer, b)), reference(static_cast<uint8_t>(value), base, expected));
+        }
+        CHECK_STR((utoa<uint64_t, POLICY>(UINT64_MAX, buffer, b)), reference(UINT64_MAX, base, expected));
+        CHECK_STR((utoa<uint32_t, POLICY>(UINT32_MAX, buffer, b)), reference(UINT32_MAX, base, expected));
+    }
+    CHECK_STR((itoa<int64_t, POLICY>(INT64_MIN, buffer, 10)), "-9223372036854775808");
+    CHECK_STR((ftoa<double, POLICY>(-1234.5678, buffer, 3)), "-1234.568");
+}
+
+TEST(speed_matches_division) { check_every_base<OptimizeFor::Speed>(); }
+TEST(ram_matches_division) { check_every_base<OptimizeFor::RAM>(); }
+TEST(size_matches_division) { check_every_base<OptimizeFor::Size>(); }
+
+TEST(strings_use_the_build_default) {
+    CHECK_STR(String(4294967295u).c_str(), "4294967295");
+    CHECK_STR(String(-120, 16).c_str(), "-78");
+    String line("n=");
+    line += 1234567;
+    CHECK_STR(line.c_str(), "n=1234567");
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,360 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/String.hpp"
+#include "std/StringView.hpp"
+
+TEST(constructs_from_literals_and_numbers) {
+    CHECK_STR(String().c_str(), "");
+    CHECK_STR(String("hello").c_str(), "hello");
+    CHECK(String("hello").length() == 5);
+    CHECK_STR(String('x').c_str(), "x");
+    CHECK_STR(String(-42).c_str(), "-42");
+    CHECK_STR(String(42u).c_str(), "42");
+    CHECK_STR(String(255u, 16).c_str(), "ff");
+    CHECK_STR(String(5, 2).c_str(), "101");
+    CHECK_STR(String(-1234567L).c_str(), "-1234567");
+    CHECK_STR(String(4000000000UL).c_str(), "4000000000");
+    CHECK_STR(String(static_cast<unsigned char>(200)).c_str(), "200");
+    CHECK_STR(String(3.14159f).c_str(), "3.14");
+    CHECK_STR(String(2.5, 3).c_str(), "2.500");
+    CHECK_STR(String(F("flash")).c_str(), "flash");
+}
+
+TEST(copies_and_moves) {
+    String a("some text");
+    String b(a);
+    String c = a;
+    CHECK(b == a);
+    CHECK(c == "some text");
+
+    String d(std::move(b));
+    CHECK_STR(d.c_str(), "some text");
+    CHECK(b.length() == 0);
+
+    String e;
+    e = std::move(d);
+    CHECK_STR(e.c_str(), "some text");
+    e = "other";
+    CHECK_STR(e.c_str(), "other");
+    e = a;
+    CHECK(e == a);
+}
+
+TEST(concatenates) {
+    String s("a");
+    s.concat("bc");
+    s.concat('d');
+    s.concat(12);
+    s.concat(34u);
+    s.concat(-5L);
+    s.concat(6UL);
+    s += String("!");
+    s += F("?");
+    CHECK_STR(s.c_str(), "abcd1234-56!?");
+
+    String long_string;
+    for (int i = 0; i < 20; i++) long_string += "0123456789";
+    CHECK(long_string.length() == 200);
+    CHECK(long_string.endsWith(String("789")));
+}
+
+TEST(plus_returns_a_new_string) {
+    const String base("x=");
+    const String sum = base + 5;
+    CHECK_STR(sum.c_str(), "x=5");
+    CHECK_STR(base.c_str(), "x=");
+    CHECK_STR((base + "y" + 'z' + 1.5).c_str(), "x=yz1.50");
+    CHECK_STR((base + String("w")).c_str(), "x=w");
+}
+
+TEST(compares) {
+    const String a("apple");
+    const String b("banana");
+    CHECK(a < b);
+    CHECK(b > a);
+    CHECK(a <= a);
+    CHECK(a != b);
+    CHECK(a.equals("apple"));
+    CHECK(a.equalsIgnoreCase(String("APPLE")));
+    CHECK(a.startsWith(String("app")));
+    CHECK(!a.startsWith(String("apples")));
+    CHECK(a.endsWith(String("ple")));
+    CHECK(a.compareTo(b) < 0);
+}
+
+TEST(searches) {
+    const String s("the cat sat on the mat");
+    CHECK(s.indexOf('c') == 4);
+    CHECK(s.indexOf('t', 1) == 6);
+    CHECK(s.indexOf('z') == -1);
+    CHECK(s.indexOf("sat") == 8);
+    CHECK(s.indexOf("the", 1) == 15);
+    CHECK(s.indexOf(String("mat")) == 19);
+    CHECK(s.indexOf("dog") == -1);
+    CHECK(s.contains("cat"));
+    CHECK(!s.contains("dog"));
+    CHECK(s.lastIndexOf('t') == 21);
+    CHECK(s.lastIndexOf(String("the")) == 15);
+    CHECK_STR(s.subString(4, 7).c_str(), "cat");
+    CHECK_STR(s.subString(19).c_str(), "mat");
+}
+
+TEST(modifies) {
+    String s("  Hello World  ");
+    s.trim();
+    CHECK_STR(s.c_str(), "Hello World");
+    s.toUpperCase();
+    CHECK_STR(s.c_str(), "HELLO WORLD");
+    s.toLowerCase();
+    s.replace('o', '0');
+    CHECK_STR(s.c_str(), "hell0 w0rld");
+    s.replace(String("l"), String("LL"));
+    CHECK_STR(s.c_str(), "heLLLL0 w0rLLd");
+    s.replace(String("LL"), String("l"));
+    CHECK_STR(s.c_str(), "hell0 w0rld");
+    s.remove(5, 1);
+    CHECK_STR(s.c_str(), "hell0w0rld");
+    s.remove(4);
+    CHECK_STR(s.c_str(), "hell");
+    s.setCharAt(0, 'H');
+    CHECK(s[0] == 'H');
+    s.fill('-', 3);
+    CHECK_STR(s.c_str(), "---");
+    s.erase();
+    CHECK(s.length() == 0);
+}
+
+TEST(converts) {
+    CHECK(String("1234").toInt() == 1234);
+    CHECK(String("-7").toInt() == -7);
+    CHECK(String("2.5").toFloat() == 2.5f);
+    char buffer[4];
+    String("abcdef").toCharArray(buffer, sizeof(buffer));
+    CHECK_STR(buffer, "abc");
+}
+
+TEST(string_view) {
+    const StringView literal("abc");
+    CHECK(literal.length() == 3);
+    CHECK(literal[1] == 'b');
+    CHECK(literal[3] == 0);
+    const String s("hello");
+    const StringView view(s);
+    CHECK(view.length() == 5);
+    CHECK(view.data() == s.c_str());
+}
+
+pool<64, 4> g_string_pool;
+
+TEST(pool_backed_strings) {
+    using PoolString = StringBase<char, resource_allocator<g_string_pool>>;
+    {
+        PoolString a("pooled");
+        PoolString b(a);
+        b += " copy";
+        CHECK_STR(b.c_str(), "pooled copy");
+        CHECK(g_string_pool.used() == 2);
+
+        PoolString too_long("0123456789012345678901234567890123456789");
+        too_long += "0123456789012345678901234567890123456789";
+        CHECK(too_long.length() == 40); // the pool block cannot grow; concat fails
+    }
+    CHECK(g_string_pool.used() == 0);
+}
+
+TEST(shared_strings_copy_on_write) {
+    SharedString a("configuration value");
+    SharedString b(a);
+    SharedString c;
+    c = b;
+    CHECK(b.c_str() == a.c_str() && c.c_str() == a.c_str());
+
+    b += "!";
+    CHECK(b.c_str() != a.c_str());
+    CHECK_STR(b.c_str(), "configuration value!");
+    CHECK_STR(a.c_str(), "configuration value");
+
+    c.setCharAt(0, 'C');
+    c.toUpperCase();
+    CHECK_STR(c.c_str(), "CONFIGURATION VALUE");
+    CHECK_STR(a.c_str(), "configuration value");
+
+    // the last owner writes in place
+    const auto* before = a.c_str();
+    a[0] = 'K';
+    CHECK(a.c_str() == before);
+    CHECK_STR(a.c_str(), "Konfiguration value");
+}
+
+TEST(shared_substrings_are_slices) {
+    SharedString topic("sensors/kitchen/temperature");
+    SharedString room = topic.subString(8, 15);
+    SharedString rest = topic.subString(16);
+    CHECK(room.length() == 7);
+    CHECK(StringView(room).data() == StringView(topic).data() + 8);
+    CHECK(StringView(rest).data() == topic.c_str() + 16);
+
+    // comparisons and searches work on the slice in place
+    CHECK(room == SharedString("kitchen"));
+    CHECK(room.equals("kitchen") && !room.equals("kitchenette") && !room.equals("kit"));
+    CHECK(room.compareTo(SharedString("kitchens")) < 0);
+    CHECK(room.endsWith(SharedString("hen")) && room.startsWith(SharedString("kit")));
+    CHECK(room.indexOf('/') == -1 && room.lastIndexOf('e') == 5);
+    CHECK(room.equalsIgnoreCase(SharedString("KITCHEN")));
+    CHECK(StringView(room).data() == StringView(topic).data() + 8);
+
+    // a suffix already ends in the terminator; an inner slice gets its own copy
+    CHECK_STR(rest.c_str(), "temperature");
+    CHECK(rest.c_str() == topic.c_str() + 16);
+    CHECK_STR(room.c_str(), "kitchen");
+    CHECK(room.c_str() != topic.c_str() + 8);
+
+    SharedString inner = topic.subString(0, 7);
+    inner += "!";
+    CHECK_STR(inner.c_str(), "sensors!");
+    CHECK_STR(topic.c_str(), "sensors/kitchen/temperature");
+}
+
+TEST(shared_slices_outlive_their_source) {
+    SharedString word;
+    {
+        SharedString line("  set threshold 42  ");
+        word = line.subString(6, 15);
+    }
+    CHECK(word.length() == 9);
+    CHECK(word == SharedString("threshold"));
+    word.trim();
+    word.remove(0, 5);
+    CHECK_STR(word.c_str(), "hold");
+
+    SharedString number = SharedString("value=42").subString(6);
+    CHECK(number.toInt() == 42);
+    SharedString copy(number);
+    copy.replace(SharedString("4"), SharedString("x"));
+    CHECK_STR(copy.c_str(), "x2");
+    CHECK_STR(number.c_str(), "42");
+}
+
+// malloc, until a test runs out of memory
+bool g_out_of_memory = false;
+struct failing_allocator {
+    static void* allocate(size_t size) noexcept { return g_out_of_memory ? nullptr : malloc(size); }
+    static void* reallocate(void* ptr, size_t, size_t size) noexcept { return g_out_of_memory ? nullptr : realloc(ptr, size); }
+    static void deallocate(void* ptr) noexcept { free(ptr); }
+};
+
+TEST(shared_buffers_stay_unchanged_without_memory) {
+    using FailingString = StringBase<char, copy_on_write<failing_allocator>>;
+    FailingString a("a,b,c");
+    FailingString b(a);
+    FailingString slice = a.subString(2, 3);
+
+    g_out_of_memory = true;
+    b.replace(',', ';');
+    CHECK(b.begin() == nullptr && b.end() == nullptr);
+    CHECK(slice.c_str() == nullptr);
+    const FailingString& constant = slice;
+    CHECK(constant.c_str() == nullptr);
+    CHECK(constant.begin() == a.c_str() + 2 && constant.length() == 1);
+    g_out_of_memory = false;
+
+    CHECK_STR(a.c_str(), "a,b,c");
+    CHECK(StringView(b) == StringView("a,b,c"));
+    b.replace(',', ';');
+    CHECK_STR(b.c_str(), "a;b;c");
+    CHECK_STR(slice.c_str(), "b");
+    CHECK(slice.toInt() == 0 && FailingString("12").subString(0, 1).toInt() == 1);
+}
+
+TEST(strings_concat_themselves) {
+    // the only reference to its buffer, but not its owner: growing it frees
+    // the characters being appended
+    SharedString slice = SharedString("hello world").subString(6, 11);
+    CHECK(slice.concat(slice));
+    CHECK_STR(slice.c_str(), "worldworld");
+
+    SharedString whole("abc");
+    SharedString copy(whole);
+    CHECK(whole.concat(whole));
+    CHECK_STR(whole.c_str(), "abcabc");
+    CHECK_STR(copy.c_str(), "abc");
+
+    String plain("0123456789");
+    for (int i = 0; i < 4; i++) CHECK(plain.concat(plain));
+    CHECK(plain.length() == 160);
+    CHECK(plain.endsWith(String("0123456789")));
+}
+
+TEST(wide_strings_count_elements) {
+    U16String text(u"Temperatur: 21\u00b0C");
+    CHECK(text.length() == 16);
+    CHECK(text[14] == u'\u00b0');
+    CHECK(text.indexOf(u':') == 10);
+    CHECK(text.indexOf(u"21") == 12);
+    CHECK(text.lastIndexOf(u't') == 7);
+    CHECK(text.startsWith(U16String(u"Temp")));
+    CHECK(text.endsWith(U16String(u"\u00b0C")));
+    CHECK(text == u"Temperatur: 21\u00b0C");
+    CHECK(!(text == u"Temperatur"));
+
+    text += u'!';
+    text += 5;
+    CHECK(text == u"Temperatur: 21\u00b0C!5");
+    text += ' ';
+    text.trim();
+    text.toUpperCase();
+    CHECK(text == u"TEMPERATUR: 21\u00b0C!5");
+    text.replace(U16String(u"TUR"), U16String(u"T"));
+    CHECK(text == u"TEMPERAT: 21\u00b0C!5");
+    text.remove(0, 10);
+    CHECK(text == u"21\u00b0C!5");
+    CHECK(text.toInt() == 21);
+    CHECK(U16String(u"  \u00e4  ").subString(2, 3) == u"\u00e4");
+
+    char16_t buffer[4];
+    text.toCharArray(buffer, 4);
+    CHECK(buffer[0] == u'2' && buffer[2] == u'\u00b0' && buffer[3] == 0);
+}
+
+TEST(wide_strings_convert_numbers) {
+    CHECK(U32String(-42) == U"-42");
+    CHECK(U32String(255u, 16) == U"ff");
+    CHECK(U32String(2.5, 1) == U"2.5");
+    CHECK(U32String(F("flash")) == U"flash");
+    U32String text(U"\U0001F600 ");
+    text.concat(F("ok"));
+    CHECK(text.length() == 4);
+    CHECK(text == U"\U0001F600 ok");
+    CHECK(U32String(U"b") > U32String(U"a"));
+    CHECK(U32String(U"\U0001F600") > U32String(U"\u00ff"));
+    CHECK(U16String(u"\u0100") > U16String(u"\u00ff"));
+}
+
+TEST(char_traits_kernels_match_the_loops) {
+    // every length and needle position, from aligned and misaligned starts
+    char16_t wide16[80];
+    char32_t wide32[80];
+    for (size_t start = 0; start < 4; start++) {
+        for (size_t length = 0; length + start < 79; length++) {
+            for (size_t i = 0; i < 80; i++) {
+                wide16[i] = static_cast<char16_t>(0x100 + i);
+                wide32[i] = static_cast<char32_t>(0x10000 + i);
+            }
+            wide16[start + length] = 0;
+            wide32[start + length] = 0;
+            CHECK(char_traits<char16_t>::length(wide16 + start) == length);
+            CHECK(char_traits<char32_t>::length(wide32 + start) == length);
+            const auto last16 = static_cast<char16_t>(0x100 + start + length - 1);
+            const auto last32 = static_cast<char32_t>(0x10000 + start + length - 1);
+            CHECK(char_traits<char16_t>::find(wide16 + start, length, last16) == (length ? wide16 + start + length - 1 : nullptr));
+            CHECK(char_traits<char32_t>::find(wide32 + start, length, last32) == (length ? wide32 + start + length - 1 : nullptr));
+            CHECK(char_traits<char16_t>::find(wide16 + start, length, u'x') == nullptr);
+        }
+    }
+    const char16_t hay[] = u"abababcabc";
+    CHECK(char_traits<char16_t>::search(hay, 10, u"abc", 3) == hay + 4);
+    CHECK(char_traits<char16_t>::search(hay, 6, u"abc", 3) == nullptr);
+    CHECK(char_traits<char16_t>::compare(u"\u0100", u"\u00ff", 1) > 0);
+}
+
+int main() { return run_tests(); }
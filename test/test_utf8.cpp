@@ -0,0 +1,109 @@
+#include "test.hpp"
+#include <Arduino.h>
+#include "std/utf8.hpp"
+
+static_assert(utf8::valid("gr\xC3\xBC\xC3\x9F dich"));
+static_assert(!utf8::valid(StringView("\xC0\xAF", 2)));
+static_assert(utf8::length("gr\xC3\xBC\xC3\x9F") == 4);
+
+TEST(utf8_validates) {
+    CHECK(utf8::valid(""));
+    CHECK(utf8::valid("plain ASCII that is longer than one sixteen byte block"));
+    CHECK(utf8::valid("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"));      // été € 😀
+    CHECK(utf8::valid("\xEF\xBF\xBF \xF4\x8F\xBF\xBF"));                          // U+FFFF, U+10FFFF
+    CHECK(!utf8::valid("\x80"));                                                   // lone continuation
+    CHECK(!utf8::valid("\xC3"));                                                   // truncated
+    CHECK(!utf8::valid("\xC1\xBF"));                                               // overlong pair
+    CHECK(!utf8::valid("\xE0\x80\xAF"));                                           // overlong triple
+    CHECK(!utf8::valid("\xED\xA0\x80"));                                           // surrogate
+    CHECK(!utf8::valid("\xF4\x90\x80\x80"));                                       // above U+10FFFF
+    CHECK(!utf8::valid("\xF5\x80\x80\x80"));
+    CHECK(!utf8::valid("\xE2\x82"));
+    CHECK(!utf8::valid("\xE2\x28\xA1"));
+}
+
+TEST(utf8_validates_past_the_ascii_fast_path) {
+    // the bad byte at every position of a long ASCII run
+    char text[70];
+    for (size_t bad = 0; bad < 69; bad++) {
+        memset(text, 'a', 69);
+        text[69] = '\0';
+        text[bad] = static_cast<char>(0xFF);
+        CHECK(!utf8::valid(text, 69));
+        text[bad] = static_cast<char>(0xC3);
+        text[bad + 1] = static_cast<char>(0xA9);
+        CHECK(utf8::valid(text, 69) == (bad < 68));
+    }
+}
+
+TEST(utf8_counts_code_points) {
+    CHECK(utf8::length("") == 0);
+    CHECK(utf8::length("abc") == 3);
+    CHECK(utf8::length("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80") == 7);
+    const char* long_text = "K\xC3\xBC" "chenlicht \xE2\x80\x94 Wohnzimmer \xE2\x80\x94 Schlafzimmer";
+    CHECK(utf8::length(long_text, strlen(long_text)) == 39);
+}
+
+TEST(utf8_decodes_and_encodes) {
+    const char* text = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xFF";
+    const char32_t expected[] = {'a', 0xE9, 0x20AC, 0x1F600, utf8::REPLACEMENT};
+    size_t i = 0;
+    for (char32_t c : utf8::codepoints(StringView(text, 11))) {
+        CHECK(i < 5 && c == expected[i]);
+        i++;
+    }
+    CHECK(i == 5);
+
+    char out[4];
+    for (char32_t c : expected) {
+        const auto size = utf8::encode(c, out);
+        size_t index = 0;
+        CHECK(utf8::decode(out, size, index) == c);
+        CHECK(index == size);
+    }
+    CHECK(utf8::encode(0xD800, out) == 3);
+    CHECK(out[0] == '\xEF');
+    CHECK(utf8::is_boundary(text, 11, 1));
+    CHECK(!utf8::is_boundary(text, 11, 2));
+}
+
+TEST(utf8_substring_keeps_code_points_whole) {
+    const String name("Caf\xC3\xA9 \xE2\x98\x95 Ecke");
+    CHECK_STR(utf8::subString(name, 0, 4).c_str(), "Caf\xC3\xA9");
+    CHECK_STR(utf8::subString(name, 5, 6).c_str(), "\xE2\x98\x95");
+    CHECK_STR(utf8::subString(name, 7).c_str(), "Ecke");
+    CHECK_STR(utf8::subString(name, 3, 3).c_str(), "");
+    CHECK_STR(utf8::subString(name, 20, 30).c_str(), "");
+
+    const SharedString shared("\xC3\xBC" "ber");
+    CHECK_STR(utf8::subString(shared, 1).c_str(), "ber");
+}
+
+TEST(utf8_remove_keeps_code_points_whole) {
+    String name("\xE2\x82\xAC" "10 \xE2\x80\x94 ok");
+    utf8::remove(name, 3, 2);
+    CHECK_STR(name.c_str(), "\xE2\x82\xAC" "10 ok");
+    utf8::remove(name, 0, 1);
+    CHECK_STR(name.c_str(), "10 ok");
+    utf8::remove(name, 2);
+    CHECK_STR(name.c_str(), "10");
+    utf8::remove(name, 5);
+    CHECK_STR(name.c_str(), "10");
+}
+
+TEST(utf8_trim_strips_unicode_space) {
+    String name("\xC2\xA0\xE3\x80\x80 Stra\xC3\x9F" "e \xE2\x80\x83\n");
+    utf8::trim(name);
+    CHECK_STR(name.c_str(), "Stra\xC3\x9F" "e");
+
+    // the byte trim never eats into a sequence
+    String bytes(" \xC3\xA0 ");
+    bytes.trim();
+    CHECK_STR(bytes.c_str(), "\xC3\xA0");
+
+    String blank("\xC2\xA0 ");
+    utf8::trim(blank);
+    CHECK(blank.length() == 0);
+}
+
+int main() { return run_tests(); }